@@ -0,0 +1,142 @@
+/**
+ *
+ *  @file adaptive_overload.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ *
+ *  Goodput of an overloaded method, without and with an adaptive limit.
+ *
+ *  A synthetic backend serves 4 concurrent calls at 2ms each; above that, every
+ *  call slows down proportionally (shared resource contention). N client threads
+ *  call it in a closed loop through Dispatcher::handle_one() for a fixed time.
+ *  A call is goodput when it answers within the 10ms deadline, late otherwise;
+ *  rejected calls back off for 1ms before retrying.
+ *
+ *  Usage: webrpc_bench_adaptive_overload [clients] [run ms]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+using namespace std::chrono_literals;
+
+namespace
+{
+  constexpr int backend_capacity = 4;
+  constexpr auto base_service = 2ms;
+  constexpr auto deadline = 10ms;
+
+  struct SimResult
+  {
+    long long goodput{0};
+    long long late{0};
+    long long rejected{0};
+  };
+
+  RpcHandler contended_backend(std::atomic<int> &active)
+  {
+    return [&active](const Context &) -> RpcResult
+    {
+      const int now = active.fetch_add(1) + 1;
+      const int factor = now > backend_capacity ? now : backend_capacity;
+      std::this_thread::sleep_for(base_service * factor / backend_capacity);
+      active.fetch_sub(1);
+      return token(true);
+    };
+  }
+
+  SimResult drive(const Dispatcher &d, int clients, std::chrono::milliseconds run_for)
+  {
+    std::atomic<long long> goodput{0};
+    std::atomic<long long> late{0};
+    std::atomic<long long> rejected{0};
+    std::atomic<bool> stop{false};
+
+    const token call = obj({"id", 1LL, "method", "work"});
+
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<std::size_t>(clients));
+
+    for (int i = 0; i < clients; ++i)
+    {
+      threads.emplace_back([&]
+                           {
+                             while (!stop.load())
+                             {
+                               const auto start = std::chrono::steady_clock::now();
+                               auto r = d.handle_one(call);
+                               const auto took = std::chrono::steady_clock::now() - start;
+
+                               if (r->has_error())
+                               {
+                                 rejected.fetch_add(1);
+                                 std::this_thread::sleep_for(1ms); // client backoff
+                               }
+                               else if (took <= deadline)
+                                 goodput.fetch_add(1);
+                               else
+                                 late.fetch_add(1);
+                             } });
+    }
+
+    std::this_thread::sleep_for(run_for);
+    stop.store(true);
+
+    for (auto &t : threads)
+      t.join();
+
+    return SimResult{goodput.load(), late.load(), rejected.load()};
+  }
+}
+
+int main(int argc, char **argv)
+{
+  const int clients = argc > 1 ? std::atoi(argv[1]) : 32;
+  const std::chrono::milliseconds run_for(argc > 2 ? std::strtol(argv[2], nullptr, 10) : 800);
+
+  std::atomic<int> active{0};
+
+  Router unlimited_router;
+  unlimited_router.add("work", contended_backend(active));
+
+  Router adaptive_router;
+  MethodOptions opts;
+  opts.adaptive.enabled = true;
+  opts.adaptive.initial_limit = 2;
+  opts.adaptive.window_samples = 16;
+  adaptive_router.add("work", contended_backend(active), opts);
+
+  const Dispatcher unlimited(unlimited_router);
+  const Dispatcher adaptive(adaptive_router);
+
+  std::printf("[webrpc bench] adaptive overload: %d clients, %lld ms per run, backend capacity %d\n",
+              clients, static_cast<long long>(run_for.count()), backend_capacity);
+  std::printf("  %-9s %10s %10s %10s %6s\n", "limit", "goodput", "late", "rejected", "final");
+
+  const SimResult u = drive(unlimited, clients, run_for);
+  std::printf("  %-9s %10lld %10lld %10lld %6s\n", "none", u.goodput, u.late, u.rejected, "-");
+
+  const SimResult a = drive(adaptive, clients, run_for);
+  const AdaptiveLimitSnapshot s = adaptive.adaptive_limits().front().second;
+  std::printf("  %-9s %10lld %10lld %10lld %6zu\n", "adaptive", a.goodput, a.late, a.rejected, s.limit);
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ *
+ *  @file priority_delay.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ *
+ *  Queueing delay of interactive calls while bulk traffic saturates the pool.
+ *
+ *  Bulk calls (2ms each) are posted through Dispatcher::post() so that about 300 of
+ *  them stay queued at all times, a backlog older than `aging`. An interactive
+ *  call is posted every 3ms. The run reports the scheduler's per-class queueing
+ *  delay (submit -> start): interactive calls should only wait for a worker to
+ *  free up, bulk calls for the whole backlog.
+ *
+ *  Usage: webrpc_bench_priority_delay [workers] [run ms]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <thread>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/webrpc/Scheduler.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+using namespace std::chrono_literals;
+
+int main(int argc, char **argv)
+{
+  const std::size_t workers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2;
+  const std::chrono::milliseconds run_for(argc > 2 ? std::strtol(argv[2], nullptr, 10) : 400);
+
+  Router r;
+
+  MethodOptions ui;
+  ui.priority = Priority::interactive;
+  r.add("ui.get", [](const Context &) -> RpcResult
+        { return token(true); }, ui);
+
+  MethodOptions bulk;
+  bulk.priority = Priority::bulk;
+  r.add("export.chunk", [](const Context &) -> RpcResult
+        {
+          std::this_thread::sleep_for(2ms);
+          return token(true); }, bulk);
+
+  Dispatcher d(r);
+
+  SchedulerOptions o;
+  o.workers = workers;
+  Scheduler s(o);
+
+  const token bulk_call = obj({"id", 1LL, "method", "export.chunk"});
+  const token ui_call = obj({"id", 2LL, "method", "ui.get"});
+
+  std::atomic<int> pending{0};
+  auto done = [&](std::optional<token>)
+  { pending.fetch_sub(1); };
+
+  const auto until = std::chrono::steady_clock::now() + run_for;
+  while (std::chrono::steady_clock::now() < until)
+  {
+    while (s.stats(Priority::bulk).queued < 300)
+    {
+      pending.fetch_add(1);
+      d.post(s, bulk_call, done);
+    }
+
+    pending.fetch_add(1);
+    d.post(s, ui_call, done);
+    std::this_thread::sleep_for(3ms);
+  }
+
+  // Completions reference `pending`: let the queued bulk work drain first.
+  while (pending.load() > 0)
+    std::this_thread::sleep_for(1ms);
+
+  std::printf("[webrpc bench] priority delay: %zu workers, %lld ms, aging %lld ms\n",
+              workers, static_cast<long long>(run_for.count()),
+              static_cast<long long>(o.aging.count()));
+  std::printf("  %-12s %9s %7s %10s %10s %10s\n", "class", "started", "aged", "p50 us", "p99 us", "max us");
+
+  const struct
+  {
+    const char *name;
+    Priority priority;
+  } classes[] = {{"interactive", Priority::interactive}, {"bulk", Priority::bulk}};
+
+  for (const auto &c : classes)
+  {
+    const ClassStats st = s.stats(c.priority);
+    std::printf("  %-12s %9llu %7llu %10llu %10llu %10llu\n", c.name,
+                static_cast<unsigned long long>(st.started),
+                static_cast<unsigned long long>(st.aged),
+                static_cast<unsigned long long>(st.delay_p50_us),
+                static_cast<unsigned long long>(st.delay_p99_us),
+                static_cast<unsigned long long>(st.delay_max_us));
+  }
+
+  return 0;
+}
@@ -0,0 +1,173 @@
+/**
+ *
+ *  @file request_arena.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ *
+ *  Global allocator calls per request, without and with a per-request arena.
+ *
+ *  Global operator new (plain and aligned, which the default pmr resource uses) is
+ *  replaced by a counting one. Each scenario runs through Dispatcher::handle()
+ *  with DispatcherOptions::request_arena off, then on:
+ *  - a single call whose handler builds a small temporary through ctx.memory()
+ *  - a batch of 16 such calls, half of them on a vectorized method, grouped by method
+ *
+ *  Payloads are built up front; only the handle() calls are counted and timed.
+ *
+ *  Usage: webrpc_bench_request_arena [rounds]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+namespace
+{
+  std::atomic<std::size_t> g_allocs{0};
+}
+
+void *operator new(std::size_t n)
+{
+  g_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(n ? n : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new(std::size_t n, std::align_val_t a)
+{
+  g_allocs.fetch_add(1, std::memory_order_relaxed);
+  const std::size_t align = static_cast<std::size_t>(a);
+  if (void *p = std::aligned_alloc(align, (n + align - 1) / align * align))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+namespace
+{
+  long long sum_with_temporary(const Context &ctx)
+  {
+    const long long n = ctx.params.as_object_ptr()->get_i64_or("n", 0);
+
+    std::pmr::vector<long long> tmp(ctx.memory());
+    for (long long i = 0; i < n; ++i)
+      tmp.push_back(i * 3);
+
+    long long s = 0;
+    for (long long v : tmp)
+      s += v;
+    return s;
+  }
+
+  void setup(Router &r)
+  {
+    r.add("sum", [](const Context &ctx) -> RpcResult
+          { return token(sum_with_temporary(ctx)); });
+
+    r.add_batch("sum.vec", [](std::span<const Context> calls, std::span<RpcResult> results)
+                {
+                  for (std::size_t i = 0; i < calls.size(); ++i)
+                    results[i] = token(sum_with_temporary(calls[i])); });
+  }
+
+  token call(const char *method, long long id)
+  {
+    return obj({"id", id, "method", method, "params", obj({"n", 32})});
+  }
+
+  struct Result
+  {
+    double allocs_per_request;
+    double ns_per_request;
+  };
+
+  Result run(const std::vector<token> &payloads, bool arena, std::size_t rounds)
+  {
+    Router r;
+    setup(r);
+
+    DispatcherOptions o;
+    o.request_arena = arena;
+    o.group_batches_by_method = true;
+    Dispatcher d(r, o);
+
+    // Warm up (first-use allocations of the dispatcher are not per request).
+    for (const token &p : payloads)
+      (void)d.handle(p);
+
+    const std::size_t before = g_allocs.load(std::memory_order_relaxed);
+    const auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t k = 0; k < rounds; ++k)
+    {
+      for (const token &p : payloads)
+        (void)d.handle(p);
+    }
+
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const std::size_t allocs = g_allocs.load(std::memory_order_relaxed) - before;
+    const double n = static_cast<double>(rounds * payloads.size());
+    return {static_cast<double>(allocs) / n, secs * 1e9 / n};
+  }
+
+  void scenario(const char *name, const std::vector<token> &payloads, std::size_t rounds)
+  {
+    const Result heap = run(payloads, false, rounds);
+    const Result arena = run(payloads, true, rounds);
+
+    std::printf("  %-14s %12.1f %12.1f %12.0f %12.0f\n",
+                name, heap.allocs_per_request, arena.allocs_per_request,
+                heap.ns_per_request, arena.ns_per_request);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  const std::size_t rounds = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+
+  std::vector<token> singles;
+  for (long long i = 0; i < 64; ++i)
+    singles.push_back(call("sum", i));
+
+  std::vector<token> batches;
+  for (long long b = 0; b < 4; ++b)
+  {
+    array_t items;
+    for (long long i = 0; i < 16; ++i)
+      items.elems.push_back(call(i % 2 ? "sum.vec" : "sum", b * 16 + i));
+    batches.push_back(token(items));
+  }
+
+  std::printf("[webrpc bench] request arena: %zu rounds\n", rounds);
+  std::printf("  %-14s %12s %12s %12s %12s\n", "payload", "allocs/heap", "allocs/arena",
+              "ns/heap", "ns/arena");
+
+  scenario("single call", singles, rounds);
+  scenario("batch of 16", batches, rounds / 16 + 1);
+
+  return 0;
+}
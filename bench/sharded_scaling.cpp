@@ -0,0 +1,132 @@
+/**
+ *
+ *  @file sharded_scaling.cpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ *
+ *  Throughput of the sharded runtime from 1 shard to every core.
+ *
+ *  For each shard count N, N producer threads (one port each) submit single calls
+ *  spread over 64 connections per producer; every shard is pinned to its own core.
+ *  The handler does a little real work (structural hash of its params) so the run
+ *  measures dispatch, not an empty loop. Completion is observed through the shard
+ *  counters, so nothing shared is written on the hot path.
+ *
+ *  Usage: webrpc_bench_sharded_scaling [calls per producer] [max shards]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <vix/webrpc/Hash.hpp>
+#include <vix/webrpc/ShardedRuntime.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+namespace
+{
+  double run(std::size_t shards, std::size_t calls)
+  {
+    ShardedRuntimeOptions o;
+    o.shards = shards;
+    o.producers = shards;
+    o.queue_capacity = 4096;
+
+    ShardedRuntime rt([](Router &r)
+                      { r.add("work", [](const Context &ctx) -> RpcResult
+                              { return token(static_cast<long long>(params_hash(ctx.params) & 0xffff)); }); },
+                      o);
+
+    // Payloads built up front: the run measures the runtime, not token building.
+    std::vector<std::vector<token>> payloads(shards);
+    for (std::size_t p = 0; p < shards; ++p)
+    {
+      payloads[p].reserve(calls);
+      for (std::size_t i = 0; i < calls; ++i)
+      {
+        payloads[p].push_back(obj({
+            "id",
+            static_cast<long long>(i),
+            "method",
+            "work",
+            "params",
+            obj({"user", static_cast<long long>(i % 977), "scope", "read", "limit", 50}),
+        }));
+      }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < shards; ++p)
+    {
+      producers.emplace_back([&, p]
+                             {
+                               ShardedRuntime::Port &port = rt.port(p);
+                               for (std::size_t i = 0; i < calls; ++i)
+                               {
+                                 const std::uint64_t conn = p * 64 + i % 64;
+                                 while (!port.submit(conn, payloads[p][i], nullptr))
+                                   std::this_thread::yield();
+                               } });
+    }
+    for (auto &t : producers)
+      t.join();
+
+    const std::uint64_t total = static_cast<std::uint64_t>(shards) * calls;
+    while (true)
+    {
+      std::uint64_t done = 0;
+      for (std::size_t s = 0; s < rt.shard_count(); ++s)
+        done += rt.stats(s).processed;
+      if (done == total)
+        break;
+      std::this_thread::yield();
+    }
+
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(total) / secs;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  const std::size_t hw = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  const std::size_t calls = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+  const std::size_t max_shards = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : hw;
+
+  std::vector<std::size_t> counts;
+  for (std::size_t n = 1; n < max_shards; n *= 2)
+    counts.push_back(n);
+  counts.push_back(max_shards);
+
+  std::printf("[webrpc bench] sharded runtime: %zu calls per producer, %zu hardware threads\n",
+              calls, hw);
+  std::printf("  %6s %14s %10s %11s\n", "shards", "calls/s", "speedup", "efficiency");
+
+  double base = 0;
+  for (const std::size_t n : counts)
+  {
+    const double rate = run(n, calls);
+    if (base == 0)
+      base = rate;
+    std::printf("  %6zu %14.0f %9.2fx %10.0f%%\n", n, rate, rate / base, 100.0 * rate / base / n);
+  }
+
+  return 0;
+}
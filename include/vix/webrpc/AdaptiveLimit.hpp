@@ -0,0 +1,392 @@
+/**
+ *
+ *  @file AdaptiveLimit.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_ADAPTIVE_LIMIT_HPP
+#define VIX_WEBRPC_ADAPTIVE_LIMIT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief Configuration of an adaptive concurrency limit.
+   *
+   * @details
+   * The limiter follows the gradient family of algorithms (Vegas / Gradient2):
+   * it compares the average latency of the last window with the minimum latency
+   * observed since the last probe and scales the permitted concurrency accordingly.
+   *
+   * - latency close to the minimum: the limit grows by `sqrt(limit)` per window
+   * - latency rising above `tolerance * min`: the limit shrinks proportionally
+   *
+   * Every `probe_interval` windows the limit is halved for one window. A saturated
+   * method otherwise never runs at low concurrency again and its baseline would drift
+   * upward; the probe window re-measures the no-load latency (and lets the baseline
+   * follow real changes in the handler mix).
+   */
+  struct AdaptiveLimitOptions
+  {
+    /// Enable the adaptive limit for this method.
+    bool enabled{false};
+
+    /// Starting concurrency limit.
+    std::size_t initial_limit{16};
+
+    /// Lower bound of the limit (never reject below this concurrency).
+    std::size_t min_limit{1};
+
+    /// Upper bound of the limit.
+    std::size_t max_limit{1000};
+
+    /// Completed calls per measurement window.
+    std::size_t window_samples{64};
+
+    /// Latency ratio tolerated before the limit shrinks (>= 1).
+    double tolerance{1.5};
+
+    /// Weight of a new estimate in the smoothed limit, in (0, 1].
+    double smoothing{0.2};
+
+    /// Windows between two baseline probes (0 = never probe).
+    std::size_t probe_interval{32};
+  };
+
+  /**
+   * @brief Last decision taken when a window closed.
+   */
+  enum class LimitDecision : std::uint8_t
+  {
+    hold,
+    increase,
+    decrease,
+    probe,
+  };
+
+  /**
+   * @brief Inspection view of an adaptive limiter.
+   */
+  struct AdaptiveLimitSnapshot
+  {
+    std::size_t limit{0};
+    std::size_t in_flight{0};
+    std::uint64_t min_latency_ns{0};
+    std::uint64_t last_latency_ns{0};
+    double gradient{1.0};
+    LimitDecision last_decision{LimitDecision::hold};
+    std::uint64_t windows{0};
+    std::uint64_t admitted{0};
+    std::uint64_t rejected{0};
+  };
+
+  /**
+   * @brief Lock-free adaptive concurrency limiter for one method.
+   *
+   * @details
+   * - `try_acquire()` / `release(latency)` are wait-free atomics on the hot path.
+   * - Samples are accumulated per window; the thread completing the last sample of a
+   *   window recomputes the limit (guarded by an atomic flag, other threads never wait).
+   * - The baseline is the minimum latency since the last probe window; a probe window
+   *   replaces it with what it observed at reduced concurrency.
+   * - The limit only grows when the window actually used at least half of it, so an
+   *   idle method does not inflate its limit.
+   */
+  class AdaptiveLimiter
+  {
+  public:
+    explicit AdaptiveLimiter(const AdaptiveLimitOptions &options) noexcept
+        : options_(sanitize(options)),
+          limit_(static_cast<double>(options_.initial_limit)),
+          current_limit_(options_.initial_limit)
+    {
+    }
+
+    AdaptiveLimiter(const AdaptiveLimiter &) = delete;
+    AdaptiveLimiter &operator=(const AdaptiveLimiter &) = delete;
+
+    /// Configuration used by this limiter.
+    const AdaptiveLimitOptions &options() const noexcept { return options_; }
+
+    /// Currently permitted concurrency.
+    std::size_t limit() const noexcept
+    {
+      return current_limit_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Try to start one call.
+     *
+     * @return True if admitted (caller must call `release()`), false if over the limit.
+     */
+    bool try_acquire() noexcept
+    {
+      const std::size_t prev = in_flight_.fetch_add(1, std::memory_order_acq_rel);
+      if (prev >= current_limit_.load(std::memory_order_relaxed))
+      {
+        in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      admitted_.fetch_add(1, std::memory_order_relaxed);
+      update_max(window_max_in_flight_, prev + 1);
+      return true;
+    }
+
+    /**
+     * @brief Finish one admitted call and record its latency.
+     *
+     * @param latency Handler execution time.
+     */
+    void release(std::chrono::nanoseconds latency) noexcept
+    {
+      in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+
+      const auto ns = static_cast<std::uint64_t>(latency.count() > 0 ? latency.count() : 1);
+      window_sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+      update_min(window_min_ns_, ns);
+
+      const std::uint64_t n = window_count_.fetch_add(1, std::memory_order_acq_rel) + 1;
+      if (n >= options_.window_samples)
+        close_window();
+    }
+
+    /// Snapshot of the limiter state and last decision.
+    AdaptiveLimitSnapshot snapshot() const noexcept
+    {
+      AdaptiveLimitSnapshot s;
+      s.limit = current_limit_.load(std::memory_order_relaxed);
+      s.in_flight = in_flight_.load(std::memory_order_relaxed);
+      s.min_latency_ns = min_latency_ns_.load(std::memory_order_relaxed);
+      s.last_latency_ns = last_latency_ns_.load(std::memory_order_relaxed);
+      s.gradient = gradient_.load(std::memory_order_relaxed);
+      s.last_decision = last_decision_.load(std::memory_order_relaxed);
+      s.windows = windows_.load(std::memory_order_relaxed);
+      s.admitted = admitted_.load(std::memory_order_relaxed);
+      s.rejected = rejected_.load(std::memory_order_relaxed);
+      return s;
+    }
+
+  private:
+    static AdaptiveLimitOptions sanitize(AdaptiveLimitOptions o) noexcept
+    {
+      o.min_limit = std::max<std::size_t>(o.min_limit, 1);
+      o.max_limit = std::max(o.max_limit, o.min_limit);
+      o.initial_limit = std::clamp(o.initial_limit, o.min_limit, o.max_limit);
+      o.window_samples = std::max<std::size_t>(o.window_samples, 1);
+      o.tolerance = std::max(o.tolerance, 1.0);
+      o.smoothing = std::clamp(o.smoothing, 0.01, 1.0);
+      return o;
+    }
+
+    template <typename T>
+    static void update_min(std::atomic<T> &slot, T v) noexcept
+    {
+      T cur = slot.load(std::memory_order_relaxed);
+      while (v < cur && !slot.compare_exchange_weak(cur, v, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    template <typename T>
+    static void update_max(std::atomic<T> &slot, T v) noexcept
+    {
+      T cur = slot.load(std::memory_order_relaxed);
+      while (v > cur && !slot.compare_exchange_weak(cur, v, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    void close_window() noexcept
+    {
+      if (updating_.test_and_set(std::memory_order_acquire))
+        return;
+
+      const std::uint64_t count = window_count_.exchange(0, std::memory_order_acq_rel);
+      if (count == 0)
+      {
+        updating_.clear(std::memory_order_release);
+        return;
+      }
+
+      const std::uint64_t sum = window_sum_ns_.exchange(0, std::memory_order_acq_rel);
+      const std::uint64_t wmin = window_min_ns_.exchange(std::numeric_limits<std::uint64_t>::max(),
+                                                         std::memory_order_acq_rel);
+      // Calls still running at the boundary count towards the next window's peak.
+      const std::size_t used = window_max_in_flight_.exchange(in_flight_.load(std::memory_order_relaxed),
+                                                              std::memory_order_acq_rel);
+      const std::uint64_t avg = sum / count;
+
+      windows_.fetch_add(1, std::memory_order_relaxed);
+      last_latency_ns_.store(avg, std::memory_order_relaxed);
+
+      if (probing_)
+      {
+        // New baseline measured at reduced concurrency; restore the regular limit.
+        probing_ = false;
+        min_rtt_ = wmin;
+        publish(static_cast<std::size_t>(limit_), 1.0, LimitDecision::hold);
+        updating_.clear(std::memory_order_release);
+        return;
+      }
+
+      min_rtt_ = std::min(min_rtt_, wmin);
+
+      const double gradient = std::clamp(
+          options_.tolerance * static_cast<double>(min_rtt_) / static_cast<double>(avg),
+          0.5, 1.0);
+
+      double estimate = limit_ * gradient;
+      if (gradient >= 1.0 && used * 2 >= static_cast<std::size_t>(limit_))
+        estimate += std::sqrt(limit_);
+
+      const double next = std::clamp(limit_ * (1.0 - options_.smoothing) + estimate * options_.smoothing,
+                                     static_cast<double>(options_.min_limit),
+                                     static_cast<double>(options_.max_limit));
+
+      const auto prev_limit = static_cast<std::size_t>(limit_);
+      const auto next_limit = static_cast<std::size_t>(next);
+      limit_ = next;
+
+      if (options_.probe_interval > 0 && ++windows_since_probe_ >= options_.probe_interval)
+      {
+        windows_since_probe_ = 0;
+        probing_ = true;
+        publish(std::max(options_.min_limit, next_limit / 2), gradient, LimitDecision::probe);
+      }
+      else
+      {
+        LimitDecision d = LimitDecision::hold;
+        if (next_limit > prev_limit)
+          d = LimitDecision::increase;
+        else if (next_limit < prev_limit)
+          d = LimitDecision::decrease;
+
+        publish(next_limit, gradient, d);
+      }
+
+      updating_.clear(std::memory_order_release);
+    }
+
+    void publish(std::size_t limit, double gradient, LimitDecision d) noexcept
+    {
+      current_limit_.store(limit, std::memory_order_relaxed);
+      min_latency_ns_.store(min_rtt_, std::memory_order_relaxed);
+      gradient_.store(gradient, std::memory_order_relaxed);
+      last_decision_.store(d, std::memory_order_relaxed);
+    }
+
+    AdaptiveLimitOptions options_{};
+
+    // Written only by the thread holding `updating_`.
+    double limit_{0.0};
+    std::uint64_t min_rtt_{std::numeric_limits<std::uint64_t>::max()};
+    std::size_t windows_since_probe_{0};
+    bool probing_{false};
+    std::atomic_flag updating_ = ATOMIC_FLAG_INIT;
+
+    std::atomic<std::size_t> current_limit_{0};
+    std::atomic<std::size_t> in_flight_{0};
+
+    std::atomic<std::uint64_t> window_count_{0};
+    std::atomic<std::uint64_t> window_sum_ns_{0};
+    std::atomic<std::uint64_t> window_min_ns_{std::numeric_limits<std::uint64_t>::max()};
+    std::atomic<std::size_t> window_max_in_flight_{0};
+
+    std::atomic<std::uint64_t> min_latency_ns_{0};
+    std::atomic<std::uint64_t> last_latency_ns_{0};
+    std::atomic<double> gradient_{1.0};
+    std::atomic<LimitDecision> last_decision_{LimitDecision::hold};
+    std::atomic<std::uint64_t> windows_{0};
+    std::atomic<std::uint64_t> admitted_{0};
+    std::atomic<std::uint64_t> rejected_{0};
+  };
+
+  /**
+   * @brief RAII holder of one adaptive limiter slot.
+   *
+   * @details
+   * Releases the slot when destroyed, recording the time since acquisition as
+   * the call latency, including when the call unwinds with an exception.
+   * Move-only.
+   */
+  class AdaptivePermit
+  {
+  public:
+    AdaptivePermit() = default;
+
+    AdaptivePermit(const AdaptivePermit &) = delete;
+    AdaptivePermit &operator=(const AdaptivePermit &) = delete;
+
+    AdaptivePermit(AdaptivePermit &&other) noexcept
+        : limiter_(other.limiter_), start_(other.start_)
+    {
+      other.limiter_ = nullptr;
+    }
+
+    AdaptivePermit &operator=(AdaptivePermit &&other) noexcept
+    {
+      if (this != &other)
+      {
+        reset();
+        limiter_ = other.limiter_;
+        start_ = other.start_;
+        other.limiter_ = nullptr;
+      }
+      return *this;
+    }
+
+    ~AdaptivePermit() { reset(); }
+
+    /**
+     * @brief Try to take a slot of `limiter` (null: always succeeds, holds nothing).
+     *
+     * @return False if the limiter is at its limit.
+     */
+    bool acquire(AdaptiveLimiter *limiter) noexcept
+    {
+      reset();
+      if (!limiter)
+        return true;
+      if (!limiter->try_acquire())
+        return false;
+
+      limiter_ = limiter;
+      start_ = std::chrono::steady_clock::now();
+      return true;
+    }
+
+    /// Release the slot now, recording the elapsed time.
+    void reset() noexcept
+    {
+      if (!limiter_)
+        return;
+      limiter_->release(std::chrono::steady_clock::now() - start_);
+      limiter_ = nullptr;
+    }
+
+  private:
+    AdaptiveLimiter *limiter_{nullptr};
+    std::chrono::steady_clock::time_point start_{};
+  };
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_ADAPTIVE_LIMIT_HPP
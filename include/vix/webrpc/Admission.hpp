@@ -0,0 +1,333 @@
+/**
+ *
+ *  @file Admission.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_ADMISSION_HPP
+#define VIX_WEBRPC_ADMISSION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief Static admission limits for one method (or for a whole dispatcher).
+   *
+   * @details
+   * Every field uses `0` as "unlimited":
+   * - `max_in_flight`: maximum number of concurrent handler executions
+   * - `rate_per_sec`:  sustained call rate (token bucket refill rate)
+   * - `burst`:         bucket capacity (defaults to one second of `rate_per_sec`)
+   *
+   * @code
+   * router.add("report.export", handler, MethodOptions{
+   *     .limits = MethodLimits{.max_in_flight = 4, .rate_per_sec = 50},
+   * });
+   * @endcode
+   */
+  struct MethodLimits
+  {
+    /// Maximum concurrent executions (0 = unlimited).
+    std::size_t max_in_flight{0};
+
+    /// Sustained calls per second (0 = unlimited).
+    double rate_per_sec{0.0};
+
+    /// Bucket capacity in calls (0 = one second worth of `rate_per_sec`).
+    double burst{0.0};
+
+    /// True if at least one limit is configured.
+    bool enabled() const noexcept
+    {
+      return max_in_flight > 0 || rate_per_sec > 0.0;
+    }
+  };
+
+  /**
+   * @brief Reason an admission attempt was refused.
+   */
+  enum class AdmissionDecision : std::uint8_t
+  {
+    admitted,
+    rejected_in_flight,
+    rejected_rate,
+  };
+
+  /**
+   * @brief Point-in-time counters of one admission gate.
+   */
+  struct AdmissionStats
+  {
+    std::uint64_t admitted{0};
+    std::uint64_t rejected_in_flight{0};
+    std::uint64_t rejected_rate{0};
+    std::size_t in_flight{0};
+  };
+
+  /**
+   * @brief Lock-free admission gate (in-flight counter + token bucket).
+   *
+   * @details
+   * The in-flight limit is a single atomic counter. The rate limit is a token bucket
+   * implemented as GCRA (generic cell rate algorithm): the whole bucket state is one
+   * atomic "theoretical arrival time", updated with a CAS loop. No mutex is involved,
+   * so the limiter cannot become a serialization point under overload.
+   *
+   * @note
+   * `AdmissionGate` is not copyable (it owns atomics). Routers keep gates behind
+   * shared ownership so that registrations stay cheap to move around.
+   */
+  class AdmissionGate
+  {
+  public:
+    AdmissionGate() = default;
+
+    explicit AdmissionGate(const MethodLimits &limits) noexcept
+    {
+      configure(limits);
+    }
+
+    AdmissionGate(const AdmissionGate &) = delete;
+    AdmissionGate &operator=(const AdmissionGate &) = delete;
+
+    /**
+     * @brief Replace the limits of this gate.
+     *
+     * @note
+     * Not synchronized with concurrent `try_acquire()` calls; configure before serving.
+     */
+    void configure(const MethodLimits &limits) noexcept
+    {
+      limits_ = limits;
+
+      if (limits.rate_per_sec > 0.0)
+      {
+        const double burst = limits.burst > 0.0 ? limits.burst : limits.rate_per_sec;
+        interval_ns_ = static_cast<std::int64_t>(1e9 / limits.rate_per_sec);
+        if (interval_ns_ <= 0)
+          interval_ns_ = 1;
+        tolerance_ns_ = static_cast<std::int64_t>(static_cast<double>(interval_ns_) * (burst > 1.0 ? burst - 1.0 : 0.0));
+      }
+      else
+      {
+        interval_ns_ = 0;
+        tolerance_ns_ = 0;
+      }
+
+      tat_ns_.store(0, std::memory_order_relaxed);
+    }
+
+    /// Configured limits.
+    const MethodLimits &limits() const noexcept { return limits_; }
+
+    /// True if this gate enforces anything.
+    bool enabled() const noexcept { return limits_.enabled(); }
+
+    /**
+     * @brief Try to admit one call.
+     *
+     * @return `admitted` on success (caller must later call `release()`),
+     *         otherwise the reason of the rejection (nothing to release).
+     */
+    AdmissionDecision try_acquire() noexcept
+    {
+      if (limits_.max_in_flight > 0)
+      {
+        const std::size_t prev = in_flight_.fetch_add(1, std::memory_order_acq_rel);
+        if (prev >= limits_.max_in_flight)
+        {
+          in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+          rejected_in_flight_.fetch_add(1, std::memory_order_relaxed);
+          return AdmissionDecision::rejected_in_flight;
+        }
+      }
+      else
+      {
+        in_flight_.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      if (interval_ns_ > 0 && !take_token())
+      {
+        in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+        rejected_rate_.fetch_add(1, std::memory_order_relaxed);
+        return AdmissionDecision::rejected_rate;
+      }
+
+      admitted_.fetch_add(1, std::memory_order_relaxed);
+      return AdmissionDecision::admitted;
+    }
+
+    /// Release one slot obtained by a successful `try_acquire()`.
+    void release() noexcept
+    {
+      in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    /// Current number of admitted, unreleased calls.
+    std::size_t in_flight() const noexcept
+    {
+      return in_flight_.load(std::memory_order_relaxed);
+    }
+
+    /// Snapshot of the gate counters.
+    AdmissionStats stats() const noexcept
+    {
+      AdmissionStats s;
+      s.admitted = admitted_.load(std::memory_order_relaxed);
+      s.rejected_in_flight = rejected_in_flight_.load(std::memory_order_relaxed);
+      s.rejected_rate = rejected_rate_.load(std::memory_order_relaxed);
+      s.in_flight = in_flight_.load(std::memory_order_relaxed);
+      return s;
+    }
+
+  private:
+    static std::int64_t now_ns() noexcept
+    {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now().time_since_epoch())
+          .count();
+    }
+
+    bool take_token() noexcept
+    {
+      const std::int64_t now = now_ns();
+      std::int64_t tat = tat_ns_.load(std::memory_order_relaxed);
+
+      for (;;)
+      {
+        const std::int64_t base = tat > now ? tat : now;
+        if (base - now > tolerance_ns_)
+          return false;
+
+        if (tat_ns_.compare_exchange_weak(tat, base + interval_ns_,
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_relaxed))
+          return true;
+      }
+    }
+
+    MethodLimits limits_{};
+    std::int64_t interval_ns_{0};
+    std::int64_t tolerance_ns_{0};
+
+    std::atomic<std::int64_t> tat_ns_{0};
+    std::atomic<std::size_t> in_flight_{0};
+    std::atomic<std::uint64_t> admitted_{0};
+    std::atomic<std::uint64_t> rejected_in_flight_{0};
+    std::atomic<std::uint64_t> rejected_rate_{0};
+  };
+
+  /**
+   * @brief RAII holder of admission slots (global gate and/or method gate).
+   *
+   * @details
+   * Releases every acquired slot when destroyed. Move-only.
+   */
+  class AdmissionPermit
+  {
+  public:
+    AdmissionPermit() = default;
+
+    AdmissionPermit(AdmissionGate *global, AdmissionGate *method) noexcept
+        : global_(global), method_(method)
+    {
+    }
+
+    AdmissionPermit(const AdmissionPermit &) = delete;
+    AdmissionPermit &operator=(const AdmissionPermit &) = delete;
+
+    AdmissionPermit(AdmissionPermit &&other) noexcept
+        : global_(other.global_), method_(other.method_)
+    {
+      other.global_ = nullptr;
+      other.method_ = nullptr;
+    }
+
+    AdmissionPermit &operator=(AdmissionPermit &&other) noexcept
+    {
+      if (this != &other)
+      {
+        reset();
+        global_ = other.global_;
+        method_ = other.method_;
+        other.global_ = nullptr;
+        other.method_ = nullptr;
+      }
+      return *this;
+    }
+
+    ~AdmissionPermit() { reset(); }
+
+    /// Release held slots now.
+    void reset() noexcept
+    {
+      if (method_)
+        method_->release();
+      if (global_)
+        global_->release();
+      method_ = nullptr;
+      global_ = nullptr;
+    }
+
+  private:
+    AdmissionGate *global_{nullptr};
+    AdmissionGate *method_{nullptr};
+  };
+
+  /**
+   * @brief Try to pass both the global gate and the method gate.
+   *
+   * @param global Dispatcher-wide gate (may be null or disabled).
+   * @param method Per-method gate (may be null or disabled).
+   * @param permit Receives the acquired slots on success.
+   * @return `admitted` or the first rejection reason.
+   *
+   * @details
+   * The method gate is tried first so that a saturated method does not consume
+   * global capacity. On rejection, any slot already taken is given back.
+   */
+  inline AdmissionDecision admit(AdmissionGate *global,
+                                 AdmissionGate *method,
+                                 AdmissionPermit &permit) noexcept
+  {
+    AdmissionGate *m = (method && method->enabled()) ? method : nullptr;
+    AdmissionGate *g = (global && global->enabled()) ? global : nullptr;
+
+    if (m)
+    {
+      const AdmissionDecision d = m->try_acquire();
+      if (d != AdmissionDecision::admitted)
+        return d;
+    }
+
+    if (g)
+    {
+      const AdmissionDecision d = g->try_acquire();
+      if (d != AdmissionDecision::admitted)
+      {
+        if (m)
+          m->release();
+        return d;
+      }
+    }
+
+    permit = AdmissionPermit{g, m};
+    return AdmissionDecision::admitted;
+  }
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_ADMISSION_HPP
@@ -0,0 +1,218 @@
+/**
+ *
+ *  @file Arena.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_ARENA_HPP
+#define VIX_WEBRPC_ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief Monotonic memory resource owned by one request (or one batch).
+   *
+   * @details
+   * Allocations are served from an inline buffer first, then from `upstream` in
+   * geometrically growing blocks. Deallocation is a no-op: everything is given
+   * back at once, in O(1) for the inline buffer, when the arena is destroyed or
+   * `release()`d.
+   *
+   * The arena lives on the stack of the thread handling the request and is not
+   * thread-safe. Nothing allocated from it may outlive the request.
+   *
+   * @code
+   * RpcResult handler(const Context &ctx)
+   * {
+   *   std::pmr::vector<long long> ids(ctx.memory()); // freed with the request
+   *   ...
+   * }
+   * @endcode
+   */
+  class RequestArena final : public std::pmr::memory_resource
+  {
+  public:
+    /// Bytes served from the inline buffer before `upstream` is asked for a block.
+    static constexpr std::size_t inline_bytes = 2048;
+
+    explicit RequestArena(std::pmr::memory_resource *upstream = nullptr) noexcept
+        : mono_(buffer_, sizeof(buffer_),
+                upstream ? upstream : std::pmr::get_default_resource())
+    {
+    }
+
+    RequestArena(const RequestArena &) = delete;
+    RequestArena &operator=(const RequestArena &) = delete;
+
+    /// Bytes handed out since construction (or the last `release()`).
+    std::size_t allocated() const noexcept { return allocated_; }
+
+    /// Give every allocation back (blocks from `upstream` are returned to it).
+    void release() noexcept
+    {
+      mono_.release();
+      allocated_ = 0;
+    }
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      void *p = mono_.allocate(bytes, alignment);
+      allocated_ += bytes;
+      return p;
+    }
+
+    void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+      return this == &other;
+    }
+
+    alignas(std::max_align_t) std::byte buffer_[inline_bytes];
+    std::pmr::monotonic_buffer_resource mono_;
+    std::size_t allocated_{0};
+  };
+
+  /**
+   * @brief Bump arena that keeps its blocks between requests.
+   *
+   * @details
+   * Like `RequestArena`, deallocation is a no-op, but `rewind()` only resets the
+   * bump pointer: the blocks stay allocated for the next request. If the last
+   * request needed more than one block, `rewind()` replaces them with a single
+   * block of their total size, so a connection with a stable traffic shape stops
+   * asking `upstream` for memory after the first few requests.
+   *
+   * Owned by one connection (or one thread) and not thread-safe.
+   */
+  class ScratchArena final : public std::pmr::memory_resource
+  {
+  public:
+    /// Size of the first block.
+    static constexpr std::size_t initial_bytes = 4096;
+
+    explicit ScratchArena(std::pmr::memory_resource *upstream = nullptr) noexcept
+        : upstream_(upstream ? upstream : std::pmr::get_default_resource())
+    {
+    }
+
+    ScratchArena(const ScratchArena &) = delete;
+    ScratchArena &operator=(const ScratchArena &) = delete;
+
+    ~ScratchArena() { release(); }
+
+    /// Bytes handed out since the last `rewind()`.
+    std::size_t allocated() const noexcept { return allocated_; }
+
+    /// Bytes held from `upstream` (kept across `rewind()`).
+    std::size_t capacity() const noexcept
+    {
+      std::size_t n = 0;
+      for (const Block &b : blocks_)
+        n += b.size;
+      return n;
+    }
+
+    /// Start over, keeping the memory (merged into one block if it was split).
+    void rewind()
+    {
+      if (blocks_.size() > 1)
+      {
+        const std::size_t total = capacity();
+        release();
+        grow(total);
+      }
+
+      current_ = 0;
+      used_ = 0;
+      allocated_ = 0;
+    }
+
+    /// Give every block back to `upstream`.
+    void release() noexcept
+    {
+      for (const Block &b : blocks_)
+        upstream_->deallocate(b.data, b.size, alignof(std::max_align_t));
+      blocks_.clear();
+      current_ = 0;
+      used_ = 0;
+      allocated_ = 0;
+    }
+
+  private:
+    struct Block
+    {
+      std::byte *data;
+      std::size_t size;
+    };
+
+    void grow(std::size_t at_least)
+    {
+      const std::size_t last = blocks_.empty() ? initial_bytes / 2 : blocks_.back().size;
+      const std::size_t size = std::max(at_least, last * 2);
+      blocks_.push_back(Block{static_cast<std::byte *>(upstream_->allocate(size, alignof(std::max_align_t))), size});
+    }
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      for (;;)
+      {
+        if (current_ < blocks_.size())
+        {
+          Block &b = blocks_[current_];
+          void *p = b.data + used_;
+          std::size_t room = b.size - used_;
+          if (std::align(alignment, bytes, p, room))
+          {
+            used_ = b.size - room + bytes;
+            allocated_ += bytes;
+            return p;
+          }
+
+          if (current_ + 1 < blocks_.size())
+          {
+            ++current_;
+            used_ = 0;
+            continue;
+          }
+        }
+
+        grow(bytes + alignment);
+        current_ = blocks_.size() - 1;
+        used_ = 0;
+      }
+    }
+
+    void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+      return this == &other;
+    }
+
+    std::pmr::memory_resource *upstream_;
+    std::vector<Block> blocks_{};
+    std::size_t current_{0};
+    std::size_t used_{0};
+    std::size_t allocated_{0};
+  };
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_ARENA_HPP
@@ -0,0 +1,315 @@
+/**
+ *
+ *  @file BufferPool.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_BUFFER_POOL_HPP
+#define VIX_WEBRPC_BUFFER_POOL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief Retention policy of a `BufferPool`.
+   */
+  struct BufferPoolOptions
+  {
+    /// Buffers whose capacity exceeds this are freed when given back.
+    std::size_t max_buffer_bytes{64 * 1024};
+
+    /// Capacity kept over all idle buffers of the pool.
+    std::size_t max_retained_bytes{256 * 1024};
+
+    /**
+     * @brief Buffers given back between two high-water-mark trims (0 = never trim).
+     *
+     * @details
+     * At the end of each window, idle buffers more than twice as large as the
+     * largest output written during the window are freed.
+     */
+    std::size_t trim_interval{1024};
+  };
+
+  /**
+   * @brief Counters of a buffer pool.
+   */
+  struct BufferPoolStats
+  {
+    std::uint64_t acquires{0};
+
+    /// Acquires served by an idle buffer.
+    std::uint64_t hits{0};
+
+    /// Buffers freed when given back (over `max_buffer_bytes` or `max_retained_bytes`).
+    std::uint64_t dropped{0};
+
+    /// Idle buffers freed by high-water-mark trims.
+    std::uint64_t trimmed{0};
+
+    /// Idle buffers and their total capacity.
+    std::size_t retained_buffers{0};
+    std::size_t retained_bytes{0};
+
+    /// Share of acquires served by an idle buffer (0 before the first acquire).
+    double hit_rate() const noexcept
+    {
+      return acquires == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(acquires);
+    }
+  };
+
+  class BufferPool;
+
+  /**
+   * @brief Output buffer borrowed from a `BufferPool`, given back when destroyed.
+   *
+   * @details
+   * Move-only. Must be destroyed on the thread that acquired it (pools are not
+   * thread-safe); to hand the bytes to another thread, `release()` the string.
+   */
+  class PooledBuffer
+  {
+  public:
+    PooledBuffer() = default;
+
+    PooledBuffer(PooledBuffer &&other) noexcept
+        : pool_(std::exchange(other.pool_, nullptr)), buf_(std::move(other.buf_))
+    {
+    }
+
+    PooledBuffer &operator=(PooledBuffer &&other) noexcept
+    {
+      if (this != &other)
+      {
+        give_back();
+        pool_ = std::exchange(other.pool_, nullptr);
+        buf_ = std::move(other.buf_);
+      }
+      return *this;
+    }
+
+    PooledBuffer(const PooledBuffer &) = delete;
+    PooledBuffer &operator=(const PooledBuffer &) = delete;
+
+    ~PooledBuffer() { give_back(); }
+
+    /// The buffer (append to it, never shrink it).
+    std::string &str() noexcept { return buf_; }
+    const std::string &str() const noexcept { return buf_; }
+
+    std::string_view view() const noexcept { return buf_; }
+    operator std::string_view() const noexcept { return buf_; }
+
+    const char *data() const noexcept { return buf_.data(); }
+    std::size_t size() const noexcept { return buf_.size(); }
+    bool empty() const noexcept { return buf_.empty(); }
+
+    /// Take the string out; it is not given back to the pool.
+    std::string release() noexcept
+    {
+      pool_ = nullptr;
+      return std::move(buf_);
+    }
+
+  private:
+    friend class BufferPool;
+
+    PooledBuffer(BufferPool *pool, std::string buf) noexcept
+        : pool_(pool), buf_(std::move(buf))
+    {
+    }
+
+    inline void give_back() noexcept;
+
+    BufferPool *pool_{nullptr};
+    std::string buf_{};
+  };
+
+  /**
+   * @brief Pool of output buffers for the serialization paths (`Dispatcher::serialize()`).
+   *
+   * @details
+   * Idle buffers keep their capacity, so steady traffic writes its responses
+   * without allocating. What is kept is bounded: a buffer larger than
+   * `max_buffer_bytes` is freed instead of kept, idle capacity never exceeds
+   * `max_retained_bytes`, and every `trim_interval` give-backs the idle buffers
+   * sized for a past burst (more than twice the largest recent output) are freed.
+   * Memory therefore comes back down after a burst while common sizes stay warm.
+   *
+   * The most recently given back buffer is reused first. A pool is not
+   * thread-safe: use one per thread (`this_thread()`) or per connection.
+   *
+   * @code
+   * if (auto out = dispatcher.serialize(payload))   // this thread's pool
+   *   send(out->view());                            // buffer goes back here
+   * @endcode
+   */
+  class BufferPool
+  {
+  public:
+    explicit BufferPool(BufferPoolOptions options = {}) : options_(options) {}
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    /// Pool of the calling thread.
+    static BufferPool &this_thread()
+    {
+      thread_local BufferPool pool;
+      return pool;
+    }
+
+    /// Borrow an empty buffer.
+    PooledBuffer acquire()
+    {
+      ++stats_.acquires;
+      if (idle_.empty())
+        return PooledBuffer(this, std::string{});
+
+      ++stats_.hits;
+      std::string buf = std::move(idle_.back());
+      idle_.pop_back();
+      stats_.retained_bytes -= buf.capacity();
+      return PooledBuffer(this, std::move(buf));
+    }
+
+    /// Change the policy; idle buffers it no longer allows are freed.
+    void set_options(BufferPoolOptions options) noexcept
+    {
+      options_ = options;
+      shrink([&](const std::string &buf)
+             { return buf.capacity() > options_.max_buffer_bytes; });
+      while (stats_.retained_bytes > options_.max_retained_bytes)
+        drop_oldest();
+    }
+
+    const BufferPoolOptions &options() const noexcept { return options_; }
+
+    BufferPoolStats stats() const noexcept
+    {
+      BufferPoolStats s = stats_;
+      s.retained_buffers = idle_.size();
+      return s;
+    }
+
+    /// Free the idle buffers sized for a past burst now (see `trim_interval`).
+    void trim() noexcept
+    {
+      const std::size_t keep = std::max(2 * window_high_water_, small_capacity);
+      shrink([&](const std::string &buf)
+             { return buf.capacity() > keep; });
+      window_high_water_ = 0;
+      window_returns_ = 0;
+    }
+
+    /// Free every idle buffer.
+    void clear() noexcept
+    {
+      stats_.trimmed += idle_.size();
+      idle_.clear();
+      stats_.retained_bytes = 0;
+    }
+
+  private:
+    friend class PooledBuffer;
+
+    /// Capacity of an empty `std::string`: such buffers hold no heap memory.
+    static inline const std::size_t small_capacity = std::string().capacity();
+
+    void give_back(std::string &&buf) noexcept
+    {
+      window_high_water_ = std::max(window_high_water_, buf.size());
+      const std::size_t cap = buf.capacity();
+
+      if (cap > small_capacity)
+      {
+        if (cap > options_.max_buffer_bytes ||
+            stats_.retained_bytes + cap > options_.max_retained_bytes ||
+            !keep(std::move(buf)))
+        {
+          ++stats_.dropped;
+        }
+      }
+
+      if (options_.trim_interval != 0 && ++window_returns_ >= options_.trim_interval)
+        trim();
+    }
+
+    bool keep(std::string &&buf) noexcept
+    {
+      const std::size_t cap = buf.capacity();
+      buf.clear();
+      try
+      {
+        idle_.push_back(std::move(buf));
+      }
+      catch (...)
+      {
+        return false;
+      }
+      stats_.retained_bytes += cap;
+      return true;
+    }
+
+    /// Free the idle buffers matching `too_large`, keeping the others in order.
+    template <typename Pred>
+    void shrink(Pred &&too_large) noexcept
+    {
+      std::size_t kept = 0;
+      for (std::size_t i = 0; i < idle_.size(); ++i)
+      {
+        if (too_large(idle_[i]))
+        {
+          stats_.retained_bytes -= idle_[i].capacity();
+          ++stats_.trimmed;
+          std::string().swap(idle_[i]);
+        }
+        else
+        {
+          if (kept != i)
+            idle_[kept].swap(idle_[i]);
+          ++kept;
+        }
+      }
+      idle_.resize(kept);
+    }
+
+    void drop_oldest() noexcept
+    {
+      stats_.retained_bytes -= idle_.front().capacity();
+      ++stats_.trimmed;
+      idle_.erase(idle_.begin());
+    }
+
+    BufferPoolOptions options_;
+    std::vector<std::string> idle_{};
+    BufferPoolStats stats_{};
+    std::size_t window_high_water_{0};
+    std::size_t window_returns_{0};
+  };
+
+  inline void PooledBuffer::give_back() noexcept
+  {
+    if (pool_)
+      std::exchange(pool_, nullptr)->give_back(std::move(buf_));
+  }
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_BUFFER_POOL_HPP
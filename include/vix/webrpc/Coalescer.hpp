@@ -0,0 +1,225 @@
+/**
+ *
+ *  @file Coalescer.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_COALESCER_HPP
+#define VIX_WEBRPC_COALESCER_HPP
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include <vix/json/Simple.hpp>
+
+#include <vix/webrpc/Error.hpp>
+#include <vix/webrpc/Hash.hpp>
+#include <vix/webrpc/Router.hpp>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief Counters of a coalescer.
+   */
+  struct CoalescerStats
+  {
+    /// Calls that ran the handler (flight leaders).
+    std::uint64_t executed{0};
+
+    /// Calls that waited for an identical in-flight call and shared its result.
+    std::uint64_t coalesced{0};
+
+    /// Calls currently leading a flight.
+    std::size_t in_flight{0};
+  };
+
+  /**
+   * @brief Singleflight: collapse identical concurrent calls into one execution.
+   *
+   * @details
+   * A flight is identified by method name and params. The key is a structural hash
+   * of the params token (object key order ignored); a full structural comparison
+   * rules out collisions before two calls are merged.
+   *
+   * - the first call of a key runs (leader) and publishes its result
+   * - identical calls arriving while it runs block until it completes and receive a
+   *   copy of the same `RpcResult` (tokens share storage, nothing is deep-copied)
+   * - the flight ends with the leader: later calls start a new execution
+   *
+   * Flights are spread over independently locked shards, so unrelated keys do not
+   * contend on one mutex. Only meant for idempotent methods: followers never run
+   * their own handler, and their id / metadata are not visible to the leader.
+   */
+  class Coalescer
+  {
+  public:
+    Coalescer() = default;
+
+    Coalescer(const Coalescer &) = delete;
+    Coalescer &operator=(const Coalescer &) = delete;
+
+    /**
+     * @brief Run `execute` once per identical in-flight call.
+     *
+     * @param method  Method name (part of the key).
+     * @param params  Call params (hashed and compared structurally).
+     * @param execute Callable returning an `RpcResult`; only invoked by the leader.
+     * @return The leader's result (for the leader and every follower).
+     */
+    template <typename Fn>
+    RpcResult run(std::string_view method, const vix::json::token &params, Fn &&execute)
+    {
+      return run(call_hash(method, params), method, params, std::forward<Fn>(execute));
+    }
+
+    /**
+     * @brief Same as above with a precomputed key (`call_hash(method, params)`).
+     */
+    template <typename Fn>
+    RpcResult run(std::uint64_t key, std::string_view method, const vix::json::token &params, Fn &&execute)
+    {
+      Shard &shard = shards_[key % shard_count];
+
+      std::shared_ptr<Flight> flight;
+      bool leader = false;
+      {
+        std::lock_guard<std::mutex> lock(shard.mu);
+
+        const auto [first, last] = shard.flights.equal_range(key);
+        for (auto it = first; it != last; ++it)
+        {
+          if (it->second->method == method && equal(it->second->params, params))
+          {
+            flight = it->second;
+            break;
+          }
+        }
+
+        if (!flight)
+        {
+          flight = std::make_shared<Flight>();
+          flight->method = std::string(method);
+          flight->params = params;
+          shard.flights.emplace(key, flight);
+          leader = true;
+        }
+      }
+
+      if (leader)
+      {
+        in_flight_.fetch_add(1, std::memory_order_relaxed);
+        executed_.fetch_add(1, std::memory_order_relaxed);
+
+        Landing landing{shard, key, flight.get(), this};
+        landing.result = execute();
+        return *landing.result;
+      }
+
+      coalesced_.fetch_add(1, std::memory_order_relaxed);
+
+      std::unique_lock<std::mutex> wait(flight->mu);
+      flight->cv.wait(wait, [&]
+                      { return flight->result.has_value(); });
+      return *flight->result;
+    }
+
+    /// Counters since construction.
+    CoalescerStats stats() const noexcept
+    {
+      CoalescerStats s;
+      s.executed = executed_.load(std::memory_order_relaxed);
+      s.coalesced = coalesced_.load(std::memory_order_relaxed);
+      s.in_flight = in_flight_.load(std::memory_order_relaxed);
+      return s;
+    }
+
+  private:
+    static constexpr std::size_t shard_count = 16;
+
+    struct Flight
+    {
+      std::string method;
+      vix::json::token params{nullptr};
+
+      std::mutex mu;
+      std::condition_variable cv;
+      std::optional<RpcResult> result;
+    };
+
+    struct Shard
+    {
+      std::mutex mu;
+      std::unordered_multimap<std::uint64_t, std::shared_ptr<Flight>> flights;
+    };
+
+    /**
+     * @brief Ends a flight: unregisters it and wakes followers.
+     *
+     * @details
+     * Runs on every exit of the leader, so followers are released even if the
+     * handler unwinds (they then receive an internal error).
+     */
+    struct Landing
+    {
+      Shard &shard;
+      std::uint64_t key;
+      Flight *flight;
+      Coalescer *owner;
+      std::optional<RpcResult> result{};
+
+      ~Landing()
+      {
+        {
+          std::lock_guard<std::mutex> lock(shard.mu);
+          const auto [first, last] = shard.flights.equal_range(key);
+          for (auto it = first; it != last; ++it)
+          {
+            if (it->second.get() == flight)
+            {
+              shard.flights.erase(it);
+              break;
+            }
+          }
+        }
+
+        {
+          std::lock_guard<std::mutex> lock(flight->mu);
+          if (result.has_value())
+            flight->result = *result;
+          else
+            flight->result = RpcError::internal_error("coalesced call failed");
+        }
+        flight->cv.notify_all();
+        owner->in_flight_.fetch_sub(1, std::memory_order_relaxed);
+      }
+    };
+
+    std::array<Shard, shard_count> shards_{};
+
+    std::atomic<std::uint64_t> executed_{0};
+    std::atomic<std::uint64_t> coalesced_{0};
+    std::atomic<std::size_t> in_flight_{0};
+  };
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_COALESCER_HPP
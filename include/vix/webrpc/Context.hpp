@@ -15,12 +15,17 @@
 #ifndef VIX_WEBRPC_CONTEXT_HPP
 #define VIX_WEBRPC_CONTEXT_HPP
 
+#include <concepts>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
 
 #include <vix/json/Simple.hpp>
 
+#include <vix/webrpc/Meta.hpp>
+
 namespace vix::webrpc
 {
   /**
@@ -32,7 +37,8 @@ namespace vix::webrpc
    * - the request parameters (`params`)
    * - the optional request id (`id`)
    * - optional transport name (`transport`)
-   * - optional metadata map (`meta`)
+   * - optional metadata (`meta_view`, or the owning map `meta`)
+   * - optional per-request memory resource (`arena`)
    *
    * @par Design goals (Vix style)
    * - **Explicit**: no hidden globals, no implicit transport behavior.
@@ -44,7 +50,7 @@ namespace vix::webrpc
    * `Context` does **not** own the request payload. It stores references/views:
    * - `method` is a `std::string_view` and must remain valid for the call.
    * - `params` and `id` are `const vix::json::token&` and must outlive `Context`.
-   * - `meta` is an optional pointer; if provided, it must outlive `Context`.
+   * - `meta` and `meta_view` are optional pointers; if provided, they must outlive `Context`.
    *
    * In WebRPC, this is typically guaranteed because the dispatcher/router builds `Context`
    * from a parsed in-memory request token and invokes the handler immediately.
@@ -55,7 +61,7 @@ namespace vix::webrpc
    */
   struct Context
   {
-    /// Metadata container (e.g. headers, peer id, request tags).
+    /// Owning metadata map, for callers that already hold one.
     using MetaMap = std::unordered_map<std::string, std::string>;
 
     /**
@@ -102,10 +108,45 @@ namespace vix::webrpc
      * When present, it is expected to be owned by the caller/transport layer and to outlive
      * this `Context` (which is ephemeral).
      *
+     * Set only when the `Context` is built from a map. The dispatcher and router
+     * hand handlers a `meta_view` (a map given to them is viewed, not copied), so
+     * read metadata through `meta_value()` / `has_meta()`, which consult both.
+     *
      * @note If `meta` is null, metadata accessors return empty/false.
      */
     const MetaMap *meta{nullptr};
 
+    /**
+     * @brief Optional non-owning metadata view (see `MetaView`).
+     *
+     * @details
+     * Views into storage owned by the transport, which must outlive this `Context`.
+     * Consulted before `meta` by the metadata accessors.
+     */
+    const MetaView *meta_view{nullptr};
+
+    /**
+     * @brief Optional memory resource of the request (null = default resource).
+     *
+     * @details
+     * Set by the dispatcher when `DispatcherOptions::request_arena` is on: a
+     * `RequestArena` released when the response is built. Use `memory()` for
+     * handler temporaries; nothing allocated from it may outlive the call.
+     * When the method has a memory budget, this is a `MemoryBudget` over the
+     * arena (or the default resource) that throws once the budget is spent.
+     */
+    std::pmr::memory_resource *arena{nullptr};
+
+    /**
+     * @brief Params the handler may take (null = params are shared, see `take_params()`).
+     *
+     * @details
+     * Set by the dispatcher when it owns the request outright (a consumed payload,
+     * see `Dispatcher::handle(token &&)`) and nothing reads the params after the
+     * handler. Points at the token `params` refers to.
+     */
+    vix::json::token *owned_params{nullptr};
+
     /**
      * @brief Construct a Context.
      *
@@ -128,6 +169,69 @@ namespace vix::webrpc
     {
     }
 
+    /**
+     * @brief Construct a Context over a metadata view.
+     *
+     * @param method_    RPC method view (must remain valid during the call).
+     * @param params_    Reference to params token (must outlive Context).
+     * @param id_        Reference to id token (must outlive Context).
+     * @param transport_ Transport name.
+     * @param meta_      Metadata view pointer (may be null).
+     * @param arena_     Optional per-request memory resource.
+     * @param owned_     Optional params the handler may take (must be `&params_`).
+     *
+     * @note
+     * A template so that a literal `nullptr` keeps selecting the map constructor.
+     */
+    template <typename View>
+      requires std::same_as<View, MetaView>
+    Context(std::string_view method_,
+            const vix::json::token &params_,
+            const vix::json::token &id_,
+            std::string_view transport_,
+            const View *meta_,
+            std::pmr::memory_resource *arena_ = nullptr,
+            vix::json::token *owned_ = nullptr) noexcept
+        : method(method_),
+          params(params_),
+          id(id_),
+          transport(transport_),
+          meta_view(meta_),
+          arena(arena_),
+          owned_params(owned_)
+    {
+    }
+
+    /**
+     * @brief Take ownership of the params (e.g. to store them).
+     *
+     * @return The params, moved out when the dispatcher owns them (`params` is null
+     *         afterwards), otherwise a copy (which shares object and array storage).
+     *
+     * @code
+     * r.add("doc.put", [&](const Context &ctx) -> RpcResult
+     *       {
+     *         store.insert(ctx.take_params()); // no copy of a consumed payload
+     *         return token(true); });
+     * @endcode
+     */
+    vix::json::token take_params() const
+    {
+      if (owned_params)
+        return std::exchange(*owned_params, vix::json::token{nullptr});
+      return params;
+    }
+
+    /**
+     * @brief Memory resource for handler temporaries (never null).
+     *
+     * @return The request arena if any, otherwise `std::pmr::get_default_resource()`.
+     */
+    std::pmr::memory_resource *memory() const noexcept
+    {
+      return arena ? arena : std::pmr::get_default_resource();
+    }
+
     /**
      * @brief True if this call has an id (request/response semantics).
      *
@@ -184,19 +288,24 @@ namespace vix::webrpc
      *
      * @details
      * This function is intentionally explicit and safe:
-     * - returns `{}` when `meta` is null
+     * - returns `{}` when both `meta_view` and `meta` are null
      * - returns `{}` when key is not present
      *
-     * @warning
-     * The returned `std::string_view` points into the stored `std::string` inside the map.
-     * The metadata map must outlive the `Context` (and any view derived from it).
+     * The view is searched first (a linear scan), then the map (which builds a
+     * temporary key string).
      *
-     * @note
-     * Current implementation uses `std::string(key)` because `std::unordered_map<std::string, ...>`
-     * does not provide heterogeneous lookup by default. This is explicit and correct.
+     * @warning
+     * The returned `std::string_view` points into the transport's storage (or the
+     * map), which must outlive the `Context` (and any view derived from it).
      */
     std::string_view meta_value(std::string_view key) const noexcept
     {
+      if (meta_view)
+      {
+        if (const MetaView::Entry *e = meta_view->find(key))
+          return e->second;
+      }
+
       if (!meta)
         return {};
 
@@ -207,17 +316,38 @@ namespace vix::webrpc
       return it->second;
     }
 
+    /**
+     * @brief Retrieve a well-known metadata value (O(1) from a view).
+     */
+    std::string_view meta_value(MetaKey key) const noexcept
+    {
+      if (meta_view)
+      {
+        if (const MetaView::Entry *e = meta_view->find(key))
+          return e->second;
+      }
+      return meta ? meta_value(meta_key_name(key)) : std::string_view{};
+    }
+
     /**
      * @brief True if metadata exists and contains the given key.
      *
      * @param key Metadata key.
-     * @return `true` if the map exists and contains `key`.
+     * @return `true` if the view or the map contains `key`.
      */
     bool has_meta(std::string_view key) const noexcept
     {
-      if (!meta)
-        return false;
-      return meta->find(std::string(key)) != meta->end();
+      if (meta_view && meta_view->contains(key))
+        return true;
+      return meta && meta->find(std::string(key)) != meta->end();
+    }
+
+    /// True if metadata exists and contains the given well-known key.
+    bool has_meta(MetaKey key) const noexcept
+    {
+      if (meta_view && meta_view->contains(key))
+        return true;
+      return meta && has_meta(meta_key_name(key));
     }
   };
 
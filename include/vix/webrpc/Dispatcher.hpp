@@ -16,20 +16,238 @@
 #ifndef VIX_WEBRPC_DISPATCHER_HPP
 #define VIX_WEBRPC_DISPATCHER_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <optional>
+#include <span>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include <vix/json/Simple.hpp>
 
+#include <vix/webrpc/Admission.hpp>
+#include <vix/webrpc/Arena.hpp>
+#include <vix/webrpc/BufferPool.hpp>
+#include <vix/webrpc/Coalescer.hpp>
 #include <vix/webrpc/Error.hpp>
+#include <vix/webrpc/Limits.hpp>
+#include <vix/webrpc/MemoryBudget.hpp>
+#include <vix/webrpc/Priority.hpp>
+#include <vix/webrpc/Reference.hpp>
 #include <vix/webrpc/Request.hpp>
 #include <vix/webrpc/Response.hpp>
+#include <vix/webrpc/ResultCache.hpp>
 #include <vix/webrpc/Router.hpp>
+#include <vix/webrpc/Scheduler.hpp>
+#include <vix/webrpc/detail/StringHash.hpp>
 
 namespace vix::webrpc
 {
+  /**
+   * @brief Dispatcher-wide configuration.
+   *
+   * @details
+   * Per-method policy lives in `MethodOptions` (declared on the router);
+   * this struct only holds what applies to every call going through one dispatcher.
+   */
+  struct DispatcherOptions
+  {
+    /// Global admission limits, shared by every method (0 = unlimited).
+    MethodLimits global_limits{};
+
+    /**
+     * @brief Metadata key carrying a per-request priority (empty = disabled).
+     *
+     * @details
+     * When set and present in the request metadata, its value (see `parse_priority()`)
+     * overrides the priority declared on the method registration.
+     */
+    std::string priority_meta_key{};
+
+    /**
+     * @brief Metadata key identifying the client for fair queuing (empty = disabled).
+     *
+     * @details
+     * Example: `"tenant"`. Read once per payload by `Dispatcher::post()`; every call
+     * of the payload (all items of a batch) is queued under that client.
+     */
+    std::string client_meta_key{};
+
+    /// Merge identical in-flight calls of idempotent methods (see `Coalescer`).
+    bool coalesce{true};
+
+    /// Result cache for methods registered with `MethodOptions::cache_ttl`.
+    ResultCacheOptions cache{};
+
+    /**
+     * @brief Run identical idempotent items of one batch only once.
+     *
+     * @details
+     * Items with the same method and structurally equal params (see `call_hash()`)
+     * share the result of the first one; every item still gets its own response id.
+     * Only methods registered with `MethodOptions::idempotent` are merged.
+     */
+    bool dedupe_batches{false};
+
+    /**
+     * @brief Run the items of a batch grouped by method.
+     *
+     * @details
+     * Items are partitioned by resolved method (groups ordered by first appearance,
+     * items in order within a group) and each group runs back to back, which keeps
+     * one handler's code and data hot instead of alternating between handlers.
+     * Responses keep the original item order. Side effects of different methods
+     * may therefore run in a different order than the items.
+     */
+    bool group_batches_by_method{false};
+
+    /**
+     * @brief Let batch items use the results of other items as params.
+     *
+     * @details
+     * A params value `{"$ref": "<id>", "path": "<json pointer>"}` is replaced by the
+     * designated part of the result of the item with that id (see `ResultRef`).
+     * The batch runs as a dependency graph; unknown ids, cycles, failed inputs and
+     * missing paths answer the dependent item with `INVALID_PARAMS`.
+     */
+    bool batch_references{false};
+
+    /// Input limits (batch size, params depth and size, batch CPU budget).
+    DispatcherLimits limits{};
+
+    /**
+     * @brief Give every request a `RequestArena`, released when its response is built.
+     *
+     * @details
+     * One arena per call, shared by the items of a synchronous batch (`handle()`,
+     * `stream()`); on the scheduler path each item gets its own. Batch bookkeeping
+     * of the synchronous paths (slots and their reference lists, the id index and
+     * ordering of `batch_references`, execution order, group buffers) and handler
+     * temporaries allocated through `Context::memory()` draw from it instead of
+     * the global heap.
+     */
+    bool request_arena{false};
+
+    /// Where arenas take blocks once their inline buffer is full (null = default resource).
+    std::pmr::memory_resource *arena_upstream{nullptr};
+
+    /**
+     * @brief Measure the memory of every call, even without a budget.
+     *
+     * @details
+     * Feeds `Dispatcher::memory_usage()` for methods that have no budget yet, to
+     * size one. Calls with a budget (`DispatcherLimits::max_request_memory`,
+     * `MethodOptions::memory_budget`) are always measured.
+     */
+    bool track_memory{false};
+  };
+
+  /**
+   * @brief Counters of the dispatch path.
+   */
+  struct DispatcherStats
+  {
+    /// Batch items answered from an identical earlier item of the same batch.
+    std::uint64_t batch_deduplicated{0};
+
+    /// Batches rejected for having more than `DispatcherLimits::max_batch_items`.
+    std::uint64_t batch_too_large{0};
+
+    /// Calls rejected for params deeper than `DispatcherLimits::max_params_depth`.
+    std::uint64_t params_too_deep{0};
+
+    /// Calls rejected for params larger than `DispatcherLimits::max_params_bytes`.
+    std::uint64_t params_too_large{0};
+
+    /// Batch items not run because their batch spent `DispatcherLimits::batch_cpu_budget`.
+    std::uint64_t budget_exceeded{0};
+
+    /// Calls stopped for crossing their memory budget.
+    std::uint64_t resource_exhausted{0};
+  };
+
+  /**
+   * @brief Completion callback of the asynchronous dispatch path.
+   *
+   * @details
+   * Receives exactly what `Dispatcher::handle()` would have returned.
+   */
+  using DispatchCompletion = std::function<void(std::optional<vix::json::token>)>;
+
+  /**
+   * @brief Receiver of streamed responses (`Dispatcher::stream()`, `post_stream()`).
+   *
+   * @details
+   * Each response is delivered as soon as its call completed, in completion order,
+   * carrying the id of its item; notifications deliver nothing. Calls into the sink
+   * never overlap, even when items complete on several scheduler threads.
+   */
+  struct BatchSink
+  {
+    /// One response (any order).
+    std::function<void(RpcResponse)> on_response{};
+
+    /// End of the payload, after the last response; receives the number delivered.
+    std::function<void(std::size_t)> on_end{};
+  };
+
+  /**
+   * @brief Reusable state of `Dispatcher::write()` for one connection (or thread).
+   *
+   * @details
+   * Holds the memory of everything a call needs between parsing and writing: the
+   * parsed envelopes, the method strings, the batch slots and tables, and the
+   * output text. Both keep their capacity from one call to the next, so steady
+   * traffic on a connection stops allocating once the buffers have grown to fit it.
+   *
+   * One scratch serves one call at a time. Keep one per connection, or use
+   * `this_thread()` when the transport has no per-connection state.
+   *
+   * @code
+   * DispatchScratch scratch;           // per connection
+   * if (dispatcher.write(payload, scratch))
+   *   send(scratch.output());
+   * @endcode
+   */
+  struct DispatchScratch
+  {
+    /// Memory of the envelopes, strings and batch tables (rewound per call).
+    ScratchArena memory;
+
+    /// Output text of the last call.
+    std::string out{};
+
+    explicit DispatchScratch(std::pmr::memory_resource *upstream = nullptr) noexcept
+        : memory(upstream)
+    {
+    }
+
+    DispatchScratch(const DispatchScratch &) = delete;
+    DispatchScratch &operator=(const DispatchScratch &) = delete;
+
+    /// JSON text written by the last call.
+    std::string_view output() const noexcept { return out; }
+
+    /// Scratch of the calling thread.
+    static DispatchScratch &this_thread()
+    {
+      thread_local DispatchScratch scratch;
+      return scratch;
+    }
+  };
+
   /**
    * @brief Transport-agnostic request dispatcher.
    *
@@ -44,6 +262,53 @@ namespace vix::webrpc
    * - batch payloads (array)
    * - notifications (no id -> no response)
    *
+   * @par Admission control
+   * Before a handler runs, the call must pass the method gate (`MethodOptions::limits`)
+   * and the global gate (`DispatcherOptions::global_limits`). Rejected calls never reach
+   * the handler and are answered with `RpcError::overloaded()`.
+   * Methods registered with `MethodOptions::adaptive` additionally go through their
+   * adaptive limiter, which measures handler latency and tunes its own concurrency.
+   *
+   * @par Coalescing
+   * Calls to methods registered with `MethodOptions::idempotent` are merged while an
+   * identical call (same method, structurally equal params) is running: followers wait
+   * for it and share its result, each answered with its own id. Followers skip
+   * admission, since they never occupy the handler.
+   *
+   * @par Vectorized handlers
+   * In a batch, the items of a method registered with `Router::add_batch()` are
+   * grouped into one call of its batch handler (one admission, one latency sample);
+   * results are scattered back to the original positions and ids.
+   *
+   * @par Micro-batching
+   * Single calls of a vectorized method with `MethodOptions::micro_batch` enabled are
+   * gathered with concurrent calls of the same method into one batch handler
+   * invocation (see `MicroBatcher`); each caller gets its own result.
+   *
+   * @par Limits
+   * `DispatcherOptions::limits` bounds what one payload may cost. Oversized batches
+   * are refused before any item is parsed, over-limit params while their envelope is
+   * parsed, and a batch that spent its CPU budget stops starting new items. Each limit
+   * has its own error code and counter (`DispatcherStats`).
+   *
+   * @par Pipelining
+   * With `DispatcherOptions::batch_references`, an item may take params from the
+   * results of other items of its batch, which collapses a chain of dependent calls
+   * into one round trip. `handle()` runs the graph level by level; `post()` queues
+   * every item as soon as its inputs are known, so independent items run in parallel.
+   *
+   * @par Streaming
+   * `stream()` and `post_stream()` hand each response of a batch to a `BatchSink`
+   * as soon as its call completed, then close the stream with an end marker, so a
+   * slow item no longer holds back the fast ones.
+   *
+   * @par Result cache
+   * When `DispatcherOptions::cache` has a memory cap, successful results of methods
+   * registered with `MethodOptions::cache_ttl` are cached as JSON text and as a
+   * private copy of the tree. A hit skips admission and the handler; `write()` of a
+   * single call appends the stored text, other paths return the stored tree (shared,
+   * read-only). Only the flight leader (see coalescing) fills the cache.
+   *
    * @note
    * `Dispatcher` does not own the router. It holds a reference and assumes the router
    * outlives the dispatcher.
@@ -58,12 +323,100 @@ namespace vix::webrpc
      */
     explicit Dispatcher(const Router &router) noexcept : router_(router) {}
 
+    /**
+     * @brief Construct a dispatcher with explicit options.
+     *
+     * @param router  Router used to resolve and execute RPC methods.
+     * @param options Dispatcher-wide configuration.
+     */
+    Dispatcher(const Router &router, DispatcherOptions options)
+        : router_(router), options_(std::move(options)), global_(options_.global_limits)
+    {
+      if (options_.cache.max_bytes > 0)
+        cache_ = std::make_unique<ResultCache>(options_.cache);
+    }
+
+    Dispatcher(const Dispatcher &) = delete;
+    Dispatcher &operator=(const Dispatcher &) = delete;
+
+    /// Dispatcher-wide configuration.
+    const DispatcherOptions &options() const noexcept { return options_; }
+
+    /// Counters of the global admission gate.
+    AdmissionStats global_admission() const noexcept { return global_.stats(); }
+
+    /// Counters of the singleflight coalescer.
+    CoalescerStats coalescing() const noexcept { return coalescer_.stats(); }
+
+    /// Result cache, or nullptr if disabled.
+    ResultCache *cache() const noexcept { return cache_.get(); }
+
+    /// Counters of the dispatch path.
+    DispatcherStats stats() const noexcept
+    {
+      DispatcherStats s;
+      s.batch_deduplicated = batch_deduplicated_.load(std::memory_order_relaxed);
+      s.batch_too_large = batch_too_large_.load(std::memory_order_relaxed);
+      s.params_too_deep = params_too_deep_.load(std::memory_order_relaxed);
+      s.params_too_large = params_too_large_.load(std::memory_order_relaxed);
+      s.budget_exceeded = budget_exceeded_.load(std::memory_order_relaxed);
+      s.resource_exhausted = resource_exhausted_.load(std::memory_order_relaxed);
+      return s;
+    }
+
+    /**
+     * @brief Current adaptive limits and their last decisions, per method.
+     *
+     * @return One entry per method registered with an adaptive limit.
+     */
+    std::vector<std::pair<std::string, AdaptiveLimitSnapshot>> adaptive_limits() const
+    {
+      std::vector<std::pair<std::string, AdaptiveLimitSnapshot>> out;
+      router_.for_each([&](std::string_view name, const RouterMethod &m)
+                       {
+                         if (m.adaptive)
+                           out.emplace_back(std::string(name), m.adaptive->snapshot()); });
+      return out;
+    }
+
+    /**
+     * @brief Micro-batching counters, per method.
+     *
+     * @return One entry per method registered with `MethodOptions::micro_batch`.
+     */
+    std::vector<std::pair<std::string, MicroBatchStats>> micro_batches() const
+    {
+      std::vector<std::pair<std::string, MicroBatchStats>> out;
+      router_.for_each([&](std::string_view name, const RouterMethod &m)
+                       {
+                         if (m.micro)
+                           out.emplace_back(std::string(name), m.micro->stats()); });
+      return out;
+    }
+
+    /**
+     * @brief Memory used per call, per method (high-water marks).
+     *
+     * @return One entry per method with at least one measured call (see
+     *         `DispatcherOptions::track_memory`).
+     */
+    std::vector<std::pair<std::string, MemoryUsageStats>> memory_usage() const
+    {
+      std::vector<std::pair<std::string, MemoryUsageStats>> out;
+      router_.for_each([&](std::string_view name, const RouterMethod &m)
+                       {
+                         const MemoryUsageStats s = m.memory->stats();
+                         if (s.calls != 0)
+                           out.emplace_back(std::string(name), s); });
+      return out;
+    }
+
     /**
      * @brief Handle one payload (single call or batch).
      *
      * @param payload   Request token (object or array).
      * @param transport Optional transport label (e.g. "http", "websocket", "p2p").
-     * @param meta      Optional metadata map (e.g. headers, peer id).
+     * @param meta      Optional metadata view (e.g. headers, peer id).
      *
      * @return
      * - `std::nullopt` if the payload is a notification (or a batch of only notifications)
@@ -73,7 +426,7 @@ namespace vix::webrpc
     std::optional<vix::json::token> handle(
         const vix::json::token &payload,
         std::string_view transport = {},
-        const Context::MetaMap *meta = nullptr) const
+        const MetaView *meta = nullptr) const
     {
       if (payload.is_array())
         return handle_batch(payload, transport, meta);
@@ -85,12 +438,130 @@ namespace vix::webrpc
       return r->to_json();
     }
 
+    /**
+     * @brief Handle a payload the caller gives up (single call or batch).
+     *
+     * @details
+     * Same as `handle(const token &)`, but a single call is parsed with
+     * `RpcRequest::parse(token &&)`: `id` and `params` are moved out of the payload
+     * rather than shared, and the handler may take the params without a copy
+     * (`Context::take_params()`). Batch items keep sharing the payload.
+     */
+    std::optional<vix::json::token> handle(
+        vix::json::token &&payload,
+        std::string_view transport = {},
+        const MetaView *meta = nullptr) const
+    {
+      if (payload.is_array())
+        return handle_batch(payload, transport, meta);
+
+      const auto r = handle_one(std::move(payload), transport, meta);
+      if (!r.has_value())
+        return std::nullopt;
+
+      return r->to_json();
+    }
+
+    /**
+     * @brief `handle()` with metadata held in a `Context::MetaMap`.
+     *
+     * @details
+     * The map is viewed for the call (a `MetaView` over its entries), not copied.
+     */
+    template <typename Map>
+      requires std::same_as<Map, Context::MetaMap>
+    std::optional<vix::json::token> handle(
+        const vix::json::token &payload,
+        std::string_view transport,
+        const Map *meta) const
+    {
+      if (!meta)
+        return handle(payload, transport);
+
+      const MetaView view = MetaView::of(*meta);
+      return handle(payload, transport, &view);
+    }
+
+    /**
+     * @brief Handle one payload and append the JSON text of its response to `out`.
+     *
+     * @param payload   Request token (object or array).
+     * @param out       Output buffer (appended to, never cleared).
+     * @param transport Optional transport label.
+     * @param meta      Optional metadata view.
+     *
+     * @return `false` if nothing was written (notification, or a batch of only
+     *         notifications), `true` otherwise.
+     *
+     * @details
+     * Same execution and same JSON as `handle()`, without the intermediate token
+     * tree. Error responses are written from the error itself: a malformed payload
+     * or an unknown method is answered without allocating when `out` has room.
+     */
+    bool write(const vix::json::token &payload,
+               std::string &out,
+               std::string_view transport = {},
+               const MetaView *meta = nullptr) const
+    {
+      return with_arena([&](std::pmr::memory_resource *arena)
+                        { return write_in(payload, out, arena, transport, meta); });
+    }
+
+    /**
+     * @brief `write()` into a reusable scratch (output in `scratch.output()`).
+     *
+     * @details
+     * The scratch replaces the request arena and the output buffer: its memory is
+     * rewound and its output cleared before the call, keeping their capacity. Once
+     * they have grown to fit the traffic, a call allocates nothing inside webrpc
+     * (handlers and the `vix::json` values they return aside).
+     */
+    bool write(const vix::json::token &payload,
+               DispatchScratch &scratch,
+               std::string_view transport = {},
+               const MetaView *meta = nullptr) const
+    {
+      scratch.memory.rewind();
+      scratch.out.clear();
+      return write_in(payload, scratch.out, &scratch.memory, transport, meta);
+    }
+
+    /**
+     * @brief `write()` into a buffer borrowed from the calling thread's pool.
+     *
+     * @return The response text, or `std::nullopt` when nothing was written
+     *         (notification, or a batch of only notifications).
+     *
+     * @details
+     * The buffer goes back to `BufferPool::this_thread()` when the result is
+     * destroyed, which must happen on this thread. See `BufferPool` for what the
+     * pool keeps between calls.
+     */
+    std::optional<PooledBuffer> serialize(const vix::json::token &payload,
+                                          std::string_view transport = {},
+                                          const MetaView *meta = nullptr) const
+    {
+      return serialize(payload, BufferPool::this_thread(), transport, meta);
+    }
+
+    /// `serialize()` with a buffer borrowed from `pool`.
+    std::optional<PooledBuffer> serialize(const vix::json::token &payload,
+                                          BufferPool &pool,
+                                          std::string_view transport = {},
+                                          const MetaView *meta = nullptr) const
+    {
+      PooledBuffer out = pool.acquire();
+      if (!write(payload, out.str(), transport, meta))
+        return std::nullopt;
+      return out;
+    }
+
     /**
      * @brief Handle a single call payload (request object).
      *
      * @param payload   Request token (must be an object).
      * @param transport Optional transport label.
-     * @param meta      Optional metadata map.
+     * @param meta      Optional metadata view.
      *
      * @return
      * - `std::nullopt` if the call is a notification (id is null)
@@ -103,90 +574,1723 @@ namespace vix::webrpc
     std::optional<RpcResponse> handle_one(
         const vix::json::token &payload,
         std::string_view transport = {},
-        const Context::MetaMap *meta = nullptr) const
+        const MetaView *meta = nullptr) const
     {
-      auto parsed = RpcRequest::parse(payload);
-      if (std::holds_alternative<RpcError>(parsed))
-      {
-        return RpcResponse::fail(vix::json::token{nullptr},
-                                 std::get<RpcError>(std::move(parsed)));
-      }
+      return with_arena([&](std::pmr::memory_resource *arena) -> std::optional<RpcResponse>
+                        {
+                          auto parsed = parse_request(payload, arena);
+                          if (const ErrorView *err = std::get_if<ErrorView>(&parsed))
+                            return RpcResponse::fail(vix::json::token{nullptr}, RpcError(*err));
+
+                          const Request &req = std::get<Request>(parsed);
+                          return respond(req.id, dispatch(req, transport, meta, arena)); });
+    }
+
+    /**
+     * @brief Handle a single call payload the caller gives up.
+     *
+     * @details
+     * See `handle(token &&)`: the request owns its params, and the handler may take
+     * them unless the method is cached or coalesced (those read the params after
+     * the handler ran).
+     */
+    std::optional<RpcResponse> handle_one(
+        vix::json::token &&payload,
+        std::string_view transport = {},
+        const MetaView *meta = nullptr) const
+    {
+      return with_arena([&](std::pmr::memory_resource *arena) -> std::optional<RpcResponse>
+                        {
+                          auto parsed = parse_request(std::move(payload), arena);
+                          if (const ErrorView *err = std::get_if<ErrorView>(&parsed))
+                            return RpcResponse::fail(vix::json::token{nullptr}, RpcError(*err));
+
+                          Request &req = std::get<Request>(parsed);
+                          return respond(req.id, dispatch(req, transport, meta, arena, &req.params)); });
+    }
+
+    /// `handle_one()` with metadata held in a `Context::MetaMap` (viewed, not copied).
+    template <typename Map>
+      requires std::same_as<Map, Context::MetaMap>
+    std::optional<RpcResponse> handle_one(
+        const vix::json::token &payload,
+        std::string_view transport,
+        const Map *meta) const
+    {
+      if (!meta)
+        return handle_one(payload, transport);
+
+      const MetaView view = MetaView::of(*meta);
+      return handle_one(payload, transport, &view);
+    }
 
-      RpcRequest req = std::get<RpcRequest>(std::move(parsed));
+    /**
+     * @brief Handle one payload, delivering each response as soon as it is known.
+     *
+     * @param payload   Request token (object or array).
+     * @param sink      Receives the responses, then the end marker.
+     * @param transport Optional transport label.
+     * @param meta      Optional metadata view.
+     *
+     * @details
+     * Same execution as `handle()` (same options, same order), but a batch is not
+     * gathered into an array: every response goes to `sink.on_response` once its
+     * call completed, and `sink.on_end` fires after the last one. Malformed items are
+     * delivered first, with `id = null`.
+     */
+    void stream(const vix::json::token &payload,
+                const BatchSink &sink,
+                std::string_view transport = {},
+                const MetaView *meta = nullptr) const
+    {
+      std::size_t delivered = 0;
+      auto deliver = [&](std::optional<RpcResponse> r)
+      {
+        if (!r)
+          return;
+        ++delivered;
+        if (sink.on_response)
+          sink.on_response(std::move(*r));
+      };
 
-      if (req.id.is_null())
+      const auto ap = payload.as_array_ptr();
+      if (!ap || ap->elems.empty())
       {
-        (void)router_.dispatch(req, transport, meta);
-        return std::nullopt;
+        deliver(handle_single(payload, transport, meta));
+      }
+      else if (auto err = check_batch(*ap))
+      {
+        deliver(RpcResponse::fail(vix::json::token{nullptr}, std::move(*err)));
       }
+      else
+      {
+        with_arena([&](std::pmr::memory_resource *arena)
+                   {
+                     BatchSlots slots = plan_batch(*ap, arena);
 
-      auto out = router_.dispatch(req, transport, meta);
+                     std::pmr::vector<std::pmr::vector<std::size_t>> aliases(slots.size(),
+                                                                             slots.get_allocator());
+                     for (std::size_t i = 0; i < slots.size(); ++i)
+                     {
+                       if (slots[i].alias != no_alias)
+                         aliases[slots[i].alias].push_back(i);
+                     }
 
-      if (std::holds_alternative<RpcError>(out))
-        return RpcResponse::fail(req.id, std::get<RpcError>(std::move(out)));
+                     execute_batch(slots, transport, meta, [&](std::size_t i)
+                                   {
+                                     deliver(response_of(slots, i));
+                                     for (const std::size_t a : aliases[i])
+                                       deliver(response_of(slots, a)); }); });
+      }
 
-      return RpcResponse::ok(req.id, std::get<vix::json::token>(std::move(out)));
+      if (sink.on_end)
+        sink.on_end(delivered);
     }
 
-  private:
-    const Router &router_;
-
     /**
-     * @brief Handle a batch payload (array of calls).
+     * @brief Handle one payload asynchronously on a priority scheduler.
      *
-     * @param payload   Batch token (must be an array).
-     * @param transport Optional transport label.
-     * @param meta      Optional metadata map.
+     * @param scheduler Worker pool executing the calls.
+     * @param payload   Request token (object or array). Shared, not deep-copied.
+     * @param done      Invoked once, on a scheduler thread, with the response.
+     * @param transport Optional transport label (must outlive the completion).
+     * @param meta      Optional metadata view (must outlive the completion).
      *
-     * @return
-     * - `std::nullopt` if all calls are notifications
-     * - otherwise an array token of response objects
+     * @details
+     * - single call: queued in the class of its method (or of its metadata priority)
+     * - batch: every item is queued in its own class; responses are gathered in the
+     *   original order and `done` fires after the last item completes
      *
-     * Rules:
-     * - empty batch is invalid (returns an error response with id = null)
-     * - non-object items produce an error response entry (id = null)
-     * - processing continues for remaining items (best-effort batch)
+     * With `DispatcherOptions::batch_references`, a batch holding references is
+     * queued as a dependency graph: an item is queued once all its inputs completed.
+     *
+     * Calls are queued under the client named by `DispatcherOptions::client_meta_key`,
+     * so the scheduler can share workers fairly between clients. A call refused because
+     * its client queue is full is answered with `RpcError::overloaded()`. If the scheduler
+     * is shutting down, the call runs inline. A handler that throws is answered with
+     * `RpcError::internal_error()`, so the completion still fires.
+     *
+     * @note
+     * The dispatcher and the router must outlive every pending completion.
      */
-    std::optional<vix::json::token> handle_batch(
-        const vix::json::token &payload,
-        std::string_view transport,
-        const Context::MetaMap *meta) const
+    void post(Scheduler &scheduler,
+              vix::json::token payload,
+              DispatchCompletion done,
+              std::string_view transport = {},
+              const MetaView *meta = nullptr) const
     {
       using namespace vix::json;
 
+      const std::string_view client = client_of(meta);
+
       const auto ap = payload.as_array_ptr();
-      if (!ap)
+      if (!ap || ap->elems.empty())
       {
-        RpcResponse err = RpcResponse::fail(token{nullptr},
-                                            RpcError::parse_error("batch must be an array"));
-        return err.to_json();
+        const Priority p = priority_of(payload, meta);
+        auto shared_done = std::make_shared<DispatchCompletion>(std::move(done));
+
+        auto task = [this, payload, shared_done, transport, meta]()
+        {
+          std::optional<token> out;
+          try
+          {
+            out = handle(payload, transport, meta);
+          }
+          catch (...)
+          {
+            auto r = handler_threw(payload);
+            out = r.has_value() ? std::optional<token>(r->to_json()) : std::nullopt;
+          }
+          (*shared_done)(std::move(out));
+        };
+
+        if (!enqueue(scheduler, p, client, std::move(task)))
+        {
+          auto r = reject(payload);
+          (*shared_done)(r.has_value() ? std::optional<token>(r->to_json()) : std::nullopt);
+        }
+        return;
       }
 
-      if (ap->elems.empty())
+      if (auto err = check_batch(*ap))
       {
-        RpcResponse err = RpcResponse::fail(token{nullptr},
-                                            RpcError::invalid_params("batch must not be empty"));
-        return err.to_json();
+        done(RpcResponse::fail(token{nullptr}, std::move(*err)).to_json());
+        return;
       }
 
-      array_t out_arr;
-      out_arr.elems.reserve(ap->elems.size());
+      post_batch(scheduler, *ap,
+                 std::make_shared<BatchOutput>(ap->elems.size(), std::move(done)),
+                 client, transport, meta);
+    }
+
+    /**
+     * @brief Handle one payload asynchronously, streaming responses as they complete.
+     *
+     * @param scheduler Worker pool executing the calls.
+     * @param payload   Request token (object or array). Shared, not deep-copied.
+     * @param sink      Receives each response from the thread that completed it
+     *                  (calls serialized), then the end marker.
+     * @param transport Optional transport label (must outlive the stream).
+     * @param meta      Optional metadata view (must outlive the stream).
+     *
+     * @details
+     * Items are queued exactly as with `post()`; the difference is delivery: the
+     * client gets its first result after the fastest item instead of the slowest.
+     *
+     * @note
+     * The dispatcher and the router must outlive the end of the stream.
+     */
+    void post_stream(Scheduler &scheduler,
+                     vix::json::token payload,
+                     BatchSink sink,
+                     std::string_view transport = {},
+                     const MetaView *meta = nullptr) const
+    {
+      const std::string_view client = client_of(meta);
+      auto out = std::make_shared<BatchOutput>(std::move(sink));
 
-      for (const auto &item : ap->elems)
+      const auto ap = payload.as_array_ptr();
+      if (!ap || ap->elems.empty())
       {
-        if (!item.is_object())
+        auto task = [this, payload, out, transport, meta]()
         {
-          RpcResponse r = RpcResponse::fail(token{nullptr},
-                                            RpcError::parse_error("batch item must be an object"));
-          out_arr.elems.push_back(r.to_json());
-          continue;
-        }
+          std::optional<RpcResponse> r;
+          try
+          {
+            r = handle_single(payload, transport, meta);
+          }
+          catch (...)
+          {
+            r = handler_threw(payload);
+          }
+          out->deliver(0, std::move(r));
+          out->close();
+        };
 
-        auto resp = handle_one(item, transport, meta);
-        if (!resp.has_value())
-          continue;
+        if (!enqueue(scheduler, priority_of(payload, meta), client, std::move(task)))
+        {
+          out->deliver(0, reject(payload));
+          out->close();
+        }
+        return;
+      }
+
+      if (auto err = check_batch(*ap))
+      {
+        out->deliver(0, RpcResponse::fail(vix::json::token{nullptr}, std::move(*err)));
+        out->close();
+        return;
+      }
+
+      post_batch(scheduler, *ap, std::move(out), client, transport, meta);
+    }
+
+    /**
+     * @brief Resolve the scheduling class of a single request token.
+     *
+     * @details
+     * Metadata priority (if configured and present) wins over the method registration.
+     * Unknown methods and malformed envelopes are scheduled as `normal`.
+     */
+    Priority priority_of(const vix::json::token &item,
+                         const MetaView *meta) const
+    {
+      Priority p = Priority::normal;
+
+      if (const auto op = item.as_object_ptr())
+      {
+        if (const vix::json::token *m = op->get_ptr("method"))
+        {
+          if (const std::string *ms = m->as_string())
+          {
+            if (const RouterMethod *rm = router_.find(*ms))
+              p = rm->options.priority;
+          }
+        }
+      }
+
+      if (!options_.priority_meta_key.empty() && meta)
+      {
+        if (const MetaView::Entry *e = meta->find(options_.priority_meta_key))
+          p = parse_priority(e->second, p);
+      }
+
+      return p;
+    }
+
+    /**
+     * @brief Resolve the fair-queuing client key from metadata.
+     *
+     * @return The value of `DispatcherOptions::client_meta_key`, or empty (anonymous).
+     */
+    std::string_view client_of(const MetaView *meta) const noexcept
+    {
+      if (options_.client_meta_key.empty() || !meta)
+        return {};
+
+      return meta->get(options_.client_meta_key);
+    }
+
+  private:
+    const Router &router_;
+    DispatcherOptions options_{};
+    mutable AdmissionGate global_{};
+    mutable Coalescer coalescer_{};
+    std::unique_ptr<ResultCache> cache_{};
+    mutable std::atomic<std::uint64_t> batch_deduplicated_{0};
+    mutable std::atomic<std::uint64_t> batch_too_large_{0};
+    mutable std::atomic<std::uint64_t> params_too_deep_{0};
+    mutable std::atomic<std::uint64_t> params_too_large_{0};
+    mutable std::atomic<std::uint64_t> budget_exceeded_{0};
+    mutable std::atomic<std::uint64_t> resource_exhausted_{0};
+
+    /// Parsed request of the dispatch paths: its method lives in the request arena.
+    using Request = pmr::RpcRequest;
+
+    /// Sentinel for `BatchSlot::alias`.
+    static constexpr std::size_t no_alias = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief One item of a batch being handled.
+     *
+     * @details
+     * Allocator-aware: in a `BatchSlots` vector, `deps` draws from the same
+     * resource as the slots (the batch arena, when there is one).
+     */
+    struct BatchSlot
+    {
+      using allocator_type = std::pmr::polymorphic_allocator<std::size_t>;
+
+      BatchSlot() = default;
+      BatchSlot(const BatchSlot &) = default;
+      BatchSlot(BatchSlot &&) = default;
+      BatchSlot &operator=(const BatchSlot &) = default;
+      BatchSlot &operator=(BatchSlot &&) = default;
+
+      explicit BatchSlot(const allocator_type &alloc) : deps(alloc) {}
+
+      BatchSlot(const BatchSlot &other, const allocator_type &alloc)
+          : req(other.req), method(other.method), result(other.result),
+            alias(other.alias), deps(other.deps, alloc), level(other.level)
+      {
+      }
+
+      BatchSlot(BatchSlot &&other, const allocator_type &alloc)
+          : req(std::move(other.req)), method(other.method), result(std::move(other.result)),
+            alias(other.alias), deps(std::move(other.deps), alloc), level(other.level)
+      {
+      }
+
+      /// Parsed request (empty if the item is malformed).
+      std::optional<Request> req{};
+
+      /// Resolved method (nullptr if unknown or malformed).
+      const RouterMethod *method{nullptr};
+
+      /// Outcome, once known.
+      std::optional<RpcResult> result{};
+
+      /// Index of an identical earlier item whose result is reused (dedupe).
+      std::size_t alias{no_alias};
+
+      /// Items whose results the params reference (pipelining).
+      std::pmr::vector<std::size_t> deps{};
+
+      /// Depth in the reference graph (0 = no input from other items).
+      std::size_t level{0};
+    };
+
+    /// The items of a batch, allocated from its arena (or the default resource).
+    using BatchSlots = std::pmr::vector<BatchSlot>;
+
+    /**
+     * @brief Where a batch run on the scheduler delivers its responses.
+     *
+     * @details
+     * Either gathered (responses kept by item index, one array handed to the
+     * completion at the end) or streamed (each response handed to the sink at once).
+     */
+    struct BatchOutput
+    {
+      BatchOutput(std::size_t items, DispatchCompletion d)
+          : done(std::move(d)), gathered(items)
+      {
+      }
+
+      explicit BatchOutput(BatchSink s) : sink(std::move(s)) {}
+
+      BatchSink sink{};
+      DispatchCompletion done{};
+      std::vector<std::optional<RpcResponse>> gathered{};
+
+      std::mutex mu{};
+      std::size_t delivered{0};
+
+      bool streaming() const noexcept { return !done; }
+
+      /// Response of item `i` (`std::nullopt` for a notification). Thread-safe.
+      void deliver(std::size_t i, std::optional<RpcResponse> r)
+      {
+        if (!streaming())
+        {
+          gathered[i] = std::move(r);
+          return;
+        }
+
+        if (!r)
+          return;
+
+        std::lock_guard<std::mutex> lock(mu);
+        ++delivered;
+        if (sink.on_response)
+          sink.on_response(std::move(*r));
+      }
+
+      /// Called once, after the last `deliver()`.
+      void close()
+      {
+        if (streaming())
+        {
+          std::lock_guard<std::mutex> lock(mu);
+          if (sink.on_end)
+            sink.on_end(delivered);
+          return;
+        }
+
+        vix::json::array_t out_arr;
+        out_arr.elems.reserve(gathered.size());
+        for (auto &r : gathered)
+        {
+          if (r.has_value())
+            out_arr.elems.push_back(r->to_json());
+        }
+
+        if (out_arr.elems.empty())
+          done(std::nullopt);
+        else
+          done(vix::json::token(out_arr));
+      }
+    };
+
+    /**
+     * @brief Queue every item of a batch; the output closes after the last one.
+     */
+    void post_batch(Scheduler &scheduler,
+                    const vix::json::array_t &items,
+                    std::shared_ptr<BatchOutput> out,
+                    std::string_view client,
+                    std::string_view transport,
+                    const MetaView *meta) const
+    {
+      using namespace vix::json;
+
+      if (options_.batch_references && references_in(items))
+        return post_graph(scheduler, items, std::move(out), client, transport, meta);
+
+      struct BatchState
+      {
+        explicit BatchState(std::chrono::microseconds cpu_budget) noexcept : budget(cpu_budget) {}
+
+        std::shared_ptr<BatchOutput> out;
+        std::atomic<std::size_t> remaining{0};
+        BatchBudget budget;
+      };
+
+      auto state = std::make_shared<BatchState>(options_.limits.batch_cpu_budget);
+      state->out = std::move(out);
+      state->remaining.store(items.elems.size(), std::memory_order_relaxed);
+
+      auto complete = [state](std::size_t i, std::optional<RpcResponse> r)
+      {
+        state->out->deliver(i, std::move(r));
+        if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+          state->out->close();
+      };
+
+      for (std::size_t i = 0; i < items.elems.size(); ++i)
+      {
+        const token &item = items.elems[i];
+        const Priority p = priority_of(item, meta);
+
+        auto task = [this, item, i, transport, meta, complete, state]()
+        {
+          std::optional<RpcResponse> r;
+          if (!item.is_object())
+          {
+            r = RpcResponse::fail(token{nullptr},
+                                  RpcError::parse_error("batch item must be an object"));
+          }
+          else if (state->budget.exhausted())
+          {
+            budget_exceeded_.fetch_add(1, std::memory_order_relaxed);
+            r = reject(item, RpcError::budget_exceeded());
+          }
+          else
+          {
+            try
+            {
+              r = state->budget.charge([&]
+                                       { return handle_one(item, transport, meta); });
+            }
+            catch (...)
+            {
+              r = handler_threw(item);
+            }
+          }
+          complete(i, std::move(r));
+        };
+
+        if (!enqueue(scheduler, p, client, std::move(task)))
+          complete(i, reject(item));
+      }
+    }
+
+    /**
+     * @brief Response to a non-batch payload (single call or empty batch).
+     */
+    std::optional<RpcResponse> handle_single(const vix::json::token &payload,
+                                             std::string_view transport,
+                                             const MetaView *meta) const
+    {
+      if (payload.is_array())
+        return RpcResponse::fail(vix::json::token{nullptr},
+                                 RpcError::invalid_params("batch must not be empty"));
+
+      return handle_one(payload, transport, meta);
+    }
+
+    /**
+     * @brief A pipelined batch being run on a scheduler.
+     */
+    struct BatchGraph
+    {
+      explicit BatchGraph(std::chrono::microseconds cpu_budget) noexcept : budget(cpu_budget) {}
+
+      BatchSlots slots;
+      std::vector<Priority> priorities;
+
+      /// Items waiting on each item (inputs and dedupe aliases).
+      std::vector<std::vector<std::size_t>> dependents;
+
+      /// Inputs of each item not completed yet.
+      std::unique_ptr<std::atomic<std::size_t>[]> waiting;
+
+      std::atomic<std::size_t> remaining{0};
+      std::string_view client;
+      std::string_view transport;
+      const MetaView *meta{nullptr};
+      std::shared_ptr<BatchOutput> out;
+      BatchBudget budget;
+    };
+
+    /// True if the params of any item of a batch hold a reference.
+    static bool references_in(const vix::json::array_t &items)
+    {
+      for (const auto &item : items.elems)
+      {
+        const auto op = item.as_object_ptr();
+        const vix::json::token *params = op ? op->get_ptr("params") : nullptr;
+        if (params && has_references(*params))
+          return true;
+      }
+      return false;
+    }
+
+    /**
+     * @brief Queue a pipelined batch: items without pending inputs start at once.
+     */
+    void post_graph(Scheduler &scheduler,
+                    const vix::json::array_t &items,
+                    std::shared_ptr<BatchOutput> out,
+                    std::string_view client,
+                    std::string_view transport,
+                    const MetaView *meta) const
+    {
+      auto g = std::make_shared<BatchGraph>(options_.limits.batch_cpu_budget);
+      g->slots = plan_batch(items);
+
+      const std::size_t n = g->slots.size();
+      g->priorities.reserve(n);
+      g->dependents.resize(n);
+      g->waiting = std::make_unique<std::atomic<std::size_t>[]>(n);
+      g->remaining.store(n, std::memory_order_relaxed);
+      g->client = client;
+      g->transport = transport;
+      g->meta = meta;
+      g->out = std::move(out);
+
+      std::vector<std::size_t> ready;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        const BatchSlot &slot = g->slots[i];
+        g->priorities.push_back(priority_of(items.elems[i], meta));
+
+        std::size_t inputs = slot.deps.size();
+        for (const std::size_t d : slot.deps)
+          g->dependents[d].push_back(i);
+        if (slot.alias != no_alias)
+        {
+          g->dependents[slot.alias].push_back(i);
+          ++inputs;
+        }
+
+        g->waiting[i].store(inputs, std::memory_order_relaxed);
+        if (inputs == 0)
+          ready.push_back(i);
+      }
+
+      for (const std::size_t i : ready)
+        start_node(scheduler, g, i);
+    }
+
+    /**
+     * @brief Queue an item of a pipelined batch whose inputs have all completed.
+     */
+    void start_node(Scheduler &scheduler,
+                    const std::shared_ptr<BatchGraph> &g,
+                    std::size_t i) const
+    {
+      BatchSlot &slot = g->slots[i];
+      bind_references(g->slots, i);
+
+      if (slot.result || slot.alias != no_alias)
+        return finish_node(scheduler, g, i);
+
+      auto task = [this, &scheduler, g, i]()
+      {
+        BatchSlot &s = g->slots[i];
+        if (g->budget.exhausted())
+        {
+          budget_exceeded_.fetch_add(1, std::memory_order_relaxed);
+          s.result = RpcError::budget_exceeded();
+        }
+        else
+        {
+          try
+          {
+            s.result = g->budget.charge([&]
+                                        { return with_arena([&](std::pmr::memory_resource *arena)
+                                                            { return dispatch(*s.req, g->transport, g->meta, arena); }); });
+          }
+          catch (...)
+          {
+            s.result = RpcError::internal_error(handler_failed);
+          }
+        }
+        finish_node(scheduler, g, i);
+      };
+
+      if (!enqueue(scheduler, g->priorities[i], g->client, std::move(task)))
+      {
+        slot.result = RpcError::overloaded();
+        finish_node(scheduler, g, i);
+      }
+    }
+
+    /**
+     * @brief Deliver a completed item and release its dependents; the last one closes.
+     */
+    void finish_node(Scheduler &scheduler,
+                     const std::shared_ptr<BatchGraph> &g,
+                     std::size_t i) const
+    {
+      g->out->deliver(i, response_of(g->slots, i));
+
+      for (const std::size_t d : g->dependents[i])
+      {
+        if (g->waiting[d].fetch_sub(1, std::memory_order_acq_rel) == 1)
+          start_node(scheduler, g, d);
+      }
+
+      if (g->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        g->out->close();
+    }
+
+    /**
+     * @brief Queue a call on the scheduler.
+     *
+     * @return False if the client queue is full (nothing ran). A stopped scheduler
+     *         runs the call inline.
+     */
+    template <typename Fn>
+    static bool enqueue(Scheduler &scheduler, Priority p, std::string_view client, Fn &&fn)
+    {
+      Scheduler::Task task(std::forward<Fn>(fn));
+      switch (scheduler.submit(p, client, std::move(task)))
+      {
+      case SubmitStatus::accepted:
+        return true;
+      case SubmitStatus::client_full:
+        return false;
+      case SubmitStatus::stopped:
+        break;
+      }
+
+      task();
+      return true;
+    }
+
+    /**
+     * @brief Answer for a call refused before it ran (overload by default).
+     *
+     * @return Error response echoing the id, or `std::nullopt` for a notification.
+     */
+    static std::optional<RpcResponse> reject(const vix::json::token &item,
+                                             const RpcError &err = RpcError::overloaded())
+    {
+      vix::json::token id{nullptr};
+      if (const auto op = item.as_object_ptr())
+      {
+        if (const vix::json::token *idp = op->get_ptr("id"))
+          id = *idp;
+        if (id.is_null())
+          return std::nullopt;
+      }
+
+      return RpcResponse::fail(std::move(id), err);
+    }
+
+    /// Message of the error answering a call whose handler threw on a scheduler thread.
+    static constexpr std::string_view handler_failed = "handler failed";
+
+    /**
+     * @brief Answer for a call whose handler threw on a scheduler thread.
+     *
+     * @return Internal error echoing the id, or `std::nullopt` for a notification.
+     */
+    static std::optional<RpcResponse> handler_threw(const vix::json::token &item)
+    {
+      return reject(item, RpcError::internal_error(handler_failed));
+    }
+
+    /**
+     * @brief Run `fn(arena)` with a fresh `RequestArena`, or with null if disabled.
+     *
+     * @details
+     * The arena lives on this stack frame: whatever `fn` returns must not point
+     * into it.
+     */
+    template <typename Fn>
+    std::invoke_result_t<Fn &, std::pmr::memory_resource *> with_arena(Fn &&fn) const
+    {
+      if (!options_.request_arena)
+        return fn(static_cast<std::pmr::memory_resource *>(nullptr));
+
+      RequestArena arena(options_.arena_upstream);
+      return fn(&arena);
+    }
+
+    /// Arena of a planned batch (null when its slots use the default resource).
+    static std::pmr::memory_resource *arena_of(const BatchSlots &slots) noexcept
+    {
+      std::pmr::memory_resource *mem = slots.get_allocator().resource();
+      return mem == std::pmr::get_default_resource() ? nullptr : mem;
+    }
+
+    /**
+     * @brief Parse a request envelope under `DispatcherLimits` (counts rejections).
+     *
+     * @details
+     * With an arena, the method name is allocated from it. A rejection is an
+     * `ErrorView`: the write paths output it without building an error.
+     */
+    std::variant<Request, ErrorView> parse_request(const vix::json::token &item,
+                                                   std::pmr::memory_resource *arena = nullptr) const
+    {
+      return counted(Request::try_parse(item, options_.limits, Request::allocator_type(memory_of(arena))));
+    }
+
+    /// `parse_request()` of a payload the caller gives up (see `RpcRequest::parse(token &&)`).
+    std::variant<Request, ErrorView> parse_request(vix::json::token &&item,
+                                                   std::pmr::memory_resource *arena = nullptr) const
+    {
+      return counted(Request::try_parse(std::move(item), options_.limits,
+                                        Request::allocator_type(memory_of(arena))));
+    }
+
+    /// Count a params limit rejection.
+    std::variant<Request, ErrorView> counted(std::variant<Request, ErrorView> parsed) const
+    {
+      if (const ErrorView *err = std::get_if<ErrorView>(&parsed))
+      {
+        if (err->code == ErrorCode::params_too_deep)
+          params_too_deep_.fetch_add(1, std::memory_order_relaxed);
+        else if (err->code == ErrorCode::params_too_large)
+          params_too_large_.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      return parsed;
+    }
+
+    /// `arena`, or the default resource.
+    static std::pmr::memory_resource *memory_of(std::pmr::memory_resource *arena) noexcept
+    {
+      return arena ? arena : std::pmr::get_default_resource();
+    }
+
+    /**
+     * @brief Batch size check, before any item is parsed (counts rejections).
+     *
+     * @return The error answering the whole batch, or `std::nullopt` if accepted.
+     */
+    std::optional<RpcError> check_batch(const vix::json::array_t &items) const
+    {
+      const std::size_t max = options_.limits.max_batch_items;
+      if (max == 0 || items.elems.size() <= max)
+        return std::nullopt;
+
+      batch_too_large_.fetch_add(1, std::memory_order_relaxed);
+      return RpcError::batch_too_large(max);
+    }
+
+    /**
+     * @brief Resolve, admit and execute one parsed request.
+     *
+     * @details
+     * Admission runs after method resolution and before the handler. A rejected
+     * call costs two atomic operations and returns the preallocated overload error.
+     * `owned` reaches the handler only when nothing reads the params after it.
+     */
+    RpcResult dispatch(const Request &req,
+                       std::string_view transport,
+                       const MetaView *meta,
+                       std::pmr::memory_resource *arena,
+                       vix::json::token *owned = nullptr) const
+    {
+      if (!req.valid())
+        return RpcError::invalid_params("invalid rpc request");
+
+      const RouterMethod *m = router_.find(req.method);
+      if (!m)
+        return RpcError::method_not_found(req.method);
+
+      return dispatch(*m, req, transport, meta, arena, owned);
+    }
+
+    /**
+     * @brief `dispatch()` of a request whose method is already resolved.
+     */
+    RpcResult dispatch(const RouterMethod &m,
+                       const Request &req,
+                       std::string_view transport,
+                       const MetaView *meta,
+                       std::pmr::memory_resource *arena,
+                       vix::json::token *owned = nullptr) const
+    {
+      const bool cached = cache_ && m.options.cache_ttl.count() > 0;
+      const bool merged = m.options.idempotent && options_.coalesce;
+      if (!cached && !merged)
+        return execute(m, req, transport, meta, arena, owned);
+
+      const std::uint64_t key = call_hash(req.method, req.params);
+
+      if (cached)
+      {
+        if (auto hit = cache_->get(key, req.method, req.params))
+          return std::move(*hit);
+      }
+
+      return fill(m, req, key, transport, meta, arena);
+    }
+
+    /**
+     * @brief Run a cached or coalesced call that missed the cache.
+     *
+     * @details
+     * Joins the in-flight call when coalescing; the flight leader fills the cache.
+     */
+    RpcResult fill(const RouterMethod &m,
+                   const Request &req,
+                   std::uint64_t key,
+                   std::string_view transport,
+                   const MetaView *meta,
+                   std::pmr::memory_resource *arena) const
+    {
+      const bool cached = cache_ && m.options.cache_ttl.count() > 0;
+
+      auto run = [&]() -> RpcResult
+      {
+        RpcResult out = execute(m, req, transport, meta, arena);
+        if (cached && std::holds_alternative<vix::json::token>(out))
+          cache_->put(key, req.method, req.params, std::get<vix::json::token>(out), m.options.cache_ttl);
+        return out;
+      };
+
+      if (m.options.idempotent && options_.coalesce)
+        return coalescer_.run(key, req.method, req.params, run);
+
+      return run();
+    }
+
+    /**
+     * @brief Admit and run a resolved method (admission, adaptive limit, handler).
+     */
+    RpcResult execute(const RouterMethod &m,
+                      const Request &req,
+                      std::string_view transport,
+                      const MetaView *meta,
+                      std::pmr::memory_resource *arena,
+                      vix::json::token *owned = nullptr) const
+    {
+      AdmissionPermit permit;
+      if (admit(&global_, m.admission.get(), permit) != AdmissionDecision::admitted)
+        return RpcError::overloaded();
+
+      AdaptivePermit adaptive;
+      if (!adaptive.acquire(m.adaptive.get()))
+        return RpcError::overloaded();
+
+      return budgeted(m, req, transport, meta, arena, owned);
+    }
+
+    /**
+     * @brief Run the handler of one admitted call under its memory budget.
+     *
+     * @details
+     * The handler gets a `MemoryBudget` over the request memory as `Context::memory()`.
+     * An allocation crossing the budget throws `MemoryBudgetExceeded` out of the
+     * handler, which is caught here; a result too large for what is left is dropped.
+     * Both answer `RESOURCE_EXHAUSTED`, and the method's high-water mark is updated.
+     * The result is measured only once the handler returned it: its memory was
+     * already taken from the global heap by then.
+     * Micro-batched calls run inside a shared handler invocation and are not measured.
+     */
+    RpcResult budgeted(const RouterMethod &m,
+                       const Request &req,
+                       std::string_view transport,
+                       const MetaView *meta,
+                       std::pmr::memory_resource *arena,
+                       vix::json::token *owned) const
+    {
+      const std::size_t limit = m.options.memory_budget != 0 ? m.options.memory_budget
+                                                             : options_.limits.max_request_memory;
+      if ((limit == 0 && !options_.track_memory) || (m.micro && m.batch))
+        return invoke(m, req, transport, meta, arena, owned);
+
+      MemoryBudget budget(limit, memory_of(arena));
+      RpcResult out;
+      try
+      {
+        out = invoke(m, req, transport, meta, &budget, owned);
+      }
+      catch (const MemoryBudgetExceeded &)
+      {
+      }
+
+      if (const vix::json::token *result = std::get_if<vix::json::token>(&out); result && !budget.exhausted())
+      {
+        if (limit != 0 && budget.remaining() == 0)
+          budget.charge(1); // nothing fits: refuse without walking the result
+        else
+          budget.charge(result_bytes(*result, budget.remaining()));
+      }
+
+      m.memory->record(budget.exhausted() ? limit : budget.used(), budget.exhausted());
+
+      if (budget.exhausted())
+      {
+        resource_exhausted_.fetch_add(1, std::memory_order_relaxed);
+        return RpcError::resource_exhausted(limit);
+      }
+
+      return out;
+    }
+
+    /**
+     * @brief Estimated JSON size of a result.
+     *
+     * @details
+     * The walk stops as soon as it passes `max` (returning more than `max`), so its
+     * cost is bounded by the budget left. `SIZE_MAX` (counting only) walks it all.
+     */
+    static std::size_t result_bytes(const vix::json::token &result, std::size_t max) noexcept
+    {
+      constexpr std::size_t unbounded = static_cast<std::size_t>(-1);
+
+      // `max_params_bytes` 0 means unlimited: stop at `max + 1` instead.
+      DispatcherLimits limits;
+      limits.max_params_bytes = max == unbounded ? 0 : max + 1;
+
+      std::size_t bytes = 0;
+      (void)detail::measure(result, 0, limits, bytes);
+      return bytes;
+    }
+
+    /**
+     * @brief Run the handler of one admitted call.
+     *
+     * @details
+     * Methods with a vectorized handler and micro-batching enabled join concurrent
+     * calls of the same method; everything else goes straight to `Router::invoke()`.
+     */
+    static RpcResult invoke(const RouterMethod &m,
+                            const Request &req,
+                            std::string_view transport,
+                            const MetaView *meta,
+                            std::pmr::memory_resource *arena,
+                            vix::json::token *owned = nullptr)
+    {
+      if (!m.micro || !m.batch)
+        return Router::invoke(m, req, transport, meta, arena, owned);
+
+      const Context ctx{req.method, req.params, req.id, transport, meta, arena};
+      return m.micro->call(ctx, m.batch);
+    }
+
+    /**
+     * @brief Parse and resolve every item of a batch (nothing runs yet).
+     *
+     * @details
+     * With `DispatcherOptions::dedupe_batches`, an idempotent item identical to an
+     * earlier one (same method, structurally equal params) is marked as its alias.
+     * With `DispatcherOptions::batch_references`, references are linked into
+     * dependencies (see `link_references()`).
+     */
+    BatchSlots plan_batch(const vix::json::array_t &items,
+                          std::pmr::memory_resource *arena = nullptr) const
+    {
+      std::pmr::memory_resource *mem = arena ? arena : std::pmr::get_default_resource();
+      BatchSlots slots(items.elems.size(), mem);
+      std::pmr::unordered_multimap<std::uint64_t, std::size_t> seen(mem);
+
+      for (std::size_t i = 0; i < slots.size(); ++i)
+      {
+        BatchSlot &slot = slots[i];
+        const vix::json::token &item = items.elems[i];
+
+        if (!item.is_object())
+        {
+          slot.result = RpcError::parse_error("batch item must be an object");
+          continue;
+        }
+
+        auto parsed = parse_request(item, arena);
+        if (const ErrorView *err = std::get_if<ErrorView>(&parsed))
+        {
+          slot.result = RpcError(*err);
+          continue;
+        }
+
+        slot.req = std::get<Request>(std::move(parsed));
+        slot.method = router_.find(slot.req->method);
+
+        if (!options_.dedupe_batches || !slot.method || !slot.method->options.idempotent)
+          continue;
+
+        // Params of a pipelined item are only known once its inputs ran.
+        if (options_.batch_references && has_references(slot.req->params))
+          continue;
+
+        const std::uint64_t key = call_hash(slot.req->method, slot.req->params);
+        const auto [first, last] = seen.equal_range(key);
+        for (auto it = first; it != last; ++it)
+        {
+          const Request &other = *slots[it->second].req;
+          if (other.method == slot.req->method && equal(other.params, slot.req->params))
+          {
+            slot.alias = it->second;
+            batch_deduplicated_.fetch_add(1, std::memory_order_relaxed);
+            break;
+          }
+        }
+
+        if (slot.alias == no_alias)
+          seen.emplace(key, i);
+      }
+
+      if (options_.batch_references)
+        link_references(slots);
+
+      return slots;
+    }
+
+    /**
+     * @brief Turn the references of a planned batch into a dependency graph.
+     *
+     * @details
+     * - a reference designates the item whose id has the same `reference_key()`
+     *   (notifications cannot be referenced); unknown or duplicated ids fail the item
+     * - levels are assigned in topological order (Kahn): an item runs one level
+     *   after the deepest of its inputs
+     * - items left over are on a cycle (or wait on one) and fail
+     */
+    static void link_references(BatchSlots &slots)
+    {
+      constexpr std::size_t ambiguous = no_alias;
+
+      std::pmr::memory_resource *mem = slots.get_allocator().resource();
+      std::pmr::unordered_map<std::pmr::string, std::size_t, detail::string_hash, std::equal_to<>> ids(mem);
+      bool any = false;
+
+      for (std::size_t i = 0; i < slots.size(); ++i)
+      {
+        if (!slots[i].req)
+          continue;
+
+        if (const auto key = reference_key(slots[i].req->id))
+        {
+          const auto [it, inserted] = ids.emplace(*key, i);
+          if (!inserted)
+            it->second = ambiguous;
+        }
+      }
 
-        out_arr.elems.push_back(resp->to_json());
+      for (std::size_t i = 0; i < slots.size(); ++i)
+      {
+        BatchSlot &slot = slots[i];
+        if (!slot.req || slot.result)
+          continue;
+
+        std::optional<RpcError> failed;
+        for_each_reference(slot.req->params, [&](const ResultRef &ref)
+                           {
+                             if (failed)
+                               return;
+
+                             const auto key = reference_key(*ref.id);
+                             const auto it = key ? ids.find(std::string_view(*key)) : ids.end();
+                             if (it == ids.end())
+                               failed = RpcError::invalid_params("unresolved reference: " + key.value_or(""));
+                             else if (it->second == ambiguous)
+                               failed = RpcError::invalid_params("ambiguous reference: " + *key);
+                             else if (std::find(slot.deps.begin(), slot.deps.end(), it->second) == slot.deps.end())
+                               slot.deps.push_back(it->second); });
+
+        if (failed)
+        {
+          slot.result = std::move(*failed);
+          slot.deps.clear();
+        }
+        any = any || !slot.deps.empty();
+      }
+
+      if (!any)
+        return;
+
+      std::pmr::vector<std::size_t> waiting(slots.size(), mem);
+      std::pmr::vector<std::pmr::vector<std::size_t>> dependents(slots.size(), mem);
+      std::pmr::vector<std::size_t> ready(mem);
+
+      for (std::size_t i = 0; i < slots.size(); ++i)
+      {
+        waiting[i] = slots[i].deps.size();
+        for (const std::size_t d : slots[i].deps)
+          dependents[d].push_back(i);
+        if (waiting[i] == 0)
+          ready.push_back(i);
+      }
+
+      std::size_t ordered = 0;
+      while (ordered < ready.size())
+      {
+        const std::size_t i = ready[ordered++];
+        for (const std::size_t d : dependents[i])
+        {
+          slots[d].level = std::max(slots[d].level, slots[i].level + 1);
+          if (--waiting[d] == 0)
+            ready.push_back(d);
+        }
+      }
+
+      if (ready.size() == slots.size())
+        return;
+
+      for (std::size_t i = 0; i < slots.size(); ++i)
+      {
+        if (waiting[i] == 0)
+          continue;
+
+        slots[i].result = RpcError::invalid_params("cyclic reference");
+        slots[i].deps.clear();
+        slots[i].level = 0;
+      }
+    }
+
+    /**
+     * @brief Outcome of a batch item (through its dedupe alias, if any).
+     */
+    static const std::optional<RpcResult> &outcome(const BatchSlots &slots,
+                                                   std::size_t i) noexcept
+    {
+      const BatchSlot &slot = slots[i];
+      return slot.alias == no_alias ? slot.result : slots[slot.alias].result;
+    }
+
+    /**
+     * @brief Substitute the references of an item whose inputs have all completed.
+     *
+     * @details
+     * Fails the item instead if an input failed or a path does not exist.
+     */
+    static void bind_references(BatchSlots &slots, std::size_t i)
+    {
+      BatchSlot &slot = slots[i];
+      if (slot.deps.empty() || slot.result)
+        return;
+
+      for (const std::size_t d : slot.deps)
+      {
+        const auto &in = outcome(slots, d);
+        if (!in || !std::holds_alternative<vix::json::token>(*in))
+        {
+          slot.result = RpcError::invalid_params("referenced call failed");
+          return;
+        }
+      }
+
+      RpcResult params = substitute_references(
+          slot.req->params, [&](const ResultRef &ref) -> RpcResult
+          {
+            const auto key = reference_key(*ref.id);
+            for (const std::size_t d : slot.deps)
+            {
+              if (reference_key(slots[d].req->id) != key)
+                continue;
+
+              if (auto v = resolve_pointer(std::get<vix::json::token>(*outcome(slots, d)), ref.path))
+                return std::move(*v);
+              return RpcError::invalid_params("reference path not found: " + std::string(ref.path));
+            }
+            return RpcError::invalid_params("unresolved reference");
+          });
+
+      if (std::holds_alternative<RpcError>(params))
+        slot.result = std::get<RpcError>(std::move(params));
+      else
+        slot.req->params = std::get<vix::json::token>(std::move(params));
+    }
+
+    /**
+     * @brief Run every pending item of a planned batch, in order.
+     *
+     * @details
+     * Items of a method with a vectorized handler run as one group, at the position
+     * of the first one; the other items run one by one through `dispatch()`.
+     * A pipelined batch runs one reference level after the other; references of a
+     * level are bound before any of its items runs.
+     *
+     * `completed(i)`, if set, is called once per item as soon as its result is known
+     * (dedupe aliases excluded: they complete with their target).
+     *
+     * With `DispatcherLimits::batch_cpu_budget`, items not started once the batch
+     * spent its budget are answered with `RpcError::budget_exceeded()`.
+     */
+    void execute_batch(BatchSlots &slots,
+                       std::string_view transport,
+                       const MetaView *meta,
+                       const std::function<void(std::size_t)> &completed = {}) const
+    {
+      std::size_t levels = 1;
+      for (const BatchSlot &slot : slots)
+        levels = std::max(levels, slot.level + 1);
+
+      std::pmr::vector<std::size_t> order(slots.get_allocator());
+      if (options_.group_batches_by_method)
+      {
+        order = method_order(slots);
+      }
+      else
+      {
+        order.resize(slots.size());
+        for (std::size_t i = 0; i < order.size(); ++i)
+          order[i] = i;
+      }
+
+      auto notify = [&](std::size_t i)
+      {
+        if (completed)
+          completed(i);
+      };
+
+      // Rejected while planning (malformed, unresolvable references).
+      for (std::size_t i = 0; i < slots.size(); ++i)
+      {
+        if (slots[i].result)
+          notify(i);
+      }
+
+      BatchBudget budget(options_.limits.batch_cpu_budget);
+
+      for (std::size_t level = 0; level < levels; ++level)
+      {
+        if (level > 0)
+        {
+          for (const std::size_t i : order)
+          {
+            if (slots[i].level != level || slots[i].result)
+              continue;
+
+            bind_references(slots, i);
+            if (slots[i].result)
+              notify(i);
+          }
+        }
+
+        for (const std::size_t i : order)
+        {
+          BatchSlot &slot = slots[i];
+          if (slot.level != level || slot.result || slot.alias != no_alias)
+            continue;
+
+          if (budget.exhausted())
+          {
+            budget_exceeded_.fetch_add(1, std::memory_order_relaxed);
+            slot.result = RpcError::budget_exceeded();
+            notify(i);
+            continue;
+          }
+
+          budget.charge([&]
+                        { execute_slot(slots, i, transport, meta, notify); });
+        }
+      }
+    }
+
+    /**
+     * @brief Run one pending item (or the whole group of its vectorized method).
+     *
+     * @details
+     * `completed(j)` is called for every item this step resolved.
+     */
+    template <typename Completed>
+    void execute_slot(BatchSlots &slots,
+                      std::size_t i,
+                      std::string_view transport,
+                      const MetaView *meta,
+                      Completed &&completed) const
+    {
+      BatchSlot &slot = slots[i];
+      if (slot.result || slot.alias != no_alias)
+        return;
+
+      if (slot.method && slot.method->batch && slot.req->valid())
+      {
+        for (const std::size_t j : execute_group(slots, i, transport, meta))
+          completed(j);
+        return;
+      }
+
+      slot.result = dispatch(*slot.req, transport, meta, arena_of(slots));
+      completed(i);
+    }
+
+    /**
+     * @brief Execution order of the pending items, partitioned by method.
+     *
+     * @details
+     * Stable counting sort: groups are ranked by first appearance of their method,
+     * items keep their relative order inside a group. O(n), one pass to rank and
+     * one pass to place.
+     */
+    static std::pmr::vector<std::size_t> method_order(const BatchSlots &slots)
+    {
+      std::pmr::memory_resource *mem = slots.get_allocator().resource();
+      std::pmr::vector<std::size_t> rank(slots.size(), 0, mem);
+      std::pmr::vector<std::size_t> counts(mem);
+
+      std::pmr::unordered_map<const RouterMethod *, std::size_t> ranks(mem);
+      for (std::size_t i = 0; i < slots.size(); ++i)
+      {
+        const auto [it, inserted] = ranks.emplace(slots[i].method, counts.size());
+        if (inserted)
+          counts.push_back(0);
+        rank[i] = it->second;
+        ++counts[it->second];
+      }
+
+      std::pmr::vector<std::size_t> offsets(counts.size(), 0, mem);
+      for (std::size_t g = 1; g < counts.size(); ++g)
+        offsets[g] = offsets[g - 1] + counts[g - 1];
+
+      std::pmr::vector<std::size_t> order(slots.size(), std::pmr::polymorphic_allocator<std::size_t>(mem));
+      for (std::size_t i = 0; i < slots.size(); ++i)
+        order[offsets[rank[i]]++] = i;
+
+      return order;
+    }
+
+    /**
+     * @brief Run all pending items of `slots[first].method` with its batch handler.
+     *
+     * @details
+     * Only items of the same reference level join the group.
+     * The group passes admission once (it is one handler invocation) and feeds the
+     * adaptive limiter with one latency sample. Results are scattered back to the
+     * slots of their calls.
+     *
+     * @return Indices of the items that ran.
+     */
+    std::pmr::vector<std::size_t> execute_group(BatchSlots &slots,
+                                           std::size_t first,
+                                           std::string_view transport,
+                                           const MetaView *meta) const
+    {
+      const RouterMethod &m = *slots[first].method;
+      const std::size_t level = slots[first].level;
+
+      std::pmr::memory_resource *mem = slots.get_allocator().resource();
+      std::pmr::vector<std::size_t> members(mem);
+      for (std::size_t j = first; j < slots.size(); ++j)
+      {
+        const BatchSlot &s = slots[j];
+        if (s.method == &m && s.level == level && !s.result && s.alias == no_alias)
+          members.push_back(j);
+      }
+
+      std::pmr::vector<Context> calls(mem);
+      calls.reserve(members.size());
+      for (const std::size_t j : members)
+      {
+        const Request &req = *slots[j].req;
+        calls.push_back(Context{req.method, req.params, req.id, transport, meta, arena_of(slots)});
+      }
+
+      std::pmr::vector<RpcResult> results(members.size(), std::pmr::polymorphic_allocator<RpcResult>(mem));
+      run_batch(m, calls, results);
+
+      for (std::size_t k = 0; k < members.size(); ++k)
+        slots[members[k]].result = std::move(results[k]);
+
+      return members;
+    }
+
+    /**
+     * @brief Admit and run a vectorized handler (one admission, one latency sample).
+     */
+    void run_batch(const RouterMethod &m,
+                   std::span<const Context> calls,
+                   std::span<RpcResult> results) const
+    {
+      auto reject_all = [&]
+      {
+        for (RpcResult &r : results)
+          r = RpcError::overloaded();
+      };
+
+      AdmissionPermit permit;
+      if (admit(&global_, m.admission.get(), permit) != AdmissionDecision::admitted)
+        return reject_all();
+
+      AdaptivePermit adaptive;
+      if (!adaptive.acquire(m.adaptive.get()))
+        return reject_all();
+
+      m.batch(calls, results);
+    }
+
+    /**
+     * @brief Wrap a result into a response (`std::nullopt` for a notification).
+     *
+     * @details
+     * The response owns its error: it outlives the request arena.
+     */
+    static std::optional<RpcResponse> respond(const vix::json::token &id, RpcResult out)
+    {
+      if (id.is_null())
+        return std::nullopt;
+
+      if (std::holds_alternative<RpcError>(out))
+        return RpcResponse::fail(id, std::get<RpcError>(std::move(out)));
+
+      return RpcResponse::ok(id, std::get<vix::json::token>(std::move(out)));
+    }
+
+    /**
+     * @brief Handle a batch payload (array of calls).
+     *
+     * @param payload   Batch token (must be an array).
+     * @param transport Optional transport label.
+     * @param meta      Optional metadata view.
+     *
+     * @return
+     * - `std::nullopt` if all calls are notifications
+     * - otherwise an array token of response objects
+     *
+     * Rules:
+     * - empty batch is invalid (returns an error response with id = null)
+     * - non-object items produce an error response entry (id = null)
+     * - processing continues for remaining items (best-effort batch)
+     * - items of a method registered with `Router::add_batch()` run as one group
+     * - responses keep the order of the items
+     */
+    std::optional<vix::json::token> handle_batch(
+        const vix::json::token &payload,
+        std::string_view transport,
+        const MetaView *meta) const
+    {
+      using namespace vix::json;
+
+      const auto ap = payload.as_array_ptr();
+      if (!ap)
+      {
+        RpcResponse err = RpcResponse::fail(token{nullptr},
+                                            RpcError::parse_error("batch must be an array"));
+        return err.to_json();
+      }
+
+      if (ap->elems.empty())
+      {
+        RpcResponse err = RpcResponse::fail(token{nullptr},
+                                            RpcError::invalid_params("batch must not be empty"));
+        return err.to_json();
+      }
+
+      if (auto err = check_batch(*ap))
+        return RpcResponse::fail(token{nullptr}, std::move(*err)).to_json();
+
+      return with_arena([&](std::pmr::memory_resource *arena)
+                        {
+                          BatchSlots slots = plan_batch(*ap, arena);
+                          execute_batch(slots, transport, meta);
+                          return assemble(slots); });
+    }
+
+    /// Append an error response with `id = null` (`err`: `RpcError` or `ErrorView`).
+    template <typename Error>
+    static void write_error(std::string &out, const Error &err)
+    {
+      out.append("{\"id\":null,\"error\":");
+      err.write_json(out);
+      out.push_back('}');
+    }
+
+    /**
+     * @brief Append the response of a call (same JSON as `respond()` then `write_json()`).
+     *
+     * @return `false` (nothing written) for a notification.
+     */
+    static bool write_response(std::string &out, const vix::json::token &id, const RpcResult &result)
+    {
+      if (id.is_null())
+        return false;
+
+      out.append("{\"id\":");
+      detail::append_json(out, id);
+      if (const RpcError *err = std::get_if<RpcError>(&result))
+      {
+        out.append(",\"error\":");
+        err->write_json(out);
+      }
+      else
+      {
+        out.append(",\"result\":");
+        detail::append_json(out, std::get<vix::json::token>(result));
+      }
+      out.push_back('}');
+      return true;
+    }
+
+    /// `write_response()` of a call rejected with a built-in error.
+    static bool write_response(std::string &out, const vix::json::token &id, const ErrorView &err)
+    {
+      if (id.is_null())
+        return false;
+
+      out.append("{\"id\":");
+      detail::append_json(out, id);
+      out.append(",\"error\":");
+      err.write_json(out);
+      out.push_back('}');
+      return true;
+    }
+
+    /**
+     * @brief `write()` with a given arena (null = default resource).
+     */
+    bool write_in(const vix::json::token &payload,
+                  std::string &out,
+                  std::pmr::memory_resource *arena,
+                  std::string_view transport,
+                  const MetaView *meta) const
+    {
+      if (payload.is_array())
+        return write_batch(payload, out, arena, transport, meta);
+
+      auto parsed = parse_request(payload, arena);
+      if (const ErrorView *err = std::get_if<ErrorView>(&parsed))
+      {
+        write_error(out, *err);
+        return true;
+      }
+
+      // An unknown method is answered from its view, without building the error.
+      const Request &req = std::get<Request>(parsed);
+      const RouterMethod *m = router_.find(req.method);
+      if (!m)
+        return write_response(out, req.id, ErrorView::method_not_found(req.method));
+
+      if (cache_ && m->options.cache_ttl.count() > 0)
+        return write_cached(out, *m, req, transport, meta, arena);
+
+      return write_response(out, req.id, dispatch(*m, req, transport, meta, arena));
+    }
+
+    /**
+     * @brief `write_response()` of a cached method: a hit appends the stored result text.
+     */
+    bool write_cached(std::string &out,
+                      const RouterMethod &m,
+                      const Request &req,
+                      std::string_view transport,
+                      const MetaView *meta,
+                      std::pmr::memory_resource *arena) const
+    {
+      const std::uint64_t key = call_hash(req.method, req.params);
+
+      const std::size_t start = out.size();
+      out.append("{\"id\":");
+      detail::append_json(out, req.id);
+      out.append(",\"result\":");
+      if (cache_->append(key, req.method, req.params, out))
+      {
+        if (req.id.is_null())
+        {
+          out.resize(start);
+          return false;
+        }
+        out.push_back('}');
+        return true;
+      }
+
+      out.resize(start);
+      return write_response(out, req.id, fill(m, req, key, transport, meta, arena));
+    }
+
+    /**
+     * @brief `write()` of a batch payload (same rules as `handle_batch()`).
+     */
+    bool write_batch(const vix::json::token &payload,
+                     std::string &out,
+                     std::pmr::memory_resource *arena,
+                     std::string_view transport,
+                     const MetaView *meta) const
+    {
+      const auto ap = payload.as_array_ptr();
+      if (!ap)
+      {
+        write_error(out, ErrorView::parse_error("batch must be an array"));
+        return true;
+      }
+
+      if (ap->elems.empty())
+      {
+        write_error(out, ErrorView::invalid_params("batch must not be empty"));
+        return true;
+      }
+
+      if (auto err = check_batch(*ap))
+      {
+        write_error(out, *err);
+        return true;
+      }
+
+      BatchSlots slots = plan_batch(*ap, arena);
+      execute_batch(slots, transport, meta);
+
+      const std::size_t start = out.size();
+      bool any = false;
+      out.push_back('[');
+      for (std::size_t i = 0; i < slots.size(); ++i)
+      {
+        const BatchSlot &slot = slots[i];
+        if (!slot.req)
+        {
+          if (any)
+            out.push_back(',');
+          any = true;
+          write_error(out, std::get<RpcError>(*slot.result));
+        }
+        else if (!slot.req->id.is_null())
+        {
+          if (any)
+            out.push_back(',');
+          any = true;
+          write_response(out, slot.req->id, *outcome(slots, i));
+        }
+      }
+
+      if (!any)
+      {
+        out.resize(start);
+        return false;
+      }
+
+      out.push_back(']');
+      return true;
+    }
+
+    /**
+     * @brief Response of a completed batch item (`std::nullopt` for a notification).
+     *
+     * @details
+     * Malformed items have no reliable id: they are answered with `id = null`.
+     */
+    static std::optional<RpcResponse> response_of(const BatchSlots &slots,
+                                                  std::size_t i)
+    {
+      const BatchSlot &slot = slots[i];
+      if (!slot.req)
+        return RpcResponse::fail(vix::json::token{nullptr}, std::get<RpcError>(*slot.result));
+
+      return respond(slot.req->id, *outcome(slots, i));
+    }
+
+    /**
+     * @brief Build the response array of a completed batch, in item order.
+     *
+     * @return `std::nullopt` if every item is a notification.
+     */
+    static std::optional<vix::json::token> assemble(const BatchSlots &slots)
+    {
+      using namespace vix::json;
+
+      array_t out_arr;
+      out_arr.elems.reserve(slots.size());
+
+      for (std::size_t i = 0; i < slots.size(); ++i)
+      {
+        if (auto resp = response_of(slots, i))
+          out_arr.elems.push_back(resp->to_json());
       }
 
       if (out_arr.elems.empty())
@@ -16,15 +16,204 @@
 #ifndef VIX_WEBRPC_ERROR_HPP
 #define VIX_WEBRPC_ERROR_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <utility>
 
 #include <vix/json/Simple.hpp>
 
+#include <vix/webrpc/detail/JsonWriter.hpp>
+
 namespace vix::webrpc
 {
-  struct RpcErrorParseResult;
+  template <typename Allocator>
+  struct BasicRpcErrorParseResult;
+
+  /**
+   * @brief Built-in error codes.
+   */
+  enum class ErrorCode : std::uint8_t
+  {
+    custom,
+    parse_error,
+    invalid_params,
+    method_not_found,
+    internal_error,
+    overloaded,
+    batch_too_large,
+    params_too_deep,
+    params_too_large,
+    budget_exceeded,
+    resource_exhausted,
+  };
+
+  /**
+   * @brief Wire code and default message of a built-in error code.
+   */
+  struct ErrorInfo
+  {
+    std::string_view code;
+    std::string_view message;
+  };
+
+  /// Wire code and default message of `c` (empty for `ErrorCode::custom`).
+  constexpr ErrorInfo error_info(ErrorCode c) noexcept
+  {
+    switch (c)
+    {
+    case ErrorCode::parse_error:
+      return {"PARSE_ERROR", "Failed to parse RPC payload"};
+    case ErrorCode::invalid_params:
+      return {"INVALID_PARAMS", "Invalid RPC parameters"};
+    case ErrorCode::method_not_found:
+      return {"METHOD_NOT_FOUND", "RPC method not found"};
+    case ErrorCode::internal_error:
+      return {"INTERNAL_ERROR", "Internal error"};
+    case ErrorCode::overloaded:
+      return {"OVERLOADED", "RPC overloaded"};
+    case ErrorCode::batch_too_large:
+      return {"BATCH_TOO_LARGE", "RPC batch too large"};
+    case ErrorCode::params_too_deep:
+      return {"PARAMS_TOO_DEEP", "RPC params nested too deeply"};
+    case ErrorCode::params_too_large:
+      return {"PARAMS_TOO_LARGE", "RPC params too large"};
+    case ErrorCode::budget_exceeded:
+      return {"BUDGET_EXCEEDED", "Budget exceeded"};
+    case ErrorCode::resource_exhausted:
+      return {"RESOURCE_EXHAUSTED", "RPC memory budget exceeded"};
+    case ErrorCode::custom:
+      break;
+    }
+    return {};
+  }
+
+  /// Built-in code spelled `code`, or `ErrorCode::custom`.
+  constexpr ErrorCode error_code_of(std::string_view code) noexcept
+  {
+    for (std::uint8_t i = 1; i <= static_cast<std::uint8_t>(ErrorCode::resource_exhausted); ++i)
+    {
+      const ErrorCode c = static_cast<ErrorCode>(i);
+      if (error_info(c).code == code)
+        return c;
+    }
+    return ErrorCode::custom;
+  }
+
+  /**
+   * @brief A built-in error that owns nothing.
+   *
+   * @details
+   * Code, message and at most one details member (`{"reason": ...}`,
+   * `{"method": ...}`, `{"limit": ...}`), held as views. Making one never
+   * allocates and `write_json()` writes it straight to output: the dispatcher
+   * answers rejected requests this way. The texts must outlive the view (they are
+   * literals, or point into the request being answered); `BasicRpcError` makes an
+   * owning error out of it.
+   */
+  struct ErrorView
+  {
+    /// Built-in code.
+    ErrorCode code{ErrorCode::custom};
+
+    /// Human-readable message.
+    std::string_view message{};
+
+    /// Name of the details member (empty = no details).
+    std::string_view key{};
+
+    /// Text value of the details member (unless `numeric`).
+    std::string_view text{};
+
+    /// Number value of the details member (if `numeric`).
+    long long number{0};
+
+    bool numeric{false};
+
+    /// `c` with its default message and no details.
+    static constexpr ErrorView of(ErrorCode c) noexcept { return ErrorView{c, error_info(c).message}; }
+
+    /// `c` with details `{key: text}`.
+    static constexpr ErrorView with_text(ErrorCode c, std::string_view key_, std::string_view text_) noexcept
+    {
+      return ErrorView{c, error_info(c).message, key_, text_};
+    }
+
+    /// `c` with details `{key: number}`.
+    static constexpr ErrorView with_number(ErrorCode c, std::string_view key_, long long number_) noexcept
+    {
+      return ErrorView{c, error_info(c).message, key_, {}, number_, true};
+    }
+
+    static constexpr ErrorView method_not_found(std::string_view method) noexcept
+    {
+      return with_text(ErrorCode::method_not_found, "method", method);
+    }
+
+    static constexpr ErrorView invalid_params(std::string_view reason) noexcept
+    {
+      return with_text(ErrorCode::invalid_params, "reason", reason);
+    }
+
+    static constexpr ErrorView parse_error(std::string_view reason) noexcept
+    {
+      return with_text(ErrorCode::parse_error, "reason", reason);
+    }
+
+    static constexpr ErrorView limit(ErrorCode c, std::size_t limit_) noexcept
+    {
+      return with_number(c, "limit", static_cast<long long>(limit_));
+    }
+
+    static constexpr ErrorView internal_error(std::string_view msg) noexcept
+    {
+      return ErrorView{ErrorCode::internal_error, msg};
+    }
+
+    /// True if the error has a details member.
+    constexpr bool has_details() const noexcept { return !key.empty(); }
+
+    /// The details as a JSON value (null without details).
+    vix::json::token details() const
+    {
+      using namespace vix::json;
+
+      if (!has_details())
+        return token(nullptr);
+      if (numeric)
+        return obj({std::string(key), number});
+      return obj({std::string(key), std::string(text)});
+    }
+
+    /**
+     * @brief Append this error as JSON text (same shape as `RpcError::to_json()`).
+     *
+     * @details
+     * Nothing is allocated beyond the growth of `out`.
+     */
+    void write_json(std::string &out) const
+    {
+      out.append("{\"code\":");
+      detail::append_json_string(out, error_info(code).code);
+      out.append(",\"message\":");
+      detail::append_json_string(out, message);
+      if (has_details())
+      {
+        out.append(",\"details\":{");
+        detail::append_json_string(out, key);
+        out.push_back(':');
+        if (numeric)
+          detail::append_json_i64(out, number);
+        else
+          detail::append_json_string(out, text);
+        out.push_back('}');
+      }
+      out.push_back('}');
+    }
+  };
 
   /**
    * @brief Structured error returned by a WebRPC call.
@@ -47,38 +236,100 @@ namespace vix::webrpc
    * - `code` is machine-readable and stable.
    * - `message` is human-readable.
    * - `details` is optional and may contain structured data.
+   *
+   * @par Allocator
+   * `RpcError` is `BasicRpcError<std::allocator<char>>`: `code` and `message` are
+   * `std::string`. `webrpc::pmr::RpcError` takes its text from a memory resource
+   * (`allocator_type`, trailing allocator arguments), and `std::pmr` containers of
+   * them pass theirs down. Moves keep the allocator; copies use the default
+   * resource unless one is given. `details` is a `vix::json` value in both.
+   *
+   * @par Built-in errors
+   * The factories are made from an `ErrorView`; `Dispatcher::write()` writes the
+   * view itself, without building the error. Everywhere else the error is built
+   * in full: `details` is a public field, so the factories build it eagerly.
    */
-  struct RpcError
+  template <typename Allocator = std::allocator<char>>
+  struct BasicRpcError
   {
+    /// Allocator of `code` and `message`.
+    using allocator_type = Allocator;
+
+    /// Type of `code` and `message`.
+    using string_type = std::basic_string<char, std::char_traits<char>, Allocator>;
+
     /// Machine-readable error code (e.g. "METHOD_NOT_FOUND").
-    std::string code{};
+    string_type code{};
 
     /// Human-readable error description.
-    std::string message{};
+    string_type message{};
 
     /// Optional structured details.
     vix::json::token details{nullptr};
 
-    RpcError() = default;
+    BasicRpcError() = default;
+
+    explicit BasicRpcError(const allocator_type &alloc) noexcept
+        : code(alloc), message(alloc)
+    {
+    }
 
-    RpcError(std::string code_, std::string message_)
-        : code(std::move(code_)), message(std::move(message_)), details(nullptr)
+    BasicRpcError(std::string_view code_,
+                  std::string_view message_,
+                  const allocator_type &alloc = {})
+        : code(code_, alloc), message(message_, alloc), details(nullptr)
     {
     }
 
-    RpcError(std::string code_, std::string message_, vix::json::token details_)
-        : code(std::move(code_)),
-          message(std::move(message_)),
+    BasicRpcError(std::string_view code_,
+                  std::string_view message_,
+                  vix::json::token details_,
+                  const allocator_type &alloc = {})
+        : code(code_, alloc),
+          message(message_, alloc),
           details(std::move(details_))
     {
     }
 
+    /// Owning copy of a built-in error (its details object is allocated here).
+    explicit BasicRpcError(const ErrorView &view, const allocator_type &alloc = {})
+        : code(error_info(view.code).code, alloc),
+          message(view.message, alloc),
+          details(view.details())
+    {
+    }
+
+    BasicRpcError(const BasicRpcError &) = default;
+    BasicRpcError(BasicRpcError &&) noexcept = default;
+    BasicRpcError &operator=(const BasicRpcError &) = default;
+    BasicRpcError &operator=(BasicRpcError &&) = default;
+
+    /// Copy into `alloc`.
+    BasicRpcError(const BasicRpcError &other, const allocator_type &alloc)
+        : code(other.code, alloc), message(other.message, alloc), details(other.details)
+    {
+    }
+
+    /// Move into `alloc` (steals the strings when `alloc` compares equal).
+    BasicRpcError(BasicRpcError &&other, const allocator_type &alloc)
+        : code(std::move(other.code), alloc),
+          message(std::move(other.message), alloc),
+          details(std::move(other.details))
+    {
+    }
+
+    /// Allocator of `code` and `message`.
+    allocator_type get_allocator() const noexcept { return code.get_allocator(); }
+
     /// True if this error is valid (non-empty code).
     bool valid() const noexcept { return !code.empty(); }
 
     /// True if this error contains structured details.
     bool has_details() const noexcept { return !details.is_null(); }
 
+    /// Built-in code of this error (`ErrorCode::custom` for any other code).
+    ErrorCode kind() const noexcept { return error_code_of(code); }
+
     /**
      * @brief Convert this error to a JSON object.
      *
@@ -92,17 +343,17 @@ namespace vix::webrpc
       {
         return obj({
             "code",
-            code,
+            std::string(code),
             "message",
-            message,
+            std::string(message),
         });
       }
 
       return obj({
           "code",
-          code,
+          std::string(code),
           "message",
-          message,
+          std::string(message),
           "details",
           details,
       });
@@ -111,74 +362,140 @@ namespace vix::webrpc
     /// Alias for to_json_token().
     vix::json::token to_json() const { return to_json_token(); }
 
+    /**
+     * @brief Append this error as JSON text (same shape as `to_json()`).
+     *
+     * @details
+     * Writes straight into `out`: no token is built, and nothing is allocated
+     * beyond the growth of `out`.
+     */
+    void write_json(std::string &out) const
+    {
+      out.append("{\"code\":");
+      detail::append_json_string(out, code);
+      out.append(",\"message\":");
+      detail::append_json_string(out, message);
+      if (!details.is_null())
+      {
+        out.append(",\"details\":");
+        detail::append_json(out, details);
+      }
+      out.push_back('}');
+    }
+
     /**
      * @brief Parse an RpcError from a JSON token.
      *
-     * @param root JSON token representing an error object.
+     * @param root  JSON token representing an error object.
+     * @param alloc Allocator of the parsed (or failure) error text.
      * @return RpcErrorParseResult describing success or failure.
      */
-    static RpcErrorParseResult parse(const vix::json::token &root);
+    static BasicRpcErrorParseResult<Allocator> parse(const vix::json::token &root,
+                                                     const allocator_type &alloc = {});
 
     /**
-     * @brief Error: RPC method not found.
+     * @brief Error made of a built-in code and its default message.
      */
-    static RpcError method_not_found(std::string_view method)
+    static BasicRpcError of(ErrorCode c, const allocator_type &alloc = {})
     {
-      using namespace vix::json;
+      return BasicRpcError(ErrorView::of(c), alloc);
+    }
 
-      return RpcError{
-          "METHOD_NOT_FOUND",
-          "RPC method not found",
-          obj({
-              "method",
-              std::string(method),
-          }),
-      };
+    /**
+     * @brief Error: RPC method not found.
+     */
+    static BasicRpcError method_not_found(std::string_view method,
+                                          const allocator_type &alloc = {})
+    {
+      return BasicRpcError(ErrorView::method_not_found(method), alloc);
     }
 
     /**
      * @brief Error: invalid parameters.
      */
-    static RpcError invalid_params(std::string_view reason)
+    static BasicRpcError invalid_params(std::string_view reason,
+                                        const allocator_type &alloc = {})
     {
-      using namespace vix::json;
-
-      return RpcError{
-          "INVALID_PARAMS",
-          "Invalid RPC parameters",
-          obj({
-              "reason",
-              std::string(reason),
-          }),
-      };
+      return BasicRpcError(ErrorView::invalid_params(reason), alloc);
     }
 
     /**
      * @brief Error: malformed or invalid RPC payload.
      */
-    static RpcError parse_error(std::string_view reason)
+    static BasicRpcError parse_error(std::string_view reason,
+                                     const allocator_type &alloc = {})
     {
-      using namespace vix::json;
+      return BasicRpcError(ErrorView::parse_error(reason), alloc);
+    }
 
-      return RpcError{
-          "PARSE_ERROR",
-          "Failed to parse RPC payload",
-          obj({
-              "reason",
-              std::string(reason),
-          }),
-      };
+    /**
+     * @brief Error: call rejected by admission control (load shedding).
+     *
+     * @details
+     * Returns a preallocated instance without details; its code and message fit
+     * the inline buffer of a `std::string`, so copying it does not touch the heap.
+     */
+    static const BasicRpcError &overloaded()
+    {
+      static const BasicRpcError err = of(ErrorCode::overloaded);
+      return err;
+    }
+
+    /**
+     * @brief Error: batch larger than `DispatcherLimits::max_batch_items`.
+     */
+    static BasicRpcError batch_too_large(std::size_t limit,
+                                         const allocator_type &alloc = {})
+    {
+      return BasicRpcError(ErrorView::limit(ErrorCode::batch_too_large, limit), alloc);
+    }
+
+    /**
+     * @brief Error: params nested deeper than `DispatcherLimits::max_params_depth`.
+     */
+    static BasicRpcError params_too_deep(std::size_t limit,
+                                         const allocator_type &alloc = {})
+    {
+      return BasicRpcError(ErrorView::limit(ErrorCode::params_too_deep, limit), alloc);
+    }
+
+    /**
+     * @brief Error: params larger than `DispatcherLimits::max_params_bytes`.
+     */
+    static BasicRpcError params_too_large(std::size_t limit,
+                                          const allocator_type &alloc = {})
+    {
+      return BasicRpcError(ErrorView::limit(ErrorCode::params_too_large, limit), alloc);
+    }
+
+    /**
+     * @brief Error: batch item not run because the batch spent its CPU budget.
+     *
+     * @details
+     * Preallocated, like `overloaded()`: a budget cut answers many items at once.
+     */
+    static const BasicRpcError &budget_exceeded()
+    {
+      static const BasicRpcError err = of(ErrorCode::budget_exceeded);
+      return err;
+    }
+
+    /**
+     * @brief Error: call stopped for using more than its memory budget.
+     */
+    static BasicRpcError resource_exhausted(std::size_t limit,
+                                            const allocator_type &alloc = {})
+    {
+      return BasicRpcError(ErrorView::limit(ErrorCode::resource_exhausted, limit), alloc);
     }
 
     /**
      * @brief Error: internal server failure.
      */
-    static RpcError internal_error(std::string_view msg)
+    static BasicRpcError internal_error(std::string_view msg,
+                                        const allocator_type &alloc = {})
     {
-      return RpcError{
-          "INTERNAL_ERROR",
-          std::string(msg),
-      };
+      return BasicRpcError(ErrorView::internal_error(msg), alloc);
     }
   };
 
@@ -189,46 +506,45 @@ namespace vix::webrpc
    * This type avoids `std::variant` to keep the API explicit
    * and to prevent incomplete-type issues during parsing.
    */
-  struct RpcErrorParseResult
+  template <typename Allocator>
+  struct BasicRpcErrorParseResult
   {
     bool ok_{false};
-    RpcError value_{};
-    RpcError error_{};
+    BasicRpcError<Allocator> value_{};
+    BasicRpcError<Allocator> error_{};
 
-    static RpcErrorParseResult ok(RpcError v)
+    // Built by moving, so the errors keep their allocator.
+    static BasicRpcErrorParseResult ok(BasicRpcError<Allocator> v)
     {
-      RpcErrorParseResult r;
-      r.ok_ = true;
-      r.value_ = std::move(v);
-      return r;
+      return BasicRpcErrorParseResult{true, std::move(v), BasicRpcError<Allocator>{}};
     }
 
-    static RpcErrorParseResult fail(RpcError e)
+    static BasicRpcErrorParseResult fail(BasicRpcError<Allocator> e)
     {
-      RpcErrorParseResult r;
-      r.ok_ = false;
-      r.error_ = std::move(e);
-      return r;
+      return BasicRpcErrorParseResult{false, BasicRpcError<Allocator>{}, std::move(e)};
     }
 
     bool ok() const noexcept { return ok_; }
 
     /// Valid only if ok() == true
-    const RpcError &value() const noexcept { return value_; }
-    RpcError &value() noexcept { return value_; }
+    const BasicRpcError<Allocator> &value() const noexcept { return value_; }
+    BasicRpcError<Allocator> &value() noexcept { return value_; }
 
     /// Valid only if ok() == false
-    const RpcError &error() const noexcept { return error_; }
-    RpcError &error() noexcept { return error_; }
+    const BasicRpcError<Allocator> &error() const noexcept { return error_; }
+    BasicRpcError<Allocator> &error() noexcept { return error_; }
   };
 
-  inline RpcErrorParseResult RpcError::parse(const vix::json::token &root)
+  template <typename Allocator>
+  inline BasicRpcErrorParseResult<Allocator> BasicRpcError<Allocator>::parse(const vix::json::token &root,
+                                                                             const allocator_type &alloc)
   {
     using namespace vix::json;
+    using Result = BasicRpcErrorParseResult<Allocator>;
 
     const auto objp = root.as_object_ptr();
     if (!objp)
-      return RpcErrorParseResult::fail(parse_error("error must be an object"));
+      return Result::fail(parse_error("error must be an object", alloc));
 
     const kvs &o = *objp;
 
@@ -236,24 +552,39 @@ namespace vix::webrpc
     const token *msg_t = o.get_ptr("message");
 
     if (!code_t || !msg_t)
-      return RpcErrorParseResult::fail(parse_error("error object must contain code and message"));
+      return Result::fail(parse_error("error object must contain code and message", alloc));
 
-    if (!code_t->is_string() || !msg_t->is_string())
-      return RpcErrorParseResult::fail(parse_error("code and message must be strings"));
+    const std::string *code_s = code_t->as_string();
+    const std::string *msg_s = msg_t->as_string();
+    if (!code_s || !msg_s)
+      return Result::fail(parse_error("code and message must be strings", alloc));
 
-    RpcError out;
-    out.code = code_t->as_string_or("");
-    out.message = msg_t->as_string_or("");
+    if (code_s->empty())
+      return Result::fail(parse_error("code must not be empty", alloc));
 
-    if (out.code.empty())
-      return RpcErrorParseResult::fail(parse_error("code must not be empty"));
+    BasicRpcError out(*code_s, *msg_s, alloc);
 
     if (const token *d = o.get_ptr("details"))
       out.details = *d;
 
-    return RpcErrorParseResult::ok(std::move(out));
+    return Result::ok(std::move(out));
   }
 
+  /// Error with `std::string` text: the error of `RpcResult` and of handlers.
+  using RpcError = BasicRpcError<>;
+
+  /// Result of `RpcError::parse()`.
+  using RpcErrorParseResult = BasicRpcErrorParseResult<std::allocator<char>>;
+
+  namespace pmr
+  {
+    /// Error whose text comes from a `std::pmr::memory_resource`.
+    using RpcError = BasicRpcError<std::pmr::polymorphic_allocator<char>>;
+
+    /// Result of `pmr::RpcError::parse()`.
+    using RpcErrorParseResult = BasicRpcErrorParseResult<std::pmr::polymorphic_allocator<char>>;
+  } // namespace pmr
+
 } // namespace vix::webrpc
 
 #endif // VIX_WEBRPC_ERROR_HPP
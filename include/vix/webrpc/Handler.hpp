@@ -0,0 +1,65 @@
+/**
+ *
+ *  @file Handler.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_HANDLER_HPP
+#define VIX_WEBRPC_HANDLER_HPP
+
+#include <functional>
+#include <span>
+#include <variant>
+
+#include <vix/json/Simple.hpp>
+
+#include <vix/webrpc/Context.hpp>
+#include <vix/webrpc/Error.hpp>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief Result of an RPC handler.
+   *
+   * @details
+   * Handlers return either:
+   * - a JSON-like token (success payload)
+   * - or a structured RpcError (failure)
+   *
+   * This keeps control flow explicit and exception-free.
+   */
+  using RpcResult = std::variant<vix::json::token, RpcError>;
+
+  /**
+   * @brief RPC method handler signature.
+   *
+   * @details
+   * A handler receives an execution Context and returns an RpcResult.
+   * Handlers should validate their own input schema (params shape and types).
+   */
+  using RpcHandler = std::function<RpcResult(const Context &)>;
+
+  /**
+   * @brief Vectorized handler signature.
+   *
+   * @details
+   * Receives every call of one method found in a batch and writes one result per
+   * call, at the same index (`results.size() == calls.size()`). Lets a handler serve
+   * N calls with one round trip to its storage (multi-get, `IN (...)` query).
+   * Slots left untouched answer with a null result.
+   */
+  using RpcBatchHandler = std::function<void(std::span<const Context> calls,
+                                             std::span<RpcResult> results)>;
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_HANDLER_HPP
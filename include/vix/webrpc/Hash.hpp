@@ -0,0 +1,334 @@
+/**
+ *
+ *  @file Hash.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_HASH_HPP
+#define VIX_WEBRPC_HASH_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <vix/json/Simple.hpp>
+
+namespace vix::webrpc
+{
+  namespace detail
+  {
+    /**
+     * @brief Visit the members of an object as (key, value) pairs.
+     *
+     * @details
+     * Single place that knows how `vix::json::kvs` stores its members
+     * (flat key/value sequence).
+     */
+    template <typename Fn>
+    inline void for_each_member(const vix::json::kvs &o, Fn &&fn)
+    {
+      const auto &flat = o.flat;
+      for (std::size_t i = 0; i + 1 < flat.size(); i += 2)
+      {
+        const std::string *k = flat[i].as_string();
+        fn(k ? std::string_view(*k) : std::string_view{}, flat[i + 1]);
+      }
+    }
+
+    /**
+     * @brief First member named `key`, or null.
+     *
+     * @details
+     * Mutable through a mutable object (`vix::json::token *`), read-only through
+     * a const one, so a consuming parse can move the value out.
+     */
+    template <typename Object>
+      requires std::same_as<std::remove_const_t<Object>, vix::json::kvs>
+    inline auto find_member(Object &o, std::string_view key) noexcept
+    {
+      auto &flat = o.flat;
+      for (std::size_t i = 0; i + 1 < flat.size(); i += 2)
+      {
+        const std::string *k = flat[i].as_string();
+        if (k && *k == key)
+          return &flat[i + 1];
+      }
+      return static_cast<decltype(&flat[0])>(nullptr);
+    }
+
+    /// Number of members of an object.
+    inline std::size_t member_count(const vix::json::kvs &o) noexcept
+    {
+      return o.flat.size() / 2;
+    }
+
+    inline constexpr std::uint64_t hash_k0 = 0xa0761d6478bd642fULL;
+    inline constexpr std::uint64_t hash_k1 = 0xe7037ed1a0b428dbULL;
+    inline constexpr std::uint64_t hash_k2 = 0x8ebc6af09c88c6e3ULL;
+    inline constexpr std::uint64_t hash_k3 = 0x589965cc75374cc3ULL;
+
+    // Type tags, so that 1, 1.0, "1" and [1] never share a hash.
+    inline constexpr std::uint64_t tag_null = 0x01;
+    inline constexpr std::uint64_t tag_false = 0x02;
+    inline constexpr std::uint64_t tag_true = 0x03;
+    inline constexpr std::uint64_t tag_i64 = 0x04;
+    inline constexpr std::uint64_t tag_f64 = 0x05;
+    inline constexpr std::uint64_t tag_string = 0x06;
+    inline constexpr std::uint64_t tag_array = 0x07;
+    inline constexpr std::uint64_t tag_object = 0x08;
+
+    /// 64x64 -> 128 multiply from 32-bit halves: low word returned, high word in `hi`.
+    inline std::uint64_t mul128_portable(std::uint64_t a, std::uint64_t b, std::uint64_t &hi) noexcept
+    {
+      const std::uint64_t a_lo = a & 0xffffffffULL, a_hi = a >> 32;
+      const std::uint64_t b_lo = b & 0xffffffffULL, b_hi = b >> 32;
+
+      const std::uint64_t ll = a_lo * b_lo;
+      const std::uint64_t lh = a_lo * b_hi;
+      const std::uint64_t hl = a_hi * b_lo;
+      const std::uint64_t hh = a_hi * b_hi;
+
+      // Cannot overflow: at most (2^32 - 1) * (2^32 + 1) = 2^64 - 1.
+      const std::uint64_t cross = (ll >> 32) + (lh & 0xffffffffULL) + hl;
+      hi = hh + (lh >> 32) + (cross >> 32);
+      return (cross << 32) | (ll & 0xffffffffULL);
+    }
+
+    /// 64x64 -> 128 multiply, folded to 64 bits.
+    inline std::uint64_t mum(std::uint64_t a, std::uint64_t b) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+      __extension__ using u128 = unsigned __int128;
+      const u128 r = static_cast<u128>(a) * b;
+      return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+#else
+      std::uint64_t hi = 0;
+      const std::uint64_t lo = mul128_portable(a, b, hi);
+      return lo ^ hi;
+#endif
+    }
+
+    /// Final avalanche (splitmix64 finalizer).
+    inline std::uint64_t mix(std::uint64_t h) noexcept
+    {
+      h ^= h >> 30;
+      h *= 0xbf58476d1ce4e5b9ULL;
+      h ^= h >> 27;
+      h *= 0x94d049bb133111ebULL;
+      h ^= h >> 31;
+      return h;
+    }
+
+    inline std::uint64_t load64(const unsigned char *p) noexcept
+    {
+      std::uint64_t v;
+      std::memcpy(&v, p, sizeof(v));
+      return v;
+    }
+
+    /**
+     * @brief Hash a byte range, 32 then 8 bytes per step.
+     *
+     * @details
+     * Four independent multiply lanes consume 32-byte blocks, a single lane the
+     * remaining 8-byte words, and the tail is loaded as one partial word. Values are
+     * native-endian: hashes are meant for in-process tables, not for persistence.
+     */
+    inline std::uint64_t hash_bytes(const void *data, std::size_t n, std::uint64_t seed) noexcept
+    {
+      const auto *p = static_cast<const unsigned char *>(data);
+      std::uint64_t h = seed ^ mum(n ^ hash_k0, hash_k1);
+
+      if (n >= 32)
+      {
+        std::uint64_t a = h, b = h ^ hash_k1, c = h ^ hash_k2, d = h ^ hash_k3;
+        do
+        {
+          a = mum(load64(p) ^ hash_k0, a ^ hash_k1);
+          b = mum(load64(p + 8) ^ hash_k1, b ^ hash_k2);
+          c = mum(load64(p + 16) ^ hash_k2, c ^ hash_k3);
+          d = mum(load64(p + 24) ^ hash_k3, d ^ hash_k0);
+          p += 32;
+          n -= 32;
+        } while (n >= 32);
+        h = a ^ b ^ c ^ d;
+      }
+
+      while (n >= 8)
+      {
+        h = mum(load64(p) ^ hash_k1, h ^ hash_k2);
+        p += 8;
+        n -= 8;
+      }
+
+      if (n > 0)
+      {
+        std::uint64_t tail = 0;
+        std::memcpy(&tail, p, n);
+        h = mum(tail ^ hash_k3, h ^ (n * hash_k0));
+      }
+
+      return mix(h);
+    }
+
+    inline std::uint64_t hash_tagged(std::uint64_t tag, std::uint64_t v) noexcept
+    {
+      return mix(mum(v ^ hash_k0, tag ^ hash_k2));
+    }
+
+  } // namespace detail
+
+  /**
+   * @brief Canonical structural hash of a JSON token tree.
+   *
+   * @details
+   * - object key order is ignored: members are hashed as (key, value) pairs and
+   *   combined with a commutative sum, so `{"a":1,"b":2}` and `{"b":2,"a":1}` collide
+   * - array order matters
+   * - scalars are tagged by type (`1`, `1.0`, `"1"` and `true` differ); `-0.0`
+   *   hashes like `0.0`
+   *
+   * One pass over the tree, no serialization, no allocation. Consistent with
+   * `equal()`: equal trees always have the same hash.
+   */
+  inline std::uint64_t params_hash(const vix::json::token &t) noexcept
+  {
+    using namespace detail;
+
+    if (t.is_null())
+      return hash_tagged(tag_null, 0);
+
+    if (t.is_bool())
+      return hash_tagged(t.as_bool_or(false) ? tag_true : tag_false, 0);
+
+    if (t.is_i64())
+      return hash_tagged(tag_i64, static_cast<std::uint64_t>(t.as_i64_or(0)));
+
+    if (t.is_f64())
+    {
+      double v = t.as_f64_or(0.0);
+      if (v == 0.0)
+        v = 0.0; // -0.0 == 0.0
+      std::uint64_t bits;
+      std::memcpy(&bits, &v, sizeof(bits));
+      return hash_tagged(tag_f64, bits);
+    }
+
+    if (const std::string *s = t.as_string())
+      return hash_bytes(s->data(), s->size(), tag_string);
+
+    if (const auto ap = t.as_array_ptr())
+    {
+      std::uint64_t h = hash_tagged(tag_array, ap->elems.size());
+      for (const vix::json::token &e : ap->elems)
+        h = mum(h ^ hash_k1, params_hash(e) ^ hash_k3);
+      return mix(h);
+    }
+
+    if (const auto op = t.as_object_ptr())
+    {
+      std::uint64_t sum = 0;
+      for_each_member(*op, [&](std::string_view k, const vix::json::token &v)
+                      { sum += mum(hash_bytes(k.data(), k.size(), tag_object) ^ hash_k1,
+                                   params_hash(v) ^ hash_k2); });
+      return hash_tagged(tag_object ^ (member_count(*op) << 8), sum);
+    }
+
+    return 0;
+  }
+
+  /**
+   * @brief Structural equality of two token trees (object key order ignored).
+   *
+   * @details
+   * Exits at the first difference: type, size, then value. Objects built by the
+   * same producer usually share key order, so members are first compared position
+   * by position and only fall back to a key lookup when the orders diverge.
+   */
+  inline bool equal(const vix::json::token &a, const vix::json::token &b) noexcept
+  {
+    if (a.is_null() || b.is_null())
+      return a.is_null() && b.is_null();
+
+    if (a.is_bool() || b.is_bool())
+      return a.is_bool() && b.is_bool() && a.as_bool_or(false) == b.as_bool_or(false);
+
+    if (a.is_i64() || b.is_i64())
+      return a.is_i64() && b.is_i64() && a.as_i64_or(0) == b.as_i64_or(0);
+
+    if (a.is_f64() || b.is_f64())
+      return a.is_f64() && b.is_f64() && a.as_f64_or(0.0) == b.as_f64_or(0.0);
+
+    const std::string *as = a.as_string();
+    const std::string *bs = b.as_string();
+    if (as || bs)
+      return as && bs && *as == *bs;
+
+    const auto aa = a.as_array_ptr();
+    const auto ba = b.as_array_ptr();
+    if (aa || ba)
+    {
+      if (!aa || !ba || aa->elems.size() != ba->elems.size())
+        return false;
+      if (aa == ba)
+        return true;
+      for (std::size_t i = 0; i < aa->elems.size(); ++i)
+      {
+        if (!equal(aa->elems[i], ba->elems[i]))
+          return false;
+      }
+      return true;
+    }
+
+    const auto ao = a.as_object_ptr();
+    const auto bo = b.as_object_ptr();
+    if (!ao || !bo || detail::member_count(*ao) != detail::member_count(*bo))
+      return false;
+    if (ao == bo)
+      return true;
+
+    const auto &af = ao->flat;
+    const auto &bf = bo->flat;
+    for (std::size_t i = 0; i + 1 < af.size(); i += 2)
+    {
+      const std::string *ak = af[i].as_string();
+      if (!ak)
+        return false;
+
+      const vix::json::token *other = nullptr;
+      const std::string *bk = bf[i].as_string();
+      if (bk && *bk == *ak)
+        other = &bf[i + 1];
+      else
+        other = bo->get_ptr(*ak);
+
+      if (!other || !equal(af[i + 1], *other))
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Key of a call: method name combined with the structural hash of its params.
+   */
+  inline std::uint64_t call_hash(std::string_view method, const vix::json::token &params) noexcept
+  {
+    return detail::mix(params_hash(params) ^ detail::hash_bytes(method.data(), method.size(), detail::hash_k2));
+  }
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_HASH_HPP
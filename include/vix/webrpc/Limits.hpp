@@ -0,0 +1,250 @@
+/**
+ *
+ *  @file Limits.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_LIMITS_HPP
+#define VIX_WEBRPC_LIMITS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#endif
+
+#include <vix/json/Simple.hpp>
+
+#include <vix/webrpc/Hash.hpp>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief Input size limits of a dispatcher (0 = unlimited).
+   *
+   * @details
+   * Checked before any work is done on the offending input:
+   * - `max_batch_items`: before a batch item is parsed
+   * - `max_params_depth`, `max_params_bytes`: while the envelope is parsed, with a
+   *   walk that stops as soon as a limit is crossed (its cost is bounded by the limit,
+   *   not by the input)
+   * - `batch_cpu_budget`: between batch items; items not started when the budget is
+   *   spent are answered without running
+   */
+  struct DispatcherLimits
+  {
+    /// Largest accepted batch (items).
+    std::size_t max_batch_items{0};
+
+    /// Deepest accepted params nesting (a scalar has depth 0, `{"a": 1}` depth 1).
+    std::size_t max_params_depth{0};
+
+    /// Largest accepted params, as estimated JSON text size in bytes.
+    std::size_t max_params_bytes{0};
+
+    /// CPU time one batch may use, summed over its items (thread CPU time).
+    std::chrono::microseconds batch_cpu_budget{0};
+
+    /**
+     * @brief Memory one call may use, in bytes (see `MemoryBudget`).
+     *
+     * @details
+     * Charged with what the handler allocates through `Context::memory()`, then
+     * with its result at estimated JSON size. A call crossing it is answered
+     * `RESOURCE_EXHAUSTED`. `MethodOptions::memory_budget` overrides it per method.
+     *
+     * Only `Context::memory()` allocations are refused before they happen. The
+     * result is built by `vix::json` on the global heap and charged after the
+     * handler returned, so an oversized result is fully allocated before the
+     * call is refused.
+     */
+    std::size_t max_request_memory{0};
+  };
+
+  /**
+   * @brief Outcome of `check_params()`.
+   */
+  enum class ParamsCheck : std::uint8_t
+  {
+    ok,
+    too_deep,
+    too_large,
+  };
+
+  namespace detail
+  {
+    /// Digits (and sign) of an integer in JSON text.
+    inline std::size_t i64_text_size(long long v) noexcept
+    {
+      std::size_t n = v < 0 ? 2 : 1;
+      unsigned long long u = v < 0 ? 0ULL - static_cast<unsigned long long>(v)
+                                   : static_cast<unsigned long long>(v);
+      while (u >= 10)
+      {
+        u /= 10;
+        ++n;
+      }
+      return n;
+    }
+
+    /**
+     * @brief Bounded walk behind `check_params()`.
+     *
+     * @details
+     * Adds the estimated text size of `t` to `bytes`: exact for structure, keys,
+     * integers and unescaped strings, 24 bytes for a double. Returns at the first
+     * crossed limit without visiting the rest.
+     */
+    inline ParamsCheck measure(const vix::json::token &t,
+                               std::size_t depth,
+                               const DispatcherLimits &limits,
+                               std::size_t &bytes) noexcept
+    {
+      const std::size_t max_bytes = limits.max_params_bytes;
+      auto add = [&](std::size_t n) noexcept
+      {
+        bytes += n;
+        return max_bytes == 0 || bytes <= max_bytes;
+      };
+
+      if (t.is_null() || t.is_bool())
+        return add(5) ? ParamsCheck::ok : ParamsCheck::too_large;
+
+      if (t.is_i64())
+        return add(i64_text_size(t.as_i64_or(0))) ? ParamsCheck::ok : ParamsCheck::too_large;
+
+      if (t.is_f64())
+        return add(24) ? ParamsCheck::ok : ParamsCheck::too_large;
+
+      if (const std::string *s = t.as_string())
+        return add(s->size() + 2) ? ParamsCheck::ok : ParamsCheck::too_large;
+
+      if (limits.max_params_depth != 0 && depth + 1 > limits.max_params_depth)
+        return ParamsCheck::too_deep;
+
+      if (!add(2))
+        return ParamsCheck::too_large;
+
+      if (const auto ap = t.as_array_ptr())
+      {
+        for (const auto &e : ap->elems)
+        {
+          if (!add(1))
+            return ParamsCheck::too_large;
+          if (const ParamsCheck r = measure(e, depth + 1, limits, bytes); r != ParamsCheck::ok)
+            return r;
+        }
+        return ParamsCheck::ok;
+      }
+
+      if (const auto op = t.as_object_ptr())
+      {
+        ParamsCheck r = ParamsCheck::ok;
+        for_each_member(*op, [&](std::string_view k, const vix::json::token &v)
+                        {
+                          if (r != ParamsCheck::ok)
+                            return;
+                          if (!add(k.size() + 4))
+                            r = ParamsCheck::too_large;
+                          else
+                            r = measure(v, depth + 1, limits, bytes); });
+        return r;
+      }
+
+      return ParamsCheck::ok;
+    }
+
+    /// CPU time consumed by the calling thread (monotonic clock where unavailable).
+    inline std::chrono::nanoseconds thread_cpu_time() noexcept
+    {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+      timespec ts{};
+      if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+        return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+#endif
+      return std::chrono::steady_clock::now().time_since_epoch();
+    }
+  } // namespace detail
+
+  /**
+   * @brief Check params against the depth and size limits.
+   *
+   * @return `ok`, or the first limit crossed. Free when both limits are 0.
+   */
+  inline ParamsCheck check_params(const vix::json::token &params,
+                                  const DispatcherLimits &limits) noexcept
+  {
+    if (limits.max_params_depth == 0 && limits.max_params_bytes == 0)
+      return ParamsCheck::ok;
+
+    std::size_t bytes = 0;
+    return detail::measure(params, 0, limits, bytes);
+  }
+
+  /**
+   * @brief CPU budget shared by the items of one batch.
+   *
+   * @details
+   * Items charge the thread CPU time they used; once the total reaches the budget,
+   * `exhausted()` turns true. Safe to share between the threads running the items.
+   */
+  class BatchBudget
+  {
+  public:
+    explicit BatchBudget(std::chrono::microseconds budget) noexcept
+        : budget_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(budget).count())
+    {
+    }
+
+    /// True if a budget is set.
+    bool enabled() const noexcept { return budget_ns_ > 0; }
+
+    /// True once the items charged at least the budget.
+    bool exhausted() const noexcept
+    {
+      return enabled() && spent_ns_.load(std::memory_order_relaxed) >= budget_ns_;
+    }
+
+    /// Run `fn` and charge its thread CPU time (no clock read without a budget).
+    template <typename Fn>
+    decltype(auto) charge(Fn &&fn)
+    {
+      if (!enabled())
+        return fn();
+
+      struct Meter
+      {
+        BatchBudget &budget;
+        std::chrono::nanoseconds start{detail::thread_cpu_time()};
+
+        ~Meter()
+        {
+          budget.spent_ns_.fetch_add((detail::thread_cpu_time() - start).count(),
+                                     std::memory_order_relaxed);
+        }
+      } meter{*this};
+
+      return fn();
+    }
+
+  private:
+    std::int64_t budget_ns_{0};
+    std::atomic<std::int64_t> spent_ns_{0};
+  };
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_LIMITS_HPP
@@ -0,0 +1,185 @@
+/**
+ *
+ *  @file MemoryBudget.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_MEMORY_BUDGET_HPP
+#define VIX_WEBRPC_MEMORY_BUDGET_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief Thrown by `MemoryBudget` when an allocation would cross its limit.
+   *
+   * @details
+   * A `std::bad_alloc`, as the `memory_resource` contract requires. The dispatcher
+   * catches it around the handler and answers `RESOURCE_EXHAUSTED`; code that
+   * handles `std::bad_alloc` itself sees an ordinary allocation failure.
+   */
+  class MemoryBudgetExceeded final : public std::bad_alloc
+  {
+  public:
+    const char *what() const noexcept override { return "webrpc: request memory budget exceeded"; }
+  };
+
+  /**
+   * @brief Memory resource charging every allocation of one request against a limit.
+   *
+   * @details
+   * Forwards to `upstream` (the request arena, or the default resource) and counts
+   * the bytes requested. Freed bytes are not given back to the budget: an arena
+   * does not reuse them either, and growing containers are charged for each step.
+   * Once an allocation would bring the total over `limit`, it throws
+   * `MemoryBudgetExceeded` without touching `upstream`.
+   *
+   * It only sees what is allocated through it. Memory taken from the global heap,
+   * including the `vix::json` result tree a handler returns, is not stopped: the
+   * dispatcher charges the result after the fact (`charge()`), once it exists.
+   *
+   * Lives on the stack for the duration of one call; not thread-safe, like the
+   * arenas it wraps.
+   */
+  class MemoryBudget final : public std::pmr::memory_resource
+  {
+  public:
+    /**
+     * @param limit    Bytes the request may use (0 = count only, never throw).
+     * @param upstream Where memory comes from (null = default resource).
+     */
+    explicit MemoryBudget(std::size_t limit,
+                          std::pmr::memory_resource *upstream = nullptr) noexcept
+        : upstream_(upstream ? upstream : std::pmr::get_default_resource()), limit_(limit)
+    {
+    }
+
+    MemoryBudget(const MemoryBudget &) = delete;
+    MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+    /// Bytes charged so far.
+    std::size_t used() const noexcept { return used_; }
+
+    std::size_t limit() const noexcept { return limit_; }
+
+    /// Bytes left before the limit (unbounded when counting only).
+    std::size_t remaining() const noexcept
+    {
+      if (limit_ == 0)
+        return static_cast<std::size_t>(-1);
+      return used_ < limit_ ? limit_ - used_ : 0;
+    }
+
+    /// True once an allocation or a `charge()` was refused.
+    bool exhausted() const noexcept { return exhausted_; }
+
+    /**
+     * @brief Charge memory allocated elsewhere (e.g. a result tree built by `vix::json`).
+     *
+     * @return `false` (and `exhausted()`) if it does not fit; nothing is charged then.
+     */
+    bool charge(std::size_t bytes) noexcept
+    {
+      if (bytes > remaining())
+      {
+        exhausted_ = true;
+        return false;
+      }
+      used_ += bytes;
+      return true;
+    }
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      if (!charge(bytes))
+        throw MemoryBudgetExceeded();
+      return upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override
+    {
+      upstream_->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+      return this == &other;
+    }
+
+    std::pmr::memory_resource *upstream_;
+    std::size_t limit_;
+    std::size_t used_{0};
+    bool exhausted_{false};
+  };
+
+  /**
+   * @brief Memory used by the calls of one method.
+   */
+  struct MemoryUsageStats
+  {
+    /// Calls measured.
+    std::uint64_t calls{0};
+
+    /// Calls answered `RESOURCE_EXHAUSTED`.
+    std::uint64_t exhausted{0};
+
+    /// Largest amount one call used (a refused call counts up to its limit).
+    std::size_t high_water{0};
+  };
+
+  /**
+   * @brief Per-method memory high-water mark (see `Dispatcher::memory_usage()`).
+   *
+   * @details
+   * Updated by every measured call of the method, from any thread.
+   */
+  class MemoryUsage
+  {
+  public:
+    /// Record one call that used `bytes`.
+    void record(std::size_t bytes, bool exhausted) noexcept
+    {
+      calls_.fetch_add(1, std::memory_order_relaxed);
+      if (exhausted)
+        exhausted_.fetch_add(1, std::memory_order_relaxed);
+
+      std::size_t seen = high_water_.load(std::memory_order_relaxed);
+      while (bytes > seen &&
+             !high_water_.compare_exchange_weak(seen, bytes, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    MemoryUsageStats stats() const noexcept
+    {
+      MemoryUsageStats s;
+      s.calls = calls_.load(std::memory_order_relaxed);
+      s.exhausted = exhausted_.load(std::memory_order_relaxed);
+      s.high_water = high_water_.load(std::memory_order_relaxed);
+      return s;
+    }
+
+  private:
+    std::atomic<std::uint64_t> calls_{0};
+    std::atomic<std::uint64_t> exhausted_{0};
+    std::atomic<std::size_t> high_water_{0};
+  };
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_MEMORY_BUDGET_HPP
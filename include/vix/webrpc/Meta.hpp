@@ -0,0 +1,215 @@
+/**
+ *
+ *  @file Meta.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_META_HPP
+#define VIX_WEBRPC_META_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief Well-known metadata keys, indexed by `MetaView` as entries are added.
+   */
+  enum class MetaKey : std::uint8_t
+  {
+    trace_id,
+    tenant,
+    authorization,
+    deadline,
+  };
+
+  /// Number of `MetaKey` values.
+  inline constexpr std::size_t meta_key_count = 4;
+
+  /// Wire name of a well-known key (lowercase, as transports should pass it).
+  constexpr std::string_view meta_key_name(MetaKey k) noexcept
+  {
+    switch (k)
+    {
+    case MetaKey::trace_id:
+      return "trace-id";
+    case MetaKey::tenant:
+      return "tenant";
+    case MetaKey::authorization:
+      return "authorization";
+    case MetaKey::deadline:
+      return "deadline";
+    }
+    return {};
+  }
+
+  /**
+   * @brief Flat, non-owning request metadata (e.g. headers, peer id, tracing ids).
+   *
+   * @details
+   * An array of `string_view` key/value pairs pointing into storage owned by
+   * the transport (typically its header buffer), which must outlive every
+   * `Context` built over the view. Up to `capacity` entries are held inline and
+   * building the view does not allocate; past that, the entries move to the
+   * heap once and the view keeps growing. No entry is ever dropped.
+   *
+   * Lookup by name is a linear scan (length compared first), cheaper than hashing
+   * for the handful of entries a request carries. The keys of `MetaKey` are
+   * indexed when added and read in O(1). Keys are compared byte for byte: the
+   * transport normalizes case. When a key repeats, the first entry wins.
+   *
+   * @code
+   * MetaView meta;
+   * meta.add("tenant", tenant_header);       // views into the request buffer
+   * meta.add("trace-id", trace_header);
+   * dispatcher.handle(payload, "http", &meta);
+   *
+   * // in a handler
+   * std::string_view tenant = ctx.meta_value(MetaKey::tenant);
+   * @endcode
+   */
+  class MetaView
+  {
+  public:
+    /// One key/value pair.
+    using Entry = std::pair<std::string_view, std::string_view>;
+
+    /// Entries held inline (without allocating).
+    static constexpr std::size_t capacity = 16;
+
+    MetaView() noexcept { index_.fill(none); }
+
+    /// Entries viewing `entries` (string literals, or storage that outlives the view).
+    MetaView(std::initializer_list<Entry> entries) : MetaView()
+    {
+      for (const Entry &e : entries)
+        add(e.first, e.second);
+    }
+
+    /// View over a map of strings (the map must outlive the view).
+    template <typename Map>
+    static MetaView of(const Map &map)
+    {
+      MetaView v;
+      for (const auto &[k, value] : map)
+        v.add(k, value);
+      return v;
+    }
+
+    /**
+     * @brief Append an entry.
+     *
+     * @details
+     * Does not allocate while the view holds fewer than `capacity` entries. The
+     * entry that overflows the inline array moves every entry to the heap, where
+     * the view keeps growing (`std::bad_alloc` if that allocation fails).
+     */
+    void add(std::string_view key, std::string_view value)
+    {
+      for (std::size_t k = 0; k < meta_key_count; ++k)
+      {
+        if (index_[k] == none && key == meta_key_name(static_cast<MetaKey>(k)))
+        {
+          index_[k] = static_cast<std::uint32_t>(size_);
+          break;
+        }
+      }
+
+      if (spill_.empty() && size_ < capacity)
+      {
+        entries_[size_++] = Entry{key, value};
+        return;
+      }
+
+      if (spill_.empty())
+      {
+        spill_.reserve(capacity * 2);
+        spill_.assign(entries_.begin(), entries_.end());
+      }
+      spill_.emplace_back(key, value);
+      ++size_;
+    }
+
+    /// Entry named `key`, or null.
+    const Entry *find(std::string_view key) const noexcept
+    {
+      for (const Entry &e : *this)
+      {
+        if (e.first == key)
+          return &e;
+      }
+      return nullptr;
+    }
+
+    /// Entry of a well-known key, or null (O(1)).
+    const Entry *find(MetaKey key) const noexcept
+    {
+      const std::uint32_t i = index_[static_cast<std::size_t>(key)];
+      return i == none ? nullptr : data() + i;
+    }
+
+    /// Value of `key`, or empty.
+    std::string_view get(std::string_view key) const noexcept
+    {
+      const Entry *e = find(key);
+      return e ? e->second : std::string_view{};
+    }
+
+    /// Value of a well-known key, or empty (O(1)).
+    std::string_view get(MetaKey key) const noexcept
+    {
+      const Entry *e = find(key);
+      return e ? e->second : std::string_view{};
+    }
+
+    bool contains(std::string_view key) const noexcept { return find(key) != nullptr; }
+    bool contains(MetaKey key) const noexcept { return find(key) != nullptr; }
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    /// True once the entries outgrew the inline array (and live on the heap).
+    bool spilled() const noexcept { return !spill_.empty(); }
+
+    const Entry *begin() const noexcept { return data(); }
+    const Entry *end() const noexcept { return data() + size_; }
+
+    /// Remove every entry (heap storage, if any, is kept for reuse).
+    void clear() noexcept
+    {
+      spill_.clear();
+      size_ = 0;
+      index_.fill(none);
+    }
+
+  private:
+    static constexpr std::uint32_t none = 0xffffffff;
+
+    const Entry *data() const noexcept
+    {
+      return spill_.empty() ? entries_.data() : spill_.data();
+    }
+
+    std::array<Entry, capacity> entries_{};
+    std::vector<Entry> spill_{};
+    std::size_t size_{0};
+    std::array<std::uint32_t, meta_key_count> index_{};
+  };
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_META_HPP
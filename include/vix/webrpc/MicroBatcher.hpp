@@ -0,0 +1,272 @@
+/**
+ *
+ *  @file MicroBatcher.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_MICRO_BATCHER_HPP
+#define VIX_WEBRPC_MICRO_BATCHER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <vix/webrpc/Context.hpp>
+#include <vix/webrpc/Handler.hpp>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief Configuration of server-side micro-batching for one method.
+   *
+   * @details
+   * Only effective for methods registered with `Router::add_batch()`.
+   */
+  struct MicroBatchOptions
+  {
+    /// Gather concurrent single calls into batch handler invocations.
+    bool enabled{false};
+
+    /// Largest number of calls passed to one batch handler invocation.
+    std::size_t max_batch{64};
+
+    /// Upper bound of the gather window (the window itself adapts to load).
+    std::chrono::microseconds max_delay{200};
+
+    /// Batch handler invocations allowed to run at the same time.
+    std::size_t concurrency{1};
+  };
+
+  /**
+   * @brief Counters of a micro-batcher.
+   */
+  struct MicroBatchStats
+  {
+    std::uint64_t calls{0};
+    std::uint64_t batches{0};
+    std::size_t largest_batch{0};
+
+    /// Current gather window, in microseconds (0 when idle).
+    std::uint64_t window_us{0};
+  };
+
+  /**
+   * @brief Gathers concurrent single calls of one method into batch invocations.
+   *
+   * @details
+   * Leader / follower scheme (group commit):
+   * - a call arriving while fewer than `concurrency` batches run becomes a leader
+   * - other calls queue up and sleep; when a batch completes, every member is woken
+   *   with its own result and the oldest queued call is promoted to leader
+   * - a leader takes itself plus up to `max_batch - 1` queued calls
+   *
+   * Batches therefore grow with load on their own: the number of calls gathered is
+   * roughly the arrival rate times the handler time. On top of that, a leader may
+   * wait for more calls during a short window. The window doubles (up to `max_delay`)
+   * after a batch of several calls and halves after a lone call, so an idle method
+   * answers without any added delay.
+   */
+  class MicroBatcher
+  {
+  public:
+    explicit MicroBatcher(const MicroBatchOptions &options) noexcept
+        : options_(sanitize(options))
+    {
+    }
+
+    MicroBatcher(const MicroBatcher &) = delete;
+    MicroBatcher &operator=(const MicroBatcher &) = delete;
+
+    /**
+     * @brief Run one call, possibly as part of a batch with concurrent calls.
+     *
+     * @param ctx     Call context (must stay valid until this returns).
+     * @param handler Batch handler of the method.
+     * @return The result written by the handler for this call.
+     */
+    RpcResult call(const Context &ctx, const RpcBatchHandler &handler)
+    {
+      Pending me{&ctx};
+
+      std::unique_lock<std::mutex> lock(mu_);
+      ++calls_;
+
+      if (running_ < options_.concurrency)
+      {
+        ++running_;
+      }
+      else
+      {
+        queue_.push_back(&me);
+        if (queue_.size() + 1 >= options_.max_batch)
+          gather_.notify_one();
+
+        me.cv.wait(lock, [&]
+                   { return me.done || me.leader; });
+        if (me.done)
+          return std::move(me.out);
+      }
+
+      if (window_.count() > 0 && queue_.size() + 1 < options_.max_batch)
+      {
+        gather_.wait_for(lock, window_, [&]
+                         { return queue_.size() + 1 >= options_.max_batch; });
+      }
+
+      Flush flush{*this, lock};
+      flush.group.reserve(std::min(queue_.size() + 1, options_.max_batch));
+      flush.group.push_back(&me);
+      while (!queue_.empty() && flush.group.size() < options_.max_batch)
+      {
+        flush.group.push_back(queue_.front());
+        queue_.pop_front();
+      }
+
+      lock.unlock();
+
+      std::vector<Context> calls;
+      calls.reserve(flush.group.size());
+      for (const Pending *p : flush.group)
+        calls.push_back(*p->ctx);
+
+      flush.results.resize(flush.group.size());
+      handler(std::span<const Context>(calls), std::span<RpcResult>(flush.results));
+
+      lock.lock();
+      flush.complete();
+      return std::move(me.out);
+    }
+
+    /// Counters and current window.
+    MicroBatchStats stats() const
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+
+      MicroBatchStats s;
+      s.calls = calls_;
+      s.batches = batches_;
+      s.largest_batch = largest_;
+      s.window_us = static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(window_).count());
+      return s;
+    }
+
+  private:
+    struct Pending
+    {
+      const Context *ctx{nullptr};
+      RpcResult out{};
+      bool done{false};
+      bool leader{false};
+      std::condition_variable cv{};
+    };
+
+    /**
+     * @brief One batch being run by a leader.
+     *
+     * @details
+     * `complete()` hands results out, adapts the window and promotes the next leader.
+     * It also runs from the destructor (with the lock re-acquired) if the handler
+     * unwinds, so followers are never left waiting.
+     */
+    struct Flush
+    {
+      MicroBatcher &owner;
+      std::unique_lock<std::mutex> &lock;
+      std::vector<Pending *> group{};
+      std::vector<RpcResult> results{};
+      bool completed{false};
+
+      void complete()
+      {
+        completed = true;
+
+        for (std::size_t k = 0; k < group.size(); ++k)
+        {
+          if (k < results.size())
+            group[k]->out = std::move(results[k]);
+          else
+            group[k]->out = RpcError::internal_error("batch handler failed");
+          group[k]->done = true;
+          if (k > 0)
+            group[k]->cv.notify_one();
+        }
+
+        owner.finish_batch(group.size());
+      }
+
+      ~Flush()
+      {
+        if (completed)
+          return;
+
+        results.clear();
+        if (!lock.owns_lock())
+          lock.lock();
+        complete();
+      }
+    };
+
+    static MicroBatchOptions sanitize(MicroBatchOptions o) noexcept
+    {
+      o.max_batch = std::max<std::size_t>(o.max_batch, 1);
+      o.concurrency = std::max<std::size_t>(o.concurrency, 1);
+      return o;
+    }
+
+    // Called with `mu_` held.
+    void finish_batch(std::size_t size)
+    {
+      ++batches_;
+      largest_ = std::max(largest_, size);
+
+      using namespace std::chrono;
+      if (size > 1)
+        window_ = std::min<nanoseconds>(std::max<nanoseconds>(window_ * 2, microseconds(10)),
+                                        options_.max_delay);
+      else
+        window_ = window_ / 2 < microseconds(1) ? nanoseconds(0) : window_ / 2;
+
+      --running_;
+      while (running_ < options_.concurrency && !queue_.empty())
+      {
+        Pending *next = queue_.front();
+        queue_.pop_front();
+        next->leader = true;
+        ++running_;
+        next->cv.notify_one();
+      }
+    }
+
+    MicroBatchOptions options_{};
+
+    mutable std::mutex mu_;
+    std::condition_variable gather_;
+    std::deque<Pending *> queue_;
+    std::size_t running_{0};
+    std::chrono::nanoseconds window_{0};
+
+    std::uint64_t calls_{0};
+    std::uint64_t batches_{0};
+    std::size_t largest_{0};
+  };
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_MICRO_BATCHER_HPP
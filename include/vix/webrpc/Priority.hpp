@@ -0,0 +1,61 @@
+/**
+ *
+ *  @file Priority.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_PRIORITY_HPP
+#define VIX_WEBRPC_PRIORITY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief Scheduling class of a call.
+   *
+   * @details
+   * Lower value = served first. Declared per method (`MethodOptions::priority`)
+   * or carried per request through a metadata key (`DispatcherOptions::priority_meta_key`).
+   */
+  enum class Priority : std::uint8_t
+  {
+    interactive = 0,
+    normal = 1,
+    bulk = 2,
+  };
+
+  /// Number of priority classes.
+  inline constexpr std::size_t priority_count = 3;
+
+  /**
+   * @brief Parse a priority label.
+   *
+   * @param s Label: `"interactive"`/`"high"`/`"0"`, `"normal"`/`"1"`, `"bulk"`/`"low"`/`"2"`.
+   * @param fallback Returned when the label is not recognized.
+   */
+  inline Priority parse_priority(std::string_view s, Priority fallback) noexcept
+  {
+    if (s == "interactive" || s == "high" || s == "0")
+      return Priority::interactive;
+    if (s == "normal" || s == "1")
+      return Priority::normal;
+    if (s == "bulk" || s == "low" || s == "2")
+      return Priority::bulk;
+    return fallback;
+  }
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_PRIORITY_HPP
@@ -0,0 +1,301 @@
+/**
+ *
+ *  @file Reference.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_REFERENCE_HPP
+#define VIX_WEBRPC_REFERENCE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+#include <vix/json/Simple.hpp>
+
+#include <vix/webrpc/Error.hpp>
+#include <vix/webrpc/Handler.hpp>
+#include <vix/webrpc/Hash.hpp>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief A reference to the result of another item of the same batch.
+   *
+   * @details
+   * Written inside params as:
+   * @code
+   * { "$ref": "1", "path": "/user_id" }
+   * @endcode
+   * `$ref` is the id of the referenced item (string or integer) and `path` an
+   * optional JSON pointer (RFC 6901) into its result; without `path` the whole
+   * result is substituted.
+   */
+  struct ResultRef
+  {
+    /// Id of the referenced item.
+    const vix::json::token *id{nullptr};
+
+    /// JSON pointer into the referenced result (empty = whole result).
+    std::string_view path{};
+  };
+
+  /**
+   * @brief Recognize a reference object.
+   *
+   * @return The reference, or `std::nullopt` if `t` is not exactly
+   *         `{"$ref": <string|integer>}` or `{"$ref": ..., "path": <string>}`.
+   */
+  inline std::optional<ResultRef> as_reference(const vix::json::token &t) noexcept
+  {
+    const auto op = t.as_object_ptr();
+    if (!op)
+      return std::nullopt;
+
+    const vix::json::token *id = op->get_ptr("$ref");
+    if (!id || !(id->is_string() || id->is_i64()))
+      return std::nullopt;
+
+    const std::size_t members = detail::member_count(*op);
+    if (members == 1)
+      return ResultRef{id, {}};
+
+    const vix::json::token *path = op->get_ptr("path");
+    if (members != 2 || !path)
+      return std::nullopt;
+
+    const std::string *ps = path->as_string();
+    if (!ps)
+      return std::nullopt;
+
+    return ResultRef{id, *ps};
+  }
+
+  /**
+   * @brief Visit every reference found in a params tree (depth-first).
+   */
+  template <typename Fn>
+  inline void for_each_reference(const vix::json::token &params, Fn &&fn)
+  {
+    if (const auto ref = as_reference(params))
+    {
+      fn(*ref);
+      return;
+    }
+
+    if (const auto ap = params.as_array_ptr())
+    {
+      for (const auto &e : ap->elems)
+        for_each_reference(e, fn);
+      return;
+    }
+
+    if (const auto op = params.as_object_ptr())
+    {
+      detail::for_each_member(*op, [&](std::string_view, const vix::json::token &v)
+                              { for_each_reference(v, fn); });
+    }
+  }
+
+  /// True if a params tree contains at least one reference.
+  inline bool has_references(const vix::json::token &params)
+  {
+    bool found = false;
+    for_each_reference(params, [&](const ResultRef &)
+                       { found = true; });
+    return found;
+  }
+
+  /**
+   * @brief Key under which a reference id and an item id meet.
+   *
+   * @details
+   * `"1"` and `1` designate the same item, so both map to `"1"`.
+   *
+   * @return The key, or `std::nullopt` for ids that cannot be referenced
+   *         (null, floating point, structured).
+   */
+  inline std::optional<std::string> reference_key(const vix::json::token &id)
+  {
+    if (const std::string *s = id.as_string())
+      return *s;
+
+    if (id.is_i64())
+      return std::to_string(id.as_i64_or(0));
+
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Evaluate a JSON pointer (RFC 6901) against a token tree.
+   *
+   * @param root    Document.
+   * @param pointer `""` (whole document) or `"/a/0/b"`; `~1` and `~0` escape
+   *                `/` and `~` inside a segment.
+   * @return The designated value, or `std::nullopt` if it does not exist.
+   */
+  inline std::optional<vix::json::token> resolve_pointer(const vix::json::token &root,
+                                                         std::string_view pointer)
+  {
+    if (pointer.empty())
+      return root;
+
+    if (pointer.front() != '/')
+      return std::nullopt;
+
+    const vix::json::token *cur = &root;
+    std::string segment;
+
+    std::size_t pos = 1;
+    while (true)
+    {
+      const std::size_t end = std::min(pointer.find('/', pos), pointer.size());
+
+      segment.clear();
+      for (std::size_t i = pos; i < end; ++i)
+      {
+        if (pointer[i] != '~')
+        {
+          segment.push_back(pointer[i]);
+          continue;
+        }
+
+        if (i + 1 >= end || (pointer[i + 1] != '0' && pointer[i + 1] != '1'))
+          return std::nullopt;
+
+        segment.push_back(pointer[i + 1] == '0' ? '~' : '/');
+        ++i;
+      }
+
+      if (const auto op = cur->as_object_ptr())
+      {
+        cur = op->get_ptr(segment);
+        if (!cur)
+          return std::nullopt;
+      }
+      else if (const auto ap = cur->as_array_ptr())
+      {
+        if (segment.empty() || segment.size() > 18 ||
+            (segment.size() > 1 && segment.front() == '0') ||
+            segment.find_first_not_of("0123456789") != std::string::npos)
+          return std::nullopt;
+
+        const std::size_t index = std::stoull(segment);
+        if (index >= ap->elems.size())
+          return std::nullopt;
+        cur = &ap->elems[index];
+      }
+      else
+      {
+        return std::nullopt;
+      }
+
+      if (end == pointer.size())
+        return *cur;
+      pos = end + 1;
+    }
+  }
+
+  namespace detail
+  {
+    /**
+     * @brief Substitution of one subtree.
+     *
+     * @return `std::nullopt` if the subtree holds no reference (the caller keeps
+     *         sharing it), otherwise the rebuilt subtree or the first error.
+     */
+    template <typename Resolve>
+    inline std::optional<RpcResult> substitute(const vix::json::token &t, Resolve &resolve)
+    {
+      using namespace vix::json;
+
+      if (const auto ref = as_reference(t))
+        return resolve(*ref);
+
+      if (const auto ap = t.as_array_ptr())
+      {
+        std::optional<array_t> out;
+        for (std::size_t i = 0; i < ap->elems.size(); ++i)
+        {
+          auto r = substitute(ap->elems[i], resolve);
+          if (!r)
+            continue;
+          if (std::holds_alternative<RpcError>(*r))
+            return r;
+
+          if (!out)
+            out = *ap;
+          out->elems[i] = std::get<token>(std::move(*r));
+        }
+
+        if (!out)
+          return std::nullopt;
+        return RpcResult(token(std::move(*out)));
+      }
+
+      if (const auto op = t.as_object_ptr())
+      {
+        std::optional<kvs> out;
+        std::optional<RpcError> failed;
+        for_each_member(*op, [&](std::string_view k, const token &v)
+                        {
+                          if (failed)
+                            return;
+
+                          auto r = substitute(v, resolve);
+                          if (!r)
+                            return;
+                          if (std::holds_alternative<RpcError>(*r))
+                          {
+                            failed = std::get<RpcError>(std::move(*r));
+                            return;
+                          }
+
+                          if (!out)
+                            out = *op;
+                          out->set(k, std::get<token>(std::move(*r))); });
+
+        if (failed)
+          return RpcResult(std::move(*failed));
+        if (!out)
+          return std::nullopt;
+        return RpcResult(token(std::move(*out)));
+      }
+
+      return std::nullopt;
+    }
+  } // namespace detail
+
+  /**
+   * @brief Replace every reference of a params tree by its value.
+   *
+   * @param params  Params tree.
+   * @param resolve Called per reference as `RpcResult(const ResultRef &)`.
+   * @return The substituted tree (subtrees without references stay shared with
+   *         `params`), or the first error returned by `resolve`.
+   */
+  template <typename Resolve>
+  inline RpcResult substitute_references(const vix::json::token &params, Resolve &&resolve)
+  {
+    auto r = detail::substitute(params, resolve);
+    if (!r)
+      return params;
+    return std::move(*r);
+  }
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_REFERENCE_HPP
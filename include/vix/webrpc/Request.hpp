@@ -16,13 +16,18 @@
 #ifndef VIX_WEBRPC_REQUEST_HPP
 #define VIX_WEBRPC_REQUEST_HPP
 
+#include <memory>
+#include <memory_resource>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 #include <variant>
 
 #include <vix/json/Simple.hpp>
 #include <vix/webrpc/Error.hpp>
+#include <vix/webrpc/Hash.hpp>
+#include <vix/webrpc/Limits.hpp>
 
 namespace vix::webrpc
 {
@@ -46,19 +51,38 @@ namespace vix::webrpc
    * @note
    * - Missing `id` typically indicates a notification (no response expected).
    * - `params` can be any JSON-like value; handlers decide how to interpret it.
+   *
+   * @par Allocator
+   * `RpcRequest` is `BasicRpcRequest<std::allocator<char>>` (`method` is a
+   * `std::string`). `webrpc::pmr::RpcRequest` allocates `method` from the resource
+   * given to the constructor or to `parse()`, like `pmr::RpcError`. `id` and
+   * `params` share the payload's `vix::json` storage (copying them does not
+   * allocate).
    */
-  struct RpcRequest
+  template <typename Allocator = std::allocator<char>>
+  struct BasicRpcRequest
   {
+    /// Allocator of `method`.
+    using allocator_type = Allocator;
+
+    /// Type of `method`.
+    using string_type = std::basic_string<char, std::char_traits<char>, Allocator>;
+
+    /// Error type of `parse()`.
+    using error_type = BasicRpcError<Allocator>;
+
     /// Optional request id (null if absent). Allowed: null|string|int.
     vix::json::token id{nullptr};
 
     /// RPC method name (required, non-empty).
-    std::string method{};
+    string_type method{};
 
     /// Optional parameters payload (any JSON-like value).
     vix::json::token params{nullptr};
 
-    RpcRequest() = default;
+    BasicRpcRequest() = default;
+
+    explicit BasicRpcRequest(const allocator_type &alloc) noexcept : method(alloc) {}
 
     /**
      * @brief Construct a request.
@@ -66,16 +90,40 @@ namespace vix::webrpc
      * @param id_     Request id token (null if absent).
      * @param method_ RPC method name.
      * @param params_ Parameters token (null if absent).
+     * @param alloc   Allocator of `method`.
      */
-    RpcRequest(vix::json::token id_,
-               std::string method_,
-               vix::json::token params_)
+    BasicRpcRequest(vix::json::token id_,
+                    std::string_view method_,
+                    vix::json::token params_,
+                    const allocator_type &alloc = {})
         : id(std::move(id_)),
-          method(std::move(method_)),
+          method(method_, alloc),
           params(std::move(params_))
     {
     }
 
+    BasicRpcRequest(const BasicRpcRequest &) = default;
+    BasicRpcRequest(BasicRpcRequest &&) noexcept = default;
+    BasicRpcRequest &operator=(const BasicRpcRequest &) = default;
+    BasicRpcRequest &operator=(BasicRpcRequest &&) = default;
+
+    /// Copy into `alloc`.
+    BasicRpcRequest(const BasicRpcRequest &other, const allocator_type &alloc)
+        : id(other.id), method(other.method, alloc), params(other.params)
+    {
+    }
+
+    /// Move into `alloc`.
+    BasicRpcRequest(BasicRpcRequest &&other, const allocator_type &alloc)
+        : id(std::move(other.id)),
+          method(std::move(other.method), alloc),
+          params(std::move(other.params))
+    {
+    }
+
+    /// Allocator of `method`.
+    allocator_type get_allocator() const noexcept { return method.get_allocator(); }
+
     /// True if `id` is present (request/response semantics).
     bool has_id() const noexcept { return !id.is_null(); }
 
@@ -92,7 +140,7 @@ namespace vix::webrpc
       using namespace vix::json;
 
       kvs o;
-      o.set_string("method", method);
+      o.set_string("method", std::string(method));
 
       if (!id.is_null())
         o.set("id", id);
@@ -106,7 +154,8 @@ namespace vix::webrpc
     /**
      * @brief Parse an RpcRequest from a JSON token.
      *
-     * @param root Input JSON token.
+     * @param root  Input JSON token.
+     * @param alloc Allocator of the request (or error) strings.
      * @return On success: `RpcRequest`. On failure: `RpcError` (PARSE_ERROR / INVALID_PARAMS).
      *
      * @details
@@ -119,37 +168,97 @@ namespace vix::webrpc
      * @note
      * This API is explicit and exception-free: callers must handle both cases.
      */
-    static std::variant<RpcRequest, RpcError> parse(const vix::json::token &root)
+    static std::variant<BasicRpcRequest, error_type> parse(const vix::json::token &root,
+                                                           const allocator_type &alloc = {})
     {
-      using namespace vix::json;
+      return owning(try_parse(root, alloc), alloc);
+    }
+
+    /**
+     * @brief Parse an RpcRequest out of a payload the caller gives up.
+     *
+     * @details
+     * Same rules as `parse(const token &)`, but `id` and `params` are moved out of
+     * the payload instead of shared or copied (a string param is not copied).
+     * Only done when nothing else shares the payload object; otherwise this is
+     * the copying parse. The members moved out are left null in `root`.
+     */
+    static std::variant<BasicRpcRequest, error_type> parse(vix::json::token &&root,
+                                                           const allocator_type &alloc = {})
+    {
+      return owning(try_parse(std::move(root), alloc), alloc);
+    }
+
+    /**
+     * @brief Parse an RpcRequest, rejecting params over the given limits.
+     *
+     * @param root   Input JSON token.
+     * @param limits Depth and size limits of params (see `check_params()`).
+     * @param alloc  Allocator of the request (or error) strings.
+     * @return As `parse(root)`, or PARAMS_TOO_DEEP / PARAMS_TOO_LARGE. The params
+     *         walk stops at the first crossed limit.
+     */
+    static std::variant<BasicRpcRequest, error_type> parse(const vix::json::token &root,
+                                                           const DispatcherLimits &limits,
+                                                           const allocator_type &alloc = {})
+    {
+      return owning(try_parse(root, limits, alloc), alloc);
+    }
+
+    /**
+     * @brief Consuming parse (see `parse(token &&)`), rejecting params over the limits.
+     */
+    static std::variant<BasicRpcRequest, error_type> parse(vix::json::token &&root,
+                                                           const DispatcherLimits &limits,
+                                                           const allocator_type &alloc = {})
+    {
+      return owning(try_parse(std::move(root), limits, alloc), alloc);
+    }
 
+    /**
+     * @brief `parse()` reporting a failure as an `ErrorView` (nothing is allocated for it).
+     *
+     * @details
+     * The view holds literals only: it outlives `root`. Used by the dispatcher to
+     * write rejections without building an error.
+     */
+    static std::variant<BasicRpcRequest, ErrorView> try_parse(const vix::json::token &root,
+                                                              const allocator_type &alloc = {})
+    {
       const auto objp = root.as_object_ptr();
       if (!objp)
-        return RpcError::parse_error("request must be an object");
+        return ErrorView::parse_error("request must be an object");
 
-      const kvs &o = *objp;
+      return parse_members(std::as_const(*objp), alloc);
+    }
 
-      const token *m = o.get_ptr("method");
-      if (!m)
-        return RpcError::invalid_params("missing field: method");
+    /// Consuming `try_parse()` (see `parse(token &&)`).
+    static std::variant<BasicRpcRequest, ErrorView> try_parse(vix::json::token &&root,
+                                                              const allocator_type &alloc = {})
+    {
+      const auto objp = root.as_object_ptr();
 
-      const std::string *ms = m->as_string();
-      if (!ms || ms->empty())
-        return RpcError::invalid_params("method must be a non-empty string");
+      // `root` and `objp` are the only owners: nobody can observe the moves.
+      if (!objp || objp.use_count() > 2)
+        return try_parse(std::as_const(root), alloc);
 
-      token id_tok{nullptr};
-      if (const token *idp = o.get_ptr("id"))
-      {
-        id_tok = *idp;
-        if (!(id_tok.is_null() || id_tok.is_string() || id_tok.is_i64()))
-          return RpcError::invalid_params("id must be string, int, or null");
-      }
+      return parse_members(*objp, alloc);
+    }
 
-      token params_tok{nullptr};
-      if (const token *pp = o.get_ptr("params"))
-        params_tok = *pp;
+    /// `try_parse()` rejecting params over the limits.
+    static std::variant<BasicRpcRequest, ErrorView> try_parse(const vix::json::token &root,
+                                                              const DispatcherLimits &limits,
+                                                              const allocator_type &alloc = {})
+    {
+      return checked(try_parse(root, alloc), limits);
+    }
 
-      return RpcRequest{std::move(id_tok), *ms, std::move(params_tok)};
+    /// Consuming `try_parse()` rejecting params over the limits.
+    static std::variant<BasicRpcRequest, ErrorView> try_parse(vix::json::token &&root,
+                                                              const DispatcherLimits &limits,
+                                                              const allocator_type &alloc = {})
+    {
+      return checked(try_parse(std::move(root), alloc), limits);
     }
 
     /**
@@ -191,8 +300,84 @@ namespace vix::webrpc
         return o->get_ptr(key);
       return nullptr;
     }
+
+  private:
+    /**
+     * @brief Validate the members of a request object and build the request.
+     *
+     * @details
+     * With a non-const object, `id` and `params` are moved out of it.
+     */
+    template <typename Object>
+    static std::variant<BasicRpcRequest, ErrorView> parse_members(Object &o, const allocator_type &alloc)
+    {
+      using namespace vix::json;
+
+      auto *m = detail::find_member(o, "method");
+      if (!m)
+        return ErrorView::invalid_params("missing field: method");
+
+      const std::string *ms = m->as_string();
+      if (!ms || ms->empty())
+        return ErrorView::invalid_params("method must be a non-empty string");
+
+      auto *idp = detail::find_member(o, "id");
+      if (idp && !(idp->is_null() || idp->is_string() || idp->is_i64()))
+        return ErrorView::invalid_params("id must be string, int, or null");
+
+      auto take = [](auto *t) -> token
+      {
+        if (!t)
+          return token{nullptr};
+        if constexpr (std::is_const_v<Object>)
+          return *t;
+        else
+          return std::move(*t);
+      };
+
+      auto *pp = detail::find_member(o, "params");
+      return BasicRpcRequest{take(idp), *ms, take(pp), alloc};
+    }
+
+    /// Apply `DispatcherLimits` to a parsed request.
+    static std::variant<BasicRpcRequest, ErrorView> checked(std::variant<BasicRpcRequest, ErrorView> parsed,
+                                                            const DispatcherLimits &limits)
+    {
+      if (std::holds_alternative<ErrorView>(parsed))
+        return parsed;
+
+      switch (check_params(std::get<BasicRpcRequest>(parsed).params, limits))
+      {
+      case ParamsCheck::ok:
+        break;
+      case ParamsCheck::too_deep:
+        return ErrorView::limit(ErrorCode::params_too_deep, limits.max_params_depth);
+      case ParamsCheck::too_large:
+        return ErrorView::limit(ErrorCode::params_too_large, limits.max_params_bytes);
+      }
+
+      return parsed;
+    }
+
+    /// The result of `try_parse()` with an owning error.
+    static std::variant<BasicRpcRequest, error_type> owning(std::variant<BasicRpcRequest, ErrorView> parsed,
+                                                            const allocator_type &alloc)
+    {
+      if (const ErrorView *err = std::get_if<ErrorView>(&parsed))
+        return error_type(*err, alloc);
+      return std::get<BasicRpcRequest>(std::move(parsed));
+    }
   };
 
+  /// Request with a `std::string` method: the request of `Router::dispatch()`.
+  using RpcRequest = BasicRpcRequest<>;
+
+  namespace pmr
+  {
+    /// Request whose method comes from a `std::pmr::memory_resource`.
+    using RpcRequest = BasicRpcRequest<std::pmr::polymorphic_allocator<char>>;
+  } // namespace pmr
+
 } // namespace vix::webrpc
 
 #endif // VIX_WEBRPC_REQUEST_HPP
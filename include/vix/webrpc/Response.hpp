@@ -16,6 +16,8 @@
 #ifndef VIX_WEBRPC_RESPONSE_HPP
 #define VIX_WEBRPC_RESPONSE_HPP
 
+#include <memory>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -53,60 +55,160 @@ namespace vix::webrpc
    * Rules:
    * - `result` XOR `error` (never both)
    * - `id` is optional and may be null (common for notifications / fire-and-forget)
+   *
+   * @par Layout
+   * `result` and `error` share storage: the body holds either the result token or
+   * a pointer to an out-of-line `RpcError`, so a success response carries no
+   * empty error. Target: `sizeof(RpcResponse) <= 2 * sizeof(vix::json::token) +
+   * 2 * sizeof(void *)` (id, body, allocator), guarded by a `static_assert` below.
+   * An error response costs one allocation for its error, from the response's
+   * allocator. `has_error()`, `result()` and `error()` are read-only accessors;
+   * they replace the former data members (see the README migration notes).
+   *
+   * @par Allocator
+   * `RpcResponse` is `BasicRpcResponse<std::allocator<char>>` and holds an
+   * `RpcError`. `webrpc::pmr::RpcResponse` holds a `pmr::RpcError`: the
+   * out-of-line error and its strings come from the given memory resource. `id`
+   * and `result` are `vix::json` values in both.
    */
-  struct RpcResponse
+  template <typename Allocator = std::allocator<char>>
+  struct BasicRpcResponse
   {
+    /// Allocator of the error (and its strings).
+    using allocator_type = Allocator;
+
+    /// Error type of `fail()` and `error()`.
+    using error_type = BasicRpcError<Allocator>;
+
     /// Echo of the request id (allowed: null|string|int).
     vix::json::token id{nullptr};
 
-    /// Success payload (valid only when has_error == false).
-    vix::json::token result{nullptr};
+    BasicRpcResponse() = default;
 
-    /// Error payload (valid only when has_error == true).
-    RpcError error{};
+    explicit BasicRpcResponse(const allocator_type &alloc) noexcept : alloc_(alloc) {}
 
-    /// True if this response represents an error.
-    bool has_error{false};
+    /// Copy (the default resource for `pmr`, as for `std::pmr` types).
+    BasicRpcResponse(const BasicRpcResponse &other)
+        : BasicRpcResponse(other, traits::select_on_container_copy_construction(other.alloc_))
+    {
+    }
+
+    BasicRpcResponse(BasicRpcResponse &&) noexcept = default;
 
-    RpcResponse() = default;
+    /// Copy into `alloc`.
+    BasicRpcResponse(const BasicRpcResponse &other, const allocator_type &alloc)
+        : id(other.id), alloc_(alloc)
+    {
+      if (other.has_error())
+        body_ = make_error(other.error());
+      else
+        body_ = other.result();
+    }
+
+    /// Move into `alloc` (steals the error when `alloc` compares equal).
+    BasicRpcResponse(BasicRpcResponse &&other, const allocator_type &alloc)
+        : id(std::move(other.id)), alloc_(alloc)
+    {
+      adopt(std::move(other));
+    }
+
+    /// Copy assignment (keeps this response's allocator).
+    BasicRpcResponse &operator=(const BasicRpcResponse &other)
+    {
+      if (this != &other)
+      {
+        id = other.id;
+        if (other.has_error())
+          body_ = make_error(other.error());
+        else
+          body_ = other.result();
+      }
+      return *this;
+    }
+
+    /// Move assignment (keeps this response's allocator).
+    BasicRpcResponse &operator=(BasicRpcResponse &&other)
+    {
+      if (this != &other)
+      {
+        id = std::move(other.id);
+        adopt(std::move(other));
+      }
+      return *this;
+    }
+
+    /// Allocator of the error (and its strings).
+    allocator_type get_allocator() const noexcept { return alloc_; }
 
     /**
      * @brief Build a success response.
      *
      * @param id_     Request id (may be null).
      * @param result_ Success payload.
+     * @param alloc   Allocator of the response.
      */
-    static RpcResponse ok(vix::json::token id_, vix::json::token result_)
+    static BasicRpcResponse ok(vix::json::token id_,
+                               vix::json::token result_,
+                               const allocator_type &alloc = {})
     {
-      RpcResponse r;
+      BasicRpcResponse r(alloc);
       r.id = std::move(id_);
-      r.result = std::move(result_);
-      r.error = RpcError{};
-      r.has_error = false;
+      r.body_ = std::move(result_);
       return r;
     }
 
     /**
-     * @brief Build an error response.
+     * @brief Build an error response (keeps the allocator of `err`).
      *
      * @param id_  Request id (may be null).
      * @param err  Structured error.
      */
-    static RpcResponse fail(vix::json::token id_, RpcError err)
+    static BasicRpcResponse fail(vix::json::token id_, error_type err)
+    {
+      const allocator_type alloc = err.get_allocator();
+      return fail(std::move(id_), std::move(err), alloc);
+    }
+
+    /**
+     * @brief Build an error response in `alloc` (`err` is moved or copied into it).
+     */
+    static BasicRpcResponse fail(vix::json::token id_, error_type err, const allocator_type &alloc)
     {
-      RpcResponse r;
+      BasicRpcResponse r(alloc);
       r.id = std::move(id_);
-      r.result = vix::json::token(nullptr);
-      r.error = std::move(err);
-      r.has_error = true;
+      r.body_ = r.make_error(std::move(err));
       return r;
     }
 
     /// True if id is null (typically a notification).
     bool is_notification() const noexcept { return id.is_null(); }
 
+    /// True if this response represents an error.
+    bool has_error() const noexcept { return body_.index() == 1; }
+
     /// True if this response is a success response.
-    bool ok() const noexcept { return !has_error; }
+    bool ok() const noexcept { return !has_error(); }
+
+    /// Success payload (null for an error response).
+    const vix::json::token &result() const noexcept
+    {
+      if (const vix::json::token *t = std::get_if<vix::json::token>(&body_))
+        return *t;
+
+      static const vix::json::token none{nullptr};
+      return none;
+    }
+
+    /// Error payload (an empty, invalid error for a success response).
+    const error_type &error() const noexcept
+    {
+      const ErrorPtr *e = std::get_if<ErrorPtr>(&body_);
+      if (e && *e)
+        return **e;
+
+      static const error_type none{};
+      return none;
+    }
 
     /**
      * @brief Serialize this response to a JSON object token.
@@ -117,13 +219,13 @@ namespace vix::webrpc
     {
       using namespace vix::json;
 
-      if (has_error)
+      if (has_error())
       {
         return obj({
             "id",
             id,
             "error",
-            error.to_json(),
+            error().to_json(),
         });
       }
 
@@ -131,14 +233,38 @@ namespace vix::webrpc
           "id",
           id,
           "result",
-          result,
+          result(),
       });
     }
 
+    /**
+     * @brief Append this response as JSON text (same shape as `to_json()`).
+     *
+     * @details
+     * Writes straight into `out`: nothing is allocated beyond its growth.
+     */
+    void write_json(std::string &out) const
+    {
+      out.append("{\"id\":");
+      detail::append_json(out, id);
+      if (has_error())
+      {
+        out.append(",\"error\":");
+        error().write_json(out);
+      }
+      else
+      {
+        out.append(",\"result\":");
+        detail::append_json(out, result());
+      }
+      out.push_back('}');
+    }
+
     /**
      * @brief Parse an RpcResponse from a JSON token.
      *
-     * @param root Input JSON token.
+     * @param root  Input JSON token.
+     * @param alloc Allocator of the response (or error) strings.
      * @return On success: `RpcResponse`. On failure: `RpcError` (PARSE_ERROR / INVALID_PARAMS).
      *
      * @details
@@ -151,13 +277,14 @@ namespace vix::webrpc
      * @note
      * This API is explicit and exception-free: callers must handle both cases.
      */
-    static std::variant<RpcResponse, RpcError> parse(const vix::json::token &root)
+    static std::variant<BasicRpcResponse, error_type> parse(const vix::json::token &root,
+                                                            const allocator_type &alloc = {})
     {
       using namespace vix::json;
 
       const auto objp = root.as_object_ptr();
       if (!objp)
-        return RpcError::parse_error("response must be an object");
+        return error_type::parse_error("response must be an object", alloc);
 
       const kvs &o = *objp;
 
@@ -166,41 +293,97 @@ namespace vix::webrpc
       {
         id_tok = *idp;
         if (!(id_tok.is_null() || id_tok.is_string() || id_tok.is_i64()))
-          return RpcError::invalid_params("id must be string, int, or null");
+          return error_type::invalid_params("id must be string, int, or null", alloc);
       }
 
       const token *res_p = o.get_ptr("result");
       const token *err_p = o.get_ptr("error");
 
       if (res_p && err_p)
-        return RpcError::invalid_params("response cannot contain both result and error");
+        return error_type::invalid_params("response cannot contain both result and error", alloc);
 
       if (!res_p && !err_p)
-        return RpcError::invalid_params("response must contain result or error");
+        return error_type::invalid_params("response must contain result or error", alloc);
 
       if (err_p)
       {
-        const auto pr = RpcError::parse(*err_p);
+        auto pr = error_type::parse(*err_p, alloc);
         if (!pr.ok())
-          return pr.error();
-
-        RpcResponse out;
-        out.id = std::move(id_tok);
-        out.result = token(nullptr);
-        out.error = pr.value();
-        out.has_error = true;
-        return out;
+          return std::move(pr.error());
+
+        return fail(std::move(id_tok), std::move(pr.value()), alloc);
+      }
+
+      return ok(std::move(id_tok), *res_p, alloc);
+    }
+
+  private:
+    using traits = std::allocator_traits<Allocator>;
+    using error_alloc = typename traits::template rebind_alloc<error_type>;
+    using error_traits = std::allocator_traits<error_alloc>;
+
+    /// Frees an out-of-line error through the allocator it was made with.
+    struct ErrorDelete
+    {
+      void operator()(error_type *e) const noexcept
+      {
+        error_alloc alloc(e->get_allocator());
+        error_traits::destroy(alloc, e);
+        error_traits::deallocate(alloc, e, 1);
+      }
+    };
+
+    using ErrorPtr = std::unique_ptr<error_type, ErrorDelete>;
+
+    /// Out-of-line copy (or move) of `err`, with this response's allocator.
+    template <typename E>
+    ErrorPtr make_error(E &&err) const
+    {
+      error_alloc alloc(alloc_);
+      error_type *e = error_traits::allocate(alloc, 1);
+      try
+      {
+        // A `pmr` allocator also hands itself to the error (uses-allocator construction).
+        error_traits::construct(alloc, e, std::forward<E>(err));
+      }
+      catch (...)
+      {
+        error_traits::deallocate(alloc, e, 1);
+        throw;
       }
+      return ErrorPtr(e);
+    }
 
-      RpcResponse out;
-      out.id = std::move(id_tok);
-      out.result = *res_p;
-      out.error = RpcError{};
-      out.has_error = false;
-      return out;
+    /// Take the body of `other`, stealing its error when both allocators compare equal.
+    void adopt(BasicRpcResponse &&other)
+    {
+      ErrorPtr *e = std::get_if<ErrorPtr>(&other.body_);
+      if (e && *e && !((*e)->get_allocator() == alloc_))
+        body_ = make_error(std::move(**e));
+      else
+        body_ = std::move(other.body_);
     }
+
+    [[no_unique_address]] allocator_type alloc_{};
+
+    /// Result token or out-of-line error (mutually exclusive).
+    std::variant<vix::json::token, ErrorPtr> body_{};
   };
 
+  /// Response holding an `RpcError`.
+  using RpcResponse = BasicRpcResponse<>;
+
+  namespace pmr
+  {
+    /// Response whose error comes from a `std::pmr::memory_resource`.
+    using RpcResponse = BasicRpcResponse<std::pmr::polymorphic_allocator<char>>;
+  } // namespace pmr
+
+  static_assert(sizeof(RpcResponse) <= 2 * sizeof(vix::json::token) + 2 * sizeof(void *),
+                "RpcResponse grew past its layout target (id, body, allocator)");
+  static_assert(sizeof(pmr::RpcResponse) <= 2 * sizeof(vix::json::token) + 2 * sizeof(void *),
+                "pmr::RpcResponse grew past its layout target (id, body, allocator)");
+
 } // namespace vix::webrpc
 
 #endif // VIX_WEBRPC_RESPONSE_HPP
@@ -0,0 +1,420 @@
+/**
+ *
+ *  @file ResultCache.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_RESULT_CACHE_HPP
+#define VIX_WEBRPC_RESULT_CACHE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <vix/json/Simple.hpp>
+
+#include <vix/webrpc/Hash.hpp>
+#include <vix/webrpc/detail/JsonWriter.hpp>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief Configuration of the dispatcher result cache.
+   */
+  struct ResultCacheOptions
+  {
+    /// Memory cap over all shards, in bytes (0 = cache disabled).
+    std::size_t max_bytes{0};
+
+    /**
+     * @brief Number of independently locked shards.
+     *
+     * @details
+     * Reduced when `max_bytes` is too small to give each shard at least
+     * `ResultCache::min_shard_bytes` (see `ResultCache::shards()`).
+     */
+    std::size_t shards{16};
+  };
+
+  /**
+   * @brief Counters of a result cache.
+   */
+  struct ResultCacheStats
+  {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+    std::uint64_t inserts{0};
+
+    /// Entries dropped to stay under the memory cap (LRU order).
+    std::uint64_t evictions{0};
+
+    /// Entries found past their TTL and dropped on lookup.
+    std::uint64_t expirations{0};
+
+    /// Results not stored because they are larger than a shard budget.
+    std::uint64_t rejected{0};
+
+    std::size_t entries{0};
+    std::size_t bytes{0};
+  };
+
+  /**
+   * @brief Sharded LRU cache of successful handler results.
+   *
+   * @details
+   * Keyed by method name and params, using the same structural hash as the
+   * coalescer (object key order ignored) plus a full comparison on lookup.
+   *
+   * - each shard has its own mutex, LRU list and byte budget (`max_bytes / shards`);
+   *   the shard count is reduced so that no budget falls below `min_shard_bytes`
+   * - entries carry their own expiry (per-method TTL decided by the caller)
+   * - an entry is sized by its result (text and tree) plus its key (method and
+   *   params tree); an entry larger than a shard budget is not stored (counted in
+   *   `rejected`)
+   *
+   * `put()` keeps two forms of the result: its JSON text, and a private copy of the
+   * tree taken from the handler's value. `append()` copies the text into an output
+   * buffer, so `Dispatcher::write()` answers a hit without serializing the result
+   * again; `get()` returns the tree, so a token-path hit has the exact value (and
+   * number types) of the miss that filled it, without rebuilding anything.
+   *
+   * The tree is shared by every hit, as coalesced followers share their leader's
+   * result: readers must treat it as immutable. The handler's own value is not the
+   * one stored, so the caller of the filling call may still edit its result.
+   */
+  class ResultCache
+  {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    /// Smallest byte budget a shard is given, unless `max_bytes` itself is smaller.
+    static constexpr std::size_t min_shard_bytes = 4096;
+
+    explicit ResultCache(const ResultCacheOptions &options)
+        : shards_(shard_count(options)),
+          shard_budget_(options.max_bytes / shards_.size())
+    {
+    }
+
+    ResultCache(const ResultCache &) = delete;
+    ResultCache &operator=(const ResultCache &) = delete;
+
+    /**
+     * @brief Look up a cached result.
+     *
+     * @param key    Call key (`call_hash(method, params)`).
+     * @param method Method name.
+     * @param params Call params.
+     * @return The cached result (shared, read-only), or `std::nullopt` on miss / expiry.
+     */
+    std::optional<vix::json::token> get(std::uint64_t key,
+                                        std::string_view method,
+                                        const vix::json::token &params)
+    {
+      std::optional<vix::json::token> out;
+      lookup(key, method, params, [&](const Entry &e)
+             { out = e.result; });
+      return out;
+    }
+
+    /**
+     * @brief Append the JSON text of a cached result to `out`.
+     *
+     * @return `true` on a hit; on a miss / expiry, `out` is left untouched.
+     */
+    bool append(std::uint64_t key,
+                std::string_view method,
+                const vix::json::token &params,
+                std::string &out)
+    {
+      return lookup(key, method, params, [&](const Entry &e)
+                    { out.append(e.text); });
+    }
+
+    /**
+     * @brief Store (or replace) a result.
+     *
+     * @param key    Call key (`call_hash(method, params)`).
+     * @param method Method name.
+     * @param params Call params.
+     * @param result Successful handler result (serialized and copied here; not kept).
+     * @param ttl    Time to live of the entry.
+     */
+    void put(std::uint64_t key,
+             std::string_view method,
+             const vix::json::token &params,
+             const vix::json::token &result,
+             std::chrono::nanoseconds ttl)
+    {
+      std::string text;
+      detail::append_json(text, result);
+      text.shrink_to_fit();
+
+      vix::json::token tree = snapshot(result);
+
+      const std::size_t bytes = sizeof(Entry) + method.size() + footprint(params) +
+                                text.size() + footprint(tree);
+      if (bytes > shard_budget_)
+      {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+
+      Shard &s = shard(key);
+      std::lock_guard<std::mutex> lock(s.mu);
+
+      if (const auto it = s.find(key, method, params); it != s.index.end())
+        s.drop(it);
+
+      while (!s.lru.empty() && s.bytes + bytes > shard_budget_)
+      {
+        s.drop(s.locate(std::prev(s.lru.end())));
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      s.lru.push_front(Entry{
+          key,
+          std::string(method),
+          params,
+          std::move(tree),
+          std::move(text),
+          clock::now() + std::chrono::duration_cast<clock::duration>(ttl),
+          bytes,
+      });
+      s.index.emplace(key, s.lru.begin());
+      s.bytes += bytes;
+      inserts_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Number of shards in use (`options.shards`, reduced for small caps).
+    std::size_t shards() const noexcept { return shards_.size(); }
+
+    /// Byte budget of each shard.
+    std::size_t shard_budget() const noexcept { return shard_budget_; }
+
+    /// Drop every entry.
+    void clear()
+    {
+      for (Shard &s : shards_)
+      {
+        std::lock_guard<std::mutex> lock(s.mu);
+        s.index.clear();
+        s.lru.clear();
+        s.bytes = 0;
+      }
+    }
+
+    /// Counters and current occupancy.
+    ResultCacheStats stats() const
+    {
+      ResultCacheStats st;
+      st.hits = hits_.load(std::memory_order_relaxed);
+      st.misses = misses_.load(std::memory_order_relaxed);
+      st.inserts = inserts_.load(std::memory_order_relaxed);
+      st.evictions = evictions_.load(std::memory_order_relaxed);
+      st.expirations = expirations_.load(std::memory_order_relaxed);
+      st.rejected = rejected_.load(std::memory_order_relaxed);
+
+      for (const Shard &s : shards_)
+      {
+        std::lock_guard<std::mutex> lock(s.mu);
+        st.entries += s.lru.size();
+        st.bytes += s.bytes;
+      }
+      return st;
+    }
+
+    /**
+     * @brief Estimated heap + inline footprint of a token tree, in bytes (entry keys).
+     */
+    static std::size_t footprint(const vix::json::token &t) noexcept
+    {
+      std::size_t n = sizeof(vix::json::token);
+
+      if (const std::string *s = t.as_string())
+        return n + s->capacity();
+
+      if (const auto ap = t.as_array_ptr())
+      {
+        n += sizeof(vix::json::array_t);
+        for (const auto &e : ap->elems)
+          n += footprint(e);
+        return n;
+      }
+
+      if (const auto op = t.as_object_ptr())
+      {
+        n += sizeof(vix::json::kvs);
+        detail::for_each_member(*op, [&](std::string_view k, const vix::json::token &v)
+                                { n += sizeof(vix::json::token) + k.size() + footprint(v); });
+      }
+
+      return n;
+    }
+
+  private:
+    struct Entry
+    {
+      std::uint64_t key{0};
+      std::string method;
+      vix::json::token params{nullptr};
+
+      /// Private copy of the result tree (token-path hits).
+      vix::json::token result{nullptr};
+
+      /// Result as compact JSON text (`append()`).
+      std::string text;
+      clock::time_point expires{};
+      std::size_t bytes{0};
+    };
+
+    using List = std::list<Entry>;
+
+    struct Shard
+    {
+      mutable std::mutex mu;
+      List lru;
+      std::unordered_multimap<std::uint64_t, List::iterator> index;
+      std::size_t bytes{0};
+
+      using Slot = std::unordered_multimap<std::uint64_t, List::iterator>::iterator;
+
+      Slot find(std::uint64_t key, std::string_view method, const vix::json::token &params)
+      {
+        const auto [first, last] = index.equal_range(key);
+        for (auto it = first; it != last; ++it)
+        {
+          if (it->second->method == method && equal(it->second->params, params))
+            return it;
+        }
+        return index.end();
+      }
+
+      Slot locate(List::iterator entry)
+      {
+        const auto [first, last] = index.equal_range(entry->key);
+        for (auto it = first; it != last; ++it)
+        {
+          if (it->second == entry)
+            return it;
+        }
+        return index.end();
+      }
+
+      void drop(Slot slot)
+      {
+        bytes -= slot->second->bytes;
+        lru.erase(slot->second);
+        index.erase(slot);
+      }
+    };
+
+    /**
+     * @brief Find a live entry, refresh it in the LRU order and pass it to `on_hit`.
+     *
+     * @return `true` on a hit. Counts the hit or the miss (and the expiry).
+     */
+    template <typename OnHit>
+    bool lookup(std::uint64_t key,
+                std::string_view method,
+                const vix::json::token &params,
+                OnHit &&on_hit)
+    {
+      Shard &s = shard(key);
+      const auto now = clock::now();
+
+      std::lock_guard<std::mutex> lock(s.mu);
+
+      const auto it = s.find(key, method, params);
+      if (it == s.index.end())
+      {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      auto entry = it->second;
+      if (entry->expires <= now)
+      {
+        s.drop(it);
+        expirations_.fetch_add(1, std::memory_order_relaxed);
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      s.lru.splice(s.lru.begin(), s.lru, entry);
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      on_hit(*entry);
+      return true;
+    }
+
+    /**
+     * @brief Deep copy of a token tree (containers rebuilt, scalars copied as is).
+     */
+    static vix::json::token snapshot(const vix::json::token &t)
+    {
+      if (const auto ap = t.as_array_ptr())
+      {
+        vix::json::array_t arr;
+        arr.elems.reserve(ap->elems.size());
+        for (const auto &e : ap->elems)
+          arr.elems.push_back(snapshot(e));
+        return vix::json::token(std::move(arr));
+      }
+
+      if (const auto op = t.as_object_ptr())
+      {
+        vix::json::kvs o;
+        o.flat.reserve(op->flat.size());
+        for (const auto &e : op->flat)
+          o.flat.push_back(snapshot(e));
+        return vix::json::token(std::move(o));
+      }
+
+      return t;
+    }
+
+    static std::size_t shard_count(const ResultCacheOptions &options) noexcept
+    {
+      const std::size_t fit = std::max<std::size_t>(options.max_bytes / min_shard_bytes, 1);
+      return std::clamp<std::size_t>(options.shards, 1, fit);
+    }
+
+    Shard &shard(std::uint64_t key) noexcept
+    {
+      return shards_[key % shards_.size()];
+    }
+
+    std::vector<Shard> shards_;
+    std::size_t shard_budget_{0};
+
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+    std::atomic<std::uint64_t> inserts_{0};
+    std::atomic<std::uint64_t> evictions_{0};
+    std::atomic<std::uint64_t> expirations_{0};
+    std::atomic<std::uint64_t> rejected_{0};
+  };
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_RESULT_CACHE_HPP
@@ -16,7 +16,11 @@
 #ifndef VIX_WEBRPC_ROUTER_HPP
 #define VIX_WEBRPC_ROUTER_HPP
 
+#include <chrono>
+#include <concepts>
 #include <functional>
+#include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -25,32 +29,82 @@
 
 #include <vix/json/Simple.hpp>
 
+#include <vix/webrpc/AdaptiveLimit.hpp>
+#include <vix/webrpc/Admission.hpp>
 #include <vix/webrpc/Context.hpp>
 #include <vix/webrpc/Error.hpp>
+#include <vix/webrpc/Handler.hpp>
+#include <vix/webrpc/MemoryBudget.hpp>
+#include <vix/webrpc/MicroBatcher.hpp>
+#include <vix/webrpc/Priority.hpp>
 #include <vix/webrpc/Request.hpp>
+#include <vix/webrpc/detail/StringHash.hpp>
 
 namespace vix::webrpc
 {
   /**
-   * @brief Result of an RPC handler.
+   * @brief Per-method registration options.
    *
    * @details
-   * Handlers return either:
-   * - a JSON-like token (success payload)
-   * - or a structured RpcError (failure)
-   *
-   * This keeps control flow explicit and exception-free.
+   * Options are declared once, at registration time, and read by the dispatch path.
+   * Default-constructed options describe a plain method with no policy attached.
    */
-  using RpcResult = std::variant<vix::json::token, RpcError>;
+  struct MethodOptions
+  {
+    /// Admission limits enforced before the handler runs.
+    MethodLimits limits{};
+
+    /// Latency-driven concurrency limit (disabled by default).
+    AdaptiveLimitOptions adaptive{};
+
+    /// Scheduling class used by the asynchronous dispatch path.
+    Priority priority{Priority::normal};
+
+    /**
+     * @brief The handler result depends only on method and params.
+     *
+     * @details
+     * Lets the dispatcher merge identical concurrent calls into one execution.
+     * Do not set it on handlers that read the call id, metadata or transport.
+     */
+    bool idempotent{false};
+
+    /**
+     * @brief Time to live of cached results (0 = not cached).
+     *
+     * @details
+     * Only effective when the dispatcher has a result cache (`DispatcherOptions::cache`).
+     * Successful results are cached under method + params; errors never are.
+     * Same purity requirement as `idempotent`.
+     */
+    std::chrono::milliseconds cache_ttl{0};
+
+    /// Gather concurrent single calls into batch handler invocations (`add_batch()` only).
+    MicroBatchOptions micro_batch{};
+
+    /// Memory budget of one call in bytes (0 = `DispatcherLimits::max_request_memory`).
+    std::size_t memory_budget{0};
+  };
 
   /**
-   * @brief RPC method handler signature.
+   * @brief A registered method: handler, options and runtime state.
    *
    * @details
-   * A handler receives an execution Context and returns an RpcResult.
-   * Handlers should validate their own input schema (params shape and types).
+   * Runtime state (admission gate, adaptive limiter) is kept behind shared ownership
+   * because it holds atomics (non-movable) and must keep a stable address while calls
+   * are in flight. State is only allocated when the matching option is enabled, except
+   * the memory high-water mark (three counters), since budgets are set on the dispatcher.
    */
-  using RpcHandler = std::function<RpcResult(const Context &)>;
+  struct RouterMethod
+  {
+    RpcHandler handler{};
+    RpcBatchHandler batch{};
+    MethodOptions options{};
+    std::shared_ptr<AdmissionGate> admission{};
+    std::shared_ptr<AdaptiveLimiter> adaptive{};
+    std::shared_ptr<MicroBatcher> micro{};
+    std::shared_ptr<MemoryUsage> memory{std::make_shared<MemoryUsage>()};
+  };
 
   /**
    * @brief Registry and dispatcher for WebRPC methods.
@@ -81,7 +135,48 @@ namespace vix::webrpc
      */
     void add(std::string name, RpcHandler handler)
     {
-      handlers_[std::move(name)] = std::move(handler);
+      add(std::move(name), std::move(handler), MethodOptions{});
+    }
+
+    /**
+     * @brief Register (or replace) an RPC method handler with options.
+     *
+     * @param name    Method name (e.g. "user.get").
+     * @param handler Callable handling this method.
+     * @param options Per-method policy (admission limits, ...).
+     */
+    void add(std::string name, RpcHandler handler, MethodOptions options)
+    {
+      RouterMethod m;
+      m.handler = std::move(handler);
+      if (options.limits.enabled())
+        m.admission = std::make_shared<AdmissionGate>(options.limits);
+      if (options.adaptive.enabled)
+        m.adaptive = std::make_shared<AdaptiveLimiter>(options.adaptive);
+      if (options.micro_batch.enabled)
+        m.micro = std::make_shared<MicroBatcher>(options.micro_batch);
+      m.options = std::move(options);
+
+      handlers_[std::move(name)] = std::move(m);
+    }
+
+    /**
+     * @brief Register (or replace) a method served by a vectorized handler.
+     *
+     * @param name    Method name (e.g. "user.get").
+     * @param batch   Callable handling every call of this method in a batch at once.
+     * @param options Per-method policy.
+     *
+     * @details
+     * The dispatcher groups the batch items of this method into one call of `batch`
+     * and scatters the results back to their positions. Single calls are served by
+     * the same handler with a span of one, or gathered with concurrent single calls
+     * when `MethodOptions::micro_batch` is enabled.
+     */
+    void add_batch(std::string name, RpcBatchHandler batch, MethodOptions options = {})
+    {
+      add(name, RpcHandler{}, std::move(options));
+      handlers_.find(name)->second.batch = std::move(batch);
     }
 
     /**
@@ -92,7 +187,12 @@ namespace vix::webrpc
      */
     bool remove(std::string_view name)
     {
-      return handlers_.erase(std::string(name)) > 0;
+      const auto it = handlers_.find(name);
+      if (it == handlers_.end())
+        return false;
+
+      handlers_.erase(it);
+      return true;
     }
 
     /**
@@ -111,15 +211,43 @@ namespace vix::webrpc
      */
     bool has(std::string_view name) const noexcept
     {
-      return handlers_.find(std::string(name)) != handlers_.end();
+      return handlers_.find(name) != handlers_.end();
+    }
+
+    /**
+     * @brief Resolve a registered method.
+     *
+     * @param name Method name.
+     * @return Pointer to the registration, or nullptr if unknown.
+     *
+     * @note
+     * The pointer stays valid until the method is replaced or removed.
+     */
+    const RouterMethod *find(std::string_view name) const noexcept
+    {
+      const auto it = handlers_.find(name);
+      return it == handlers_.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * @brief Visit every registered method.
+     *
+     * @param fn Callable invoked as `fn(std::string_view name, const RouterMethod&)`.
+     */
+    template <typename Fn>
+    void for_each(Fn &&fn) const
+    {
+      for (const auto &[name, m] : handlers_)
+        fn(std::string_view(name), m);
     }
 
     /**
      * @brief Dispatch a parsed request to its handler.
      *
-     * @param req       Parsed request.
+     * @param req       Parsed request (`RpcRequest` or `pmr::RpcRequest`).
      * @param transport Optional transport label (e.g. "http", "websocket", "p2p").
-     * @param meta      Optional metadata map (e.g. headers, peer id).
+     * @param meta      Optional metadata view (e.g. headers, peer id).
+     * @param arena     Optional per-request memory resource (see `Context::arena`).
      * @return RpcResult containing either a success token or an RpcError.
      *
      * @details
@@ -129,26 +257,62 @@ namespace vix::webrpc
      * - builds a Context view (zero-copy)
      * - executes the handler
      */
-    RpcResult dispatch(const RpcRequest &req,
+    template <typename Allocator>
+    RpcResult dispatch(const BasicRpcRequest<Allocator> &req,
                        std::string_view transport = {},
-                       const Context::MetaMap *meta = nullptr) const
+                       const MetaView *meta = nullptr,
+                       std::pmr::memory_resource *arena = nullptr) const
     {
       if (!req.valid())
         return RpcError::invalid_params("invalid rpc request");
 
-      auto it = handlers_.find(req.method);
-      if (it == handlers_.end())
+      const RouterMethod *m = find(req.method);
+      if (!m)
         return RpcError::method_not_found(req.method);
 
+      return invoke(*m, req, transport, meta, arena);
+    }
+
+    /**
+     * @brief Execute an already resolved method.
+     *
+     * @param m         Registration returned by `find()`.
+     * @param req       Parsed request.
+     * @param transport Optional transport label.
+     * @param meta      Optional metadata view.
+     * @param arena     Optional per-request memory resource.
+     * @param owned     Optional params the handler may take (`&req.params`, see
+     *                  `Context::take_params()`).
+     * @return Handler result.
+     *
+     * @details
+     * Used by the dispatcher, which resolves the method once to apply its policy
+     * (admission, ...) and then runs the handler without a second lookup.
+     */
+    template <typename Allocator>
+    static RpcResult invoke(const RouterMethod &m,
+                            const BasicRpcRequest<Allocator> &req,
+                            std::string_view transport = {},
+                            const MetaView *meta = nullptr,
+                            std::pmr::memory_resource *arena = nullptr,
+                            vix::json::token *owned = nullptr)
+    {
       Context ctx{
           req.method,
           req.params,
           req.id,
           transport,
           meta,
+          arena,
+          owned,
       };
 
-      return it->second(ctx);
+      if (m.handler)
+        return m.handler(ctx);
+
+      RpcResult out{};
+      m.batch(std::span<const Context>(&ctx, 1), std::span<RpcResult>(&out, 1));
+      return out;
     }
 
     /**
@@ -156,7 +320,7 @@ namespace vix::webrpc
      *
      * @param raw      Raw JSON token representing a request object.
      * @param transport Optional transport label.
-     * @param meta     Optional metadata map.
+     * @param meta     Optional metadata view.
      * @return RpcResult containing either a success token or an RpcError.
      *
      * @note
@@ -165,7 +329,7 @@ namespace vix::webrpc
      */
     RpcResult dispatch(const vix::json::token &raw,
                        std::string_view transport = {},
-                       const Context::MetaMap *meta = nullptr) const
+                       const MetaView *meta = nullptr) const
     {
       auto parsed = RpcRequest::parse(raw);
       if (std::holds_alternative<RpcError>(parsed))
@@ -174,8 +338,28 @@ namespace vix::webrpc
       return dispatch(std::get<RpcRequest>(parsed), transport, meta);
     }
 
+    /**
+     * @brief `dispatch()` with metadata held in a `Context::MetaMap`.
+     *
+     * @details
+     * The map is viewed for the call (a `MetaView` over its entries), not copied.
+     * `Payload` is a parsed request or a raw request token.
+     */
+    template <typename Payload, typename Map>
+      requires std::same_as<Map, Context::MetaMap>
+    RpcResult dispatch(const Payload &req,
+                       std::string_view transport,
+                       const Map *meta) const
+    {
+      if (!meta)
+        return dispatch(req, transport);
+
+      const MetaView view = MetaView::of(*meta);
+      return dispatch(req, transport, &view);
+    }
+
   private:
-    std::unordered_map<std::string, RpcHandler> handlers_;
+    std::unordered_map<std::string, RouterMethod, detail::string_hash, std::equal_to<>> handlers_;
   };
 
 } // namespace vix::webrpc
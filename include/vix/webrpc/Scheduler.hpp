@@ -0,0 +1,614 @@
+/**
+ *
+ *  @file Scheduler.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_SCHEDULER_HPP
+#define VIX_WEBRPC_SCHEDULER_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <vix/webrpc/Priority.hpp>
+#include <vix/webrpc/detail/StringHash.hpp>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief How the scheduler picks the next class to serve.
+   */
+  enum class SchedulingPolicy : std::uint8_t
+  {
+    /// Always serve the highest non-empty class (aging still prevents starvation).
+    strict,
+
+    /// Weighted round robin between non-empty classes (see `SchedulerOptions::weights`).
+    weighted,
+  };
+
+  /**
+   * @brief Scheduler configuration.
+   */
+  struct SchedulerOptions
+  {
+    /// Worker threads (0 = hardware concurrency).
+    std::size_t workers{0};
+
+    /// Class selection policy.
+    SchedulingPolicy policy{SchedulingPolicy::weighted};
+
+    /// Tasks served per round, per class (weighted policy only).
+    std::array<unsigned, priority_count> weights{8, 4, 1};
+
+    /// A task queued longer than this is served before any younger task (0 = no aging).
+    std::chrono::milliseconds aging{200};
+
+    /**
+     * @brief Picks made by the class policy between two aged picks (0 = aged tasks always go first).
+     *
+     * @details
+     * Bounds the share of service aging takes: under a backlog older than `aging`,
+     * every queued task is aged, and serving them all first would turn the
+     * scheduler into one global FIFO. With the default, at most one pick in five
+     * goes to an aged task; the others follow `policy`.
+     */
+    std::size_t aging_interval{4};
+
+    /// Deficit added to a client each time its turn comes (fair queuing quantum, clamped to >= 1).
+    std::size_t fair_quantum{1};
+
+    /// Maximum queued tasks per client across all classes (0 = unbounded).
+    std::size_t max_queued_per_client{0};
+  };
+
+  /**
+   * @brief Outcome of `Scheduler::submit()`.
+   */
+  enum class SubmitStatus : std::uint8_t
+  {
+    /// Task queued.
+    accepted,
+
+    /// Scheduler is shutting down; task not queued.
+    stopped,
+
+    /// The client already has `max_queued_per_client` tasks queued; task not queued.
+    client_full,
+  };
+
+  /**
+   * @brief Lock-free log2 histogram of durations in microseconds.
+   *
+   * @details
+   * Bucket `i` counts samples in `[2^(i-1), 2^i)` microseconds (bucket 0 counts `< 1us`).
+   * Percentiles are reported as the upper bound of the matching bucket.
+   */
+  class DelayHistogram
+  {
+  public:
+    static constexpr std::size_t buckets = 40;
+
+    void record(std::chrono::nanoseconds d) noexcept
+    {
+      const auto us = static_cast<std::uint64_t>(d.count() > 0 ? d.count() / 1000 : 0);
+      std::size_t b = 0;
+      while (b + 1 < buckets && (std::uint64_t{1} << b) <= us)
+        ++b;
+
+      counts_[b].fetch_add(1, std::memory_order_relaxed);
+      count_.fetch_add(1, std::memory_order_relaxed);
+
+      std::uint64_t cur = max_us_.load(std::memory_order_relaxed);
+      while (us > cur && !max_us_.compare_exchange_weak(cur, us, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    std::uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+    std::uint64_t max_us() const noexcept { return max_us_.load(std::memory_order_relaxed); }
+
+    /// Upper bound (microseconds) below which `q` of the samples fall, `q` in [0, 1].
+    std::uint64_t percentile_us(double q) const noexcept
+    {
+      const std::uint64_t total = count();
+      if (total == 0)
+        return 0;
+
+      const auto target = static_cast<std::uint64_t>(q * static_cast<double>(total));
+      std::uint64_t seen = 0;
+      for (std::size_t b = 0; b < buckets; ++b)
+      {
+        seen += counts_[b].load(std::memory_order_relaxed);
+        if (seen > target || seen == total)
+          return std::min<std::uint64_t>(std::uint64_t{1} << b, max_us());
+      }
+      return max_us();
+    }
+
+  private:
+    std::array<std::atomic<std::uint64_t>, buckets> counts_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> max_us_{0};
+  };
+
+  /**
+   * @brief Per-class scheduler counters.
+   */
+  struct ClassStats
+  {
+    std::uint64_t submitted{0};
+    std::uint64_t started{0};
+    std::size_t queued{0};
+    std::uint64_t aged{0};
+
+    /// Tasks that ended by throwing (the worker keeps running).
+    std::uint64_t failed{0};
+
+    /// Tasks refused because their client queue was full.
+    std::uint64_t rejected{0};
+
+    /// Clients with queued work in this class.
+    std::size_t clients{0};
+
+    /// Queueing delay (submit -> start), microseconds.
+    std::uint64_t delay_p50_us{0};
+    std::uint64_t delay_p99_us{0};
+    std::uint64_t delay_max_us{0};
+  };
+
+  /**
+   * @brief Priority-aware, client-fair worker pool for dispatching calls.
+   *
+   * @details
+   * Tasks are queued per priority class and served by a fixed set of worker threads:
+   * - `strict`: highest class first
+   * - `weighted`: weighted round robin across non-empty classes
+   *
+   * In both modes, a task that has been queued longer than `aging` is served next,
+   * so low classes cannot starve; at most one pick in `aging_interval + 1` goes to
+   * an aged task, so a sustained aged backlog cannot push higher classes behind it.
+   * Queueing delay is recorded per class.
+   *
+   * Inside a class, tasks are grouped by client key and served with deficit round
+   * robin (DRR): each client with queued work receives `fair_quantum` of deficit per
+   * turn and spends it on the cost of its tasks. A client sending a huge batch only
+   * gets its share of turns instead of blocking everyone queued behind it.
+   * Queued work is bounded per client (`max_queued_per_client`).
+   *
+   * A task that throws is counted in `ClassStats::failed` and its exception is
+   * dropped; tasks that must answer someone should catch on their own.
+   *
+   * @note
+   * The destructor stops accepting tasks, drains every queued task and joins workers.
+   */
+  class Scheduler
+  {
+  public:
+    using Task = std::function<void()>;
+
+    explicit Scheduler(SchedulerOptions options = {})
+        : options_(options)
+    {
+      std::size_t n = options_.workers;
+      if (n == 0)
+        n = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+      // Every task costs at least 1: a zero quantum would never let a client pay.
+      options_.fair_quantum = std::max<std::size_t>(1, options_.fair_quantum);
+
+      credits_ = options_.weights;
+      since_aged_ = options_.aging_interval;
+      workers_.reserve(n);
+      for (std::size_t i = 0; i < n; ++i)
+        workers_.emplace_back([this]
+                              { run(); });
+    }
+
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    ~Scheduler()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mu_);
+        stopping_ = true;
+      }
+      cv_.notify_all();
+
+      for (auto &w : workers_)
+        w.join();
+    }
+
+    /// Configuration used by this scheduler.
+    const SchedulerOptions &options() const noexcept { return options_; }
+
+    /// Number of worker threads.
+    std::size_t workers() const noexcept { return workers_.size(); }
+
+    /**
+     * @brief Queue an anonymous task in a priority class.
+     *
+     * @return `accepted`, or the reason the task was not queued. When not accepted,
+     *         `task` is left untouched so the caller can still run or drop it.
+     */
+    SubmitStatus submit(Priority p, Task &&task)
+    {
+      return submit(p, std::string_view{}, std::move(task));
+    }
+
+    /**
+     * @brief Queue a task on behalf of a client.
+     *
+     * @param p      Priority class.
+     * @param client Client key (tenant, peer id, ...). Empty = anonymous client.
+     * @param task   Work to run.
+     * @param cost   Deficit consumed by the task (>= 1).
+     *
+     * @return `accepted`, or the reason the task was not queued. When not accepted,
+     *         `task` is left untouched so the caller can still run or drop it.
+     */
+    SubmitStatus submit(Priority p, std::string_view client, Task &&task, std::size_t cost = 1)
+    {
+      const auto c = static_cast<std::size_t>(p);
+      {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (stopping_)
+          return SubmitStatus::stopped;
+
+        auto dit = depth_.find(client);
+        if (dit == depth_.end())
+          dit = depth_.emplace(std::string(client), 0).first;
+
+        if (options_.max_queued_per_client > 0 && dit->second >= options_.max_queued_per_client)
+        {
+          rejected_[c].fetch_add(1, std::memory_order_relaxed);
+          return SubmitStatus::client_full;
+        }
+
+        ++dit->second;
+        queues_[c].push(dit->first, Entry{std::move(task), std::chrono::steady_clock::now(),
+                                          cost > 0 ? cost : 1});
+      }
+
+      submitted_[c].fetch_add(1, std::memory_order_relaxed);
+      cv_.notify_one();
+      return SubmitStatus::accepted;
+    }
+
+    /**
+     * @brief Number of tasks currently queued for a client (all classes).
+     */
+    std::size_t queue_depth(std::string_view client) const
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      const auto it = depth_.find(client);
+      return it == depth_.end() ? 0 : it->second;
+    }
+
+    /**
+     * @brief Queue depth of every client that currently has queued work.
+     */
+    std::vector<std::pair<std::string, std::size_t>> client_depths() const
+    {
+      std::vector<std::pair<std::string, std::size_t>> out;
+
+      std::lock_guard<std::mutex> lock(mu_);
+      out.reserve(depth_.size());
+      for (const auto &[client, depth] : depth_)
+        out.emplace_back(client, depth);
+      return out;
+    }
+
+    /// Counters and queueing delay of one class.
+    ClassStats stats(Priority p) const
+    {
+      const auto c = static_cast<std::size_t>(p);
+
+      ClassStats s;
+      s.submitted = submitted_[c].load(std::memory_order_relaxed);
+      s.started = started_[c].load(std::memory_order_relaxed);
+      s.aged = aged_[c].load(std::memory_order_relaxed);
+      s.failed = failed_[c].load(std::memory_order_relaxed);
+      s.rejected = rejected_[c].load(std::memory_order_relaxed);
+      s.delay_p50_us = delay_[c].percentile_us(0.50);
+      s.delay_p99_us = delay_[c].percentile_us(0.99);
+      s.delay_max_us = delay_[c].max_us();
+
+      std::lock_guard<std::mutex> lock(mu_);
+      s.queued = queues_[c].size();
+      s.clients = queues_[c].clients();
+      return s;
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+      Task task;
+      Clock::time_point enqueued;
+      std::size_t cost{1};
+    };
+
+    /**
+     * @brief One priority class: per-client FIFOs served by deficit round robin.
+     *
+     * @details
+     * Client queues live in a node-based map (stable addresses); `active_` holds the
+     * round-robin order of clients that currently have work. A client leaves the map
+     * as soon as its queue drains, so idle clients cost nothing.
+     */
+    class FairQueue
+    {
+    public:
+      void push(std::string_view client, Entry e)
+      {
+        auto it = clients_.find(client);
+        if (it == clients_.end())
+          it = clients_.emplace(std::string(client), ClientQueue{}).first;
+
+        ClientQueue &cq = it->second;
+        if (cq.entries.empty())
+        {
+          cq.key = it->first;
+          active_.push_back(&cq);
+        }
+
+        cq.entries.push_back(std::move(e));
+        ++size_;
+      }
+
+      bool empty() const noexcept { return size_ == 0; }
+      std::size_t size() const noexcept { return size_; }
+      std::size_t clients() const noexcept { return active_.size(); }
+
+      /// Enqueue time of the oldest task in this class (class must not be empty).
+      Clock::time_point oldest() const noexcept
+      {
+        Clock::time_point t = Clock::time_point::max();
+        for (const ClientQueue *cq : active_)
+          t = std::min(t, cq->entries.front().enqueued);
+        return t;
+      }
+
+      /**
+       * @brief Pop the next task.
+       *
+       * @param quantum      Deficit granted per turn.
+       * @param oldest_first Serve the client holding the oldest task (aging) instead of DRR.
+       * @param client       Receives the client key of the popped task.
+       */
+      Entry pop(std::size_t quantum, bool oldest_first, std::string &client)
+      {
+        ClientQueue *cq = oldest_first ? take_oldest() : take_next(quantum);
+
+        Entry e = std::move(cq->entries.front());
+        cq->entries.pop_front();
+        --size_;
+        client = cq->key;
+
+        if (cq->entries.empty())
+        {
+          active_.erase(std::find(active_.begin(), active_.end(), cq));
+          clients_.erase(clients_.find(cq->key));
+        }
+
+        return e;
+      }
+
+    private:
+      struct ClientQueue
+      {
+        std::string_view key{};
+        std::deque<Entry> entries{};
+        std::size_t deficit{0};
+        bool in_turn{false};
+      };
+
+      ClientQueue *take_next(std::size_t quantum)
+      {
+        for (;;)
+        {
+          ClientQueue *cq = active_.front();
+          if (!cq->in_turn)
+          {
+            cq->deficit += quantum;
+            cq->in_turn = true;
+          }
+
+          const std::size_t cost = cq->entries.front().cost;
+          if (cq->deficit >= cost)
+          {
+            cq->deficit -= cost;
+            if (cq->entries.size() == 1)
+            {
+              cq->deficit = 0;
+              cq->in_turn = false;
+            }
+            return cq;
+          }
+
+          // Turn over: move to the back of the round.
+          cq->in_turn = false;
+          active_.pop_front();
+          active_.push_back(cq);
+        }
+      }
+
+      ClientQueue *take_oldest()
+      {
+        ClientQueue *best = active_.front();
+        for (ClientQueue *cq : active_)
+        {
+          if (cq->entries.front().enqueued < best->entries.front().enqueued)
+            best = cq;
+        }
+        return best;
+      }
+
+      std::unordered_map<std::string, ClientQueue, detail::string_hash, std::equal_to<>> clients_{};
+      std::deque<ClientQueue *> active_{};
+      std::size_t size_{0};
+    };
+
+    void run()
+    {
+      std::string client;
+
+      for (;;)
+      {
+        Entry e;
+        std::size_t c = 0;
+
+        {
+          std::unique_lock<std::mutex> lock(mu_);
+          cv_.wait(lock, [this]
+                   { return stopping_ || !empty(); });
+
+          if (empty())
+            return;
+
+          bool aged = false;
+          c = pick(Clock::now(), aged);
+          e = queues_[c].pop(options_.fair_quantum, aged, client);
+
+          const auto dit = depth_.find(client);
+          if (dit != depth_.end() && --dit->second == 0)
+            depth_.erase(dit);
+        }
+
+        delay_[c].record(Clock::now() - e.enqueued);
+        started_[c].fetch_add(1, std::memory_order_relaxed);
+
+        try
+        {
+          e.task();
+        }
+        catch (...)
+        {
+          failed_[c].fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+
+    bool empty() const noexcept
+    {
+      for (const auto &q : queues_)
+        if (!q.empty())
+          return false;
+      return true;
+    }
+
+    // Called with `mu_` held and at least one non-empty queue.
+    std::size_t pick(Clock::time_point now, bool &aged)
+    {
+      aged = false;
+
+      if (options_.aging.count() > 0 && since_aged_ >= options_.aging_interval)
+      {
+        std::size_t oldest = priority_count;
+        Clock::time_point oldest_t{};
+        for (std::size_t c = 0; c < priority_count; ++c)
+        {
+          if (queues_[c].empty())
+            continue;
+
+          const Clock::time_point t = queues_[c].oldest();
+          if (now - t < options_.aging)
+            continue;
+          if (oldest == priority_count || t < oldest_t)
+          {
+            oldest = c;
+            oldest_t = t;
+          }
+        }
+
+        if (oldest != priority_count)
+        {
+          if (oldest != first_non_empty())
+            aged_[oldest].fetch_add(1, std::memory_order_relaxed);
+          aged = true;
+          since_aged_ = 0;
+          return oldest;
+        }
+      }
+
+      if (since_aged_ < options_.aging_interval)
+        ++since_aged_;
+
+      if (options_.policy == SchedulingPolicy::strict)
+        return first_non_empty();
+
+      for (int round = 0; round < 2; ++round)
+      {
+        for (std::size_t c = 0; c < priority_count; ++c)
+        {
+          if (!queues_[c].empty() && credits_[c] > 0)
+          {
+            --credits_[c];
+            return c;
+          }
+        }
+
+        credits_ = options_.weights;
+      }
+
+      return first_non_empty();
+    }
+
+    std::size_t first_non_empty() const noexcept
+    {
+      for (std::size_t c = 0; c < priority_count; ++c)
+        if (!queues_[c].empty())
+          return c;
+      return 0;
+    }
+
+    SchedulerOptions options_{};
+
+    mutable std::mutex mu_;
+    std::condition_variable cv_;
+    std::array<FairQueue, priority_count> queues_{};
+    std::unordered_map<std::string, std::size_t, detail::string_hash, std::equal_to<>> depth_{};
+    std::array<unsigned, priority_count> credits_{};
+    std::size_t since_aged_{0};
+    bool stopping_{false};
+
+    std::array<std::atomic<std::uint64_t>, priority_count> submitted_{};
+    std::array<std::atomic<std::uint64_t>, priority_count> started_{};
+    std::array<std::atomic<std::uint64_t>, priority_count> aged_{};
+    std::array<std::atomic<std::uint64_t>, priority_count> failed_{};
+    std::array<std::atomic<std::uint64_t>, priority_count> rejected_{};
+    std::array<DelayHistogram, priority_count> delay_{};
+
+    std::vector<std::thread> workers_;
+  };
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_SCHEDULER_HPP
@@ -0,0 +1,440 @@
+/**
+ *
+ *  @file ShardedRuntime.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_SHARDED_RUNTIME_HPP
+#define VIX_WEBRPC_SHARDED_RUNTIME_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <vix/json/Simple.hpp>
+
+#include <vix/webrpc/Context.hpp>
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Hash.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/webrpc/detail/SpscQueue.hpp>
+
+namespace vix::webrpc
+{
+  /**
+   * @brief Configuration of a sharded (thread-per-core) runtime.
+   */
+  struct ShardedRuntimeOptions
+  {
+    /// Number of shards, one thread each (0 = hardware concurrency).
+    std::size_t shards{0};
+
+    /// Pin each shard thread to one CPU (Linux only; ignored elsewhere).
+    bool pin{true};
+
+    /// CPU of shard `i` is `cpus[i % cpus.size()]` (empty = CPU `i % hardware threads`).
+    std::vector<int> cpus{};
+
+    /// Number of producer ports (threads submitting work, e.g. IO threads).
+    std::size_t producers{1};
+
+    /// Capacity of each producer -> shard queue (rounded up to a power of two).
+    std::size_t queue_capacity{1024};
+
+    /// Options of every shard dispatcher (each shard gets its own copy).
+    DispatcherOptions dispatcher{};
+  };
+
+  /**
+   * @brief Counters of one shard.
+   */
+  struct ShardStats
+  {
+    /// CPU the shard thread is pinned to (-1 = not pinned).
+    int cpu{-1};
+
+    /// Payloads handled.
+    std::uint64_t processed{0};
+
+    /// Times the shard went to sleep on empty queues.
+    std::uint64_t parks{0};
+  };
+
+  /**
+   * @brief Shared-nothing dispatcher runtime: N shards, one pinned thread each.
+   *
+   * @details
+   * Every shard owns, on its own thread:
+   * - a router built by the setup callback (its own admission gates, adaptive
+   *   limiters, micro-batchers)
+   * - a dispatcher (its own coalescer, result cache and counters)
+   * - one inbound SPSC queue per producer port
+   *
+   * Router and dispatcher are created on the shard thread after pinning, so their
+   * memory is first touched (and placed) by the core that uses it. Work is routed
+   * by connection: `shard_of(connection)` is a fixed hash, so all payloads of one
+   * connection run in order on one shard and its state never crosses cores.
+   *
+   * The hot path holds no lock and shares no mutable state: a producer writes into
+   * its own queue of the target shard, the shard polls its queues and runs payloads
+   * inline with `Dispatcher::handle()`. An idle shard spins briefly, then parks on
+   * an atomic; producers wake it only when it is parked.
+   *
+   * @note
+   * Completions run on the shard thread. The destructor stops the shards after
+   * draining every queued payload.
+   */
+  class ShardedRuntime
+  {
+  public:
+    /// Builds the router of one shard (called once per shard, one at a time).
+    using RouterSetup = std::function<void(Router &)>;
+
+    /**
+     * @brief A producer's handle for submitting work.
+     *
+     * @details
+     * Each port must be used by a single thread at a time (it is the producer side
+     * of one SPSC queue per shard).
+     */
+    class Port
+    {
+    public:
+      /**
+       * @brief Queue a payload on the shard of a connection.
+       *
+       * @param connection Connection key (same key = same shard, in order).
+       * @param payload    Request token (object or array).
+       * @param done       Invoked on the shard thread with what `handle()` returned.
+       * @param transport  Optional transport label (must outlive the completion).
+       * @param meta       Optional metadata view (must outlive the completion).
+       *
+       * @return False if the shard queue of this port is full (nothing queued).
+       */
+      bool submit(std::uint64_t connection,
+                  vix::json::token payload,
+                  DispatchCompletion done,
+                  std::string_view transport = {},
+                  const MetaView *meta = nullptr)
+      {
+        Shard &s = *owner_->shards_[owner_->shard_of(connection)];
+
+        Job job{std::move(payload), std::move(done), transport, meta};
+        if (!s.inbox[index_]->try_push(std::move(job)))
+          return false;
+
+        s.wake();
+        return true;
+      }
+
+      /// Index of this port.
+      std::size_t index() const noexcept { return index_; }
+
+    private:
+      friend class ShardedRuntime;
+
+      Port(ShardedRuntime *owner, std::size_t index) noexcept
+          : owner_(owner), index_(index)
+      {
+      }
+
+      ShardedRuntime *owner_;
+      std::size_t index_;
+    };
+
+    /**
+     * @brief Start the shards.
+     *
+     * @param setup   Registers the methods of one shard router.
+     * @param options Runtime configuration.
+     *
+     * @details
+     * Returns once every shard is pinned and has built its router and dispatcher.
+     */
+    explicit ShardedRuntime(RouterSetup setup, ShardedRuntimeOptions options = {})
+        : options_(std::move(options)), setup_(std::move(setup))
+    {
+      const std::size_t hw = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+      const std::size_t n = options_.shards == 0 ? hw : options_.shards;
+      const std::size_t producers = std::max<std::size_t>(1, options_.producers);
+
+      shards_.reserve(n);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        auto s = std::make_unique<Shard>();
+        s->inbox.reserve(producers);
+        for (std::size_t p = 0; p < producers; ++p)
+          s->inbox.push_back(std::make_unique<detail::SpscQueue<Job>>(options_.queue_capacity));
+        shards_.push_back(std::move(s));
+      }
+
+      ports_.reserve(producers);
+      for (std::size_t p = 0; p < producers; ++p)
+        ports_.push_back(Port(this, p));
+
+      std::latch ready(static_cast<std::ptrdiff_t>(n));
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        const int cpu = options_.pin ? cpu_for(i, hw) : -1;
+        shards_[i]->thread = std::thread([this, i, cpu, &ready]
+                                         { run(*shards_[i], cpu, ready); });
+      }
+      ready.wait();
+    }
+
+    ShardedRuntime(const ShardedRuntime &) = delete;
+    ShardedRuntime &operator=(const ShardedRuntime &) = delete;
+
+    ~ShardedRuntime() { stop(); }
+
+    /// Number of shards.
+    std::size_t shard_count() const noexcept { return shards_.size(); }
+
+    /// Shard serving a connection.
+    std::size_t shard_of(std::uint64_t connection) const noexcept
+    {
+      return static_cast<std::size_t>(detail::mix(connection) % shards_.size());
+    }
+
+    /// Producer port `i` (`0 <= i < ShardedRuntimeOptions::producers`).
+    Port &port(std::size_t i) noexcept { return ports_[i]; }
+
+    /// Dispatcher of a shard (for its counters; handlers run on the shard thread).
+    const Dispatcher &dispatcher(std::size_t shard) const noexcept
+    {
+      return *shards_[shard]->dispatcher;
+    }
+
+    /// Counters of a shard.
+    ShardStats stats(std::size_t shard) const noexcept
+    {
+      const Shard &s = *shards_[shard];
+
+      ShardStats st;
+      st.cpu = s.cpu.load(std::memory_order_relaxed);
+      st.processed = s.processed.load(std::memory_order_relaxed);
+      st.parks = s.parks.load(std::memory_order_relaxed);
+      return st;
+    }
+
+    /**
+     * @brief Drain every queue and join the shard threads (idempotent).
+     *
+     * @note
+     * Producers must have stopped submitting.
+     */
+    void stop()
+    {
+      for (auto &s : shards_)
+      {
+        if (!s->thread.joinable())
+          continue;
+        s->stopping.store(true, std::memory_order_release);
+        s->wake(true);
+      }
+
+      for (auto &s : shards_)
+      {
+        if (s->thread.joinable())
+          s->thread.join();
+      }
+    }
+
+  private:
+    struct Job
+    {
+      vix::json::token payload{nullptr};
+      DispatchCompletion done{};
+      std::string_view transport{};
+      const MetaView *meta{nullptr};
+    };
+
+    struct alignas(detail::cache_line) Shard
+    {
+      std::vector<std::unique_ptr<detail::SpscQueue<Job>>> inbox;
+
+      std::unique_ptr<Router> router;
+      std::unique_ptr<Dispatcher> dispatcher;
+      std::thread thread;
+
+      alignas(detail::cache_line) std::atomic<bool> parked{false};
+      std::atomic<bool> stopping{false};
+
+      // Written by the shard thread only.
+      alignas(detail::cache_line) std::atomic<std::uint64_t> processed{0};
+      std::atomic<std::uint64_t> parks{0};
+      std::atomic<int> cpu{-1};
+
+      /// Producer side: wake the shard if it sleeps (`force` for shutdown).
+      void wake(bool force = false)
+      {
+        // Pairs with the fence in `park()`: either the shard sees the new item,
+        // or this load sees `parked == true`.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!force && !parked.load(std::memory_order_relaxed))
+          return;
+
+        parked.store(false, std::memory_order_relaxed);
+        parked.notify_one();
+      }
+
+      bool idle() const noexcept
+      {
+        for (const auto &q : inbox)
+        {
+          if (!q->empty())
+            return false;
+        }
+        return true;
+      }
+    };
+
+    /// Polls before yielding, and yields before parking, when queues are empty.
+    static constexpr unsigned spin_polls = 256;
+    static constexpr unsigned yield_polls = 16;
+
+    /// Payloads taken from one queue before moving to the next (fairness).
+    static constexpr unsigned burst = 64;
+
+    int cpu_for(std::size_t shard, std::size_t hw) const noexcept
+    {
+      if (!options_.cpus.empty())
+        return options_.cpus[shard % options_.cpus.size()];
+      return static_cast<int>(shard % hw);
+    }
+
+    /// Pin the calling thread. @return The CPU, or -1 if not pinned.
+    static int pin_current_thread(int cpu) noexcept
+    {
+#if defined(__linux__)
+      if (cpu < 0 || cpu >= CPU_SETSIZE)
+        return -1;
+
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+      if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+        return -1;
+      return cpu;
+#else
+      (void)cpu;
+      return -1;
+#endif
+    }
+
+    void run(Shard &s, int cpu, std::latch &ready)
+    {
+      s.cpu.store(pin_current_thread(cpu), std::memory_order_relaxed);
+
+      {
+        std::lock_guard<std::mutex> lock(setup_mu_);
+        s.router = std::make_unique<Router>();
+        if (setup_)
+          setup_(*s.router);
+      }
+      s.dispatcher = std::make_unique<Dispatcher>(*s.router, options_.dispatcher);
+      ready.count_down();
+
+      unsigned idle = 0;
+      while (true)
+      {
+        if (poll(s))
+        {
+          idle = 0;
+          continue;
+        }
+
+        if (s.stopping.load(std::memory_order_acquire))
+        {
+          while (poll(s))
+          {
+          }
+          return;
+        }
+
+        if (++idle < spin_polls)
+          continue;
+
+        if (idle < spin_polls + yield_polls)
+        {
+          std::this_thread::yield();
+          continue;
+        }
+
+        park(s);
+        idle = 0;
+      }
+    }
+
+    /// Run what is queued. @return True if anything ran.
+    bool poll(Shard &s) const
+    {
+      bool any = false;
+      Job job;
+
+      for (auto &q : s.inbox)
+      {
+        for (unsigned k = 0; k < burst && q->try_pop(job); ++k)
+        {
+          any = true;
+          auto out = s.dispatcher->handle(job.payload, job.transport, job.meta);
+          if (job.done)
+            job.done(std::move(out));
+          s.processed.store(s.processed.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_relaxed);
+        }
+      }
+
+      return any;
+    }
+
+    static void park(Shard &s)
+    {
+      s.parked.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if (!s.idle() || s.stopping.load(std::memory_order_acquire))
+      {
+        s.parked.store(false, std::memory_order_relaxed);
+        return;
+      }
+
+      s.parks.store(s.parks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      s.parked.wait(true, std::memory_order_relaxed);
+    }
+
+    ShardedRuntimeOptions options_;
+    RouterSetup setup_;
+    std::mutex setup_mu_;
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::vector<Port> ports_;
+  };
+
+} // namespace vix::webrpc
+
+#endif // VIX_WEBRPC_SHARDED_RUNTIME_HPP
@@ -0,0 +1,169 @@
+/**
+ *
+ *  @file JsonWriter.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_DETAIL_JSON_WRITER_HPP
+#define VIX_WEBRPC_DETAIL_JSON_WRITER_HPP
+
+#include <charconv>
+#include <cmath>
+#include <string>
+#include <string_view>
+
+#include <vix/json/Simple.hpp>
+
+#include <vix/webrpc/Hash.hpp>
+
+namespace vix::webrpc::detail
+{
+  /**
+   * @brief Append `s` as a JSON string literal (quoted, escaped).
+   *
+   * @details
+   * Runs of characters that need no escaping are appended in one piece.
+   */
+  inline void append_json_string(std::string &out, std::string_view s)
+  {
+    static constexpr char hex[] = "0123456789abcdef";
+
+    out.push_back('"');
+
+    std::size_t run = 0;
+    for (std::size_t i = 0; i < s.size(); ++i)
+    {
+      const unsigned char c = static_cast<unsigned char>(s[i]);
+      if (c >= 0x20 && c != '"' && c != '\\')
+        continue;
+
+      out.append(s.data() + run, i - run);
+      run = i + 1;
+
+      switch (c)
+      {
+      case '"':
+        out.append("\\\"");
+        break;
+      case '\\':
+        out.append("\\\\");
+        break;
+      case '\n':
+        out.append("\\n");
+        break;
+      case '\r':
+        out.append("\\r");
+        break;
+      case '\t':
+        out.append("\\t");
+        break;
+      case '\b':
+        out.append("\\b");
+        break;
+      case '\f':
+        out.append("\\f");
+        break;
+      default:
+        out.append("\\u00");
+        out.push_back(hex[c >> 4]);
+        out.push_back(hex[c & 0xf]);
+        break;
+      }
+    }
+    out.append(s.data() + run, s.size() - run);
+
+    out.push_back('"');
+  }
+
+  /// Append an integer as JSON.
+  inline void append_json_i64(std::string &out, long long v)
+  {
+    char buf[24];
+    const auto r = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, r.ptr);
+  }
+
+  /// Append a double as JSON (shortest round-trip form; `null` if not finite).
+  inline void append_json_f64(std::string &out, double v)
+  {
+    if (!std::isfinite(v))
+    {
+      out.append("null");
+      return;
+    }
+
+    char buf[32];
+    const auto r = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, r.ptr);
+  }
+
+  /**
+   * @brief Append a token tree as compact JSON text.
+   */
+  inline void append_json(std::string &out, const vix::json::token &t)
+  {
+    if (t.is_null())
+    {
+      out.append("null");
+    }
+    else if (t.is_bool())
+    {
+      out.append(t.as_bool_or(false) ? "true" : "false");
+    }
+    else if (t.is_i64())
+    {
+      append_json_i64(out, t.as_i64_or(0));
+    }
+    else if (t.is_f64())
+    {
+      append_json_f64(out, t.as_f64_or(0.0));
+    }
+    else if (const std::string *s = t.as_string())
+    {
+      append_json_string(out, *s);
+    }
+    else if (const auto ap = t.as_array_ptr())
+    {
+      out.push_back('[');
+      bool first = true;
+      for (const auto &e : ap->elems)
+      {
+        if (!first)
+          out.push_back(',');
+        first = false;
+        append_json(out, e);
+      }
+      out.push_back(']');
+    }
+    else if (const auto op = t.as_object_ptr())
+    {
+      out.push_back('{');
+      bool first = true;
+      for_each_member(*op, [&](std::string_view k, const vix::json::token &v)
+                      {
+                        if (!first)
+                          out.push_back(',');
+                        first = false;
+                        append_json_string(out, k);
+                        out.push_back(':');
+                        append_json(out, v); });
+      out.push_back('}');
+    }
+    else
+    {
+      out.append("null");
+    }
+  }
+
+} // namespace vix::webrpc::detail
+
+#endif // VIX_WEBRPC_DETAIL_JSON_WRITER_HPP
@@ -0,0 +1,118 @@
+/**
+ *
+ *  @file SpscQueue.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_DETAIL_SPSC_QUEUE_HPP
+#define VIX_WEBRPC_DETAIL_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace vix::webrpc::detail
+{
+  /// Assumed cache line size (keeps producer and consumer indices apart).
+  inline constexpr std::size_t cache_line = 64;
+
+  /**
+   * @brief Bounded single-producer / single-consumer ring.
+   *
+   * @details
+   * Wait-free on both sides: one acquire load and one release store per operation
+   * in the common case. Each side keeps a private copy of the other side's index
+   * and only reloads the shared one when the ring looks full (producer) or empty
+   * (consumer), so the two cache lines are not bounced on every call.
+   *
+   * Capacity is rounded up to a power of two.
+   */
+  template <typename T>
+  class SpscQueue
+  {
+  public:
+    explicit SpscQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1),
+          slots_(std::make_unique<T[]>(mask_ + 1))
+    {
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    /// Number of slots.
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    /**
+     * @brief Producer side: append a value.
+     *
+     * @return False if the ring is full (`v` is left untouched).
+     */
+    bool try_push(T &&v)
+    {
+      const std::size_t t = tail_.load(std::memory_order_relaxed);
+      if (t - head_cache_ > mask_)
+      {
+        head_cache_ = head_.load(std::memory_order_acquire);
+        if (t - head_cache_ > mask_)
+          return false;
+      }
+
+      slots_[t & mask_] = std::move(v);
+      tail_.store(t + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * @brief Consumer side: take the oldest value.
+     *
+     * @return False if the ring is empty.
+     */
+    bool try_pop(T &out)
+    {
+      const std::size_t h = head_.load(std::memory_order_relaxed);
+      if (h == tail_cache_)
+      {
+        tail_cache_ = tail_.load(std::memory_order_acquire);
+        if (h == tail_cache_)
+          return false;
+      }
+
+      out = std::move(slots_[h & mask_]);
+      head_.store(h + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// True if nothing is queued (exact for the consumer, a hint for others).
+    bool empty() const noexcept
+    {
+      return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+  private:
+    const std::size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    // Consumer line.
+    alignas(cache_line) std::atomic<std::size_t> head_{0};
+    std::size_t tail_cache_{0};
+
+    // Producer line.
+    alignas(cache_line) std::atomic<std::size_t> tail_{0};
+    std::size_t head_cache_{0};
+  };
+
+} // namespace vix::webrpc::detail
+
+#endif // VIX_WEBRPC_DETAIL_SPSC_QUEUE_HPP
@@ -0,0 +1,44 @@
+/**
+ *
+ *  @file StringHash.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ */
+
+#ifndef VIX_WEBRPC_DETAIL_STRING_HASH_HPP
+#define VIX_WEBRPC_DETAIL_STRING_HASH_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+namespace vix::webrpc::detail
+{
+  /**
+   * @brief Transparent string hash.
+   *
+   * @details
+   * Used with `std::equal_to<>` so that `std::unordered_map<std::string, ...>` can be
+   * queried with a `std::string_view` without building a temporary `std::string`.
+   */
+  struct string_hash
+  {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view s) const noexcept
+    {
+      return std::hash<std::string_view>{}(s);
+    }
+  };
+
+} // namespace vix::webrpc::detail
+
+#endif // VIX_WEBRPC_DETAIL_STRING_HASH_HPP
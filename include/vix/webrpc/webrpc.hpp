@@ -23,9 +23,18 @@
  * Include this header to access the full WebRPC surface:
  * - request / response envelopes
  * - structured errors
+ * - structural hashing of params
  * - execution context
  * - router (method registry + dispatch)
  * - dispatcher (single call + batch handling)
+ * - admission control (in-flight and rate limits, adaptive concurrency)
+ * - priority scheduler (asynchronous dispatch path)
+ * - request coalescing and result cache for idempotent methods
+ * - vectorized handlers and micro-batching
+ * - batch pipelining (intra-batch result references)
+ * - sharded thread-per-core runtime
+ * - input limits (batch size, params depth and size, batch CPU budget)
+ * - per-request memory arena
  *
  * WebRPC is transport-agnostic by design. Transport adapters (HTTP/WebSocket/P2P)
  * are expected to live above this module.
@@ -37,12 +46,28 @@
 
 // Core data model
 #include <vix/webrpc/Error.hpp>
+#include <vix/webrpc/Hash.hpp>
+#include <vix/webrpc/Limits.hpp>
+#include <vix/webrpc/Meta.hpp>
+#include <vix/webrpc/Reference.hpp>
 #include <vix/webrpc/Request.hpp>
 #include <vix/webrpc/Response.hpp>
 
 // Execution
+#include <vix/webrpc/AdaptiveLimit.hpp>
+#include <vix/webrpc/Arena.hpp>
+#include <vix/webrpc/BufferPool.hpp>
+#include <vix/webrpc/Admission.hpp>
+#include <vix/webrpc/Coalescer.hpp>
 #include <vix/webrpc/Context.hpp>
+#include <vix/webrpc/Handler.hpp>
+#include <vix/webrpc/MemoryBudget.hpp>
+#include <vix/webrpc/MicroBatcher.hpp>
+#include <vix/webrpc/Priority.hpp>
+#include <vix/webrpc/ResultCache.hpp>
 #include <vix/webrpc/Router.hpp>
+#include <vix/webrpc/Scheduler.hpp>
 #include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/ShardedRuntime.hpp>
 
 #endif // VIX_WEBRPC_WEBRPC_HPP
@@ -0,0 +1,263 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+using namespace std::chrono_literals;
+
+// Holds admitted handlers until opened, so the test controls how many are in flight.
+struct Gate
+{
+  std::mutex mu;
+  std::condition_variable cv;
+  int entered{0};
+  bool open{false};
+
+  /// Handler body: count this call as in flight, then block until opened.
+  void hold()
+  {
+    std::unique_lock<std::mutex> lock(mu);
+    ++entered;
+    cv.notify_all();
+    cv.wait(lock, [&]
+            { return open; });
+  }
+
+  void wait_entered(int n)
+  {
+    std::unique_lock<std::mutex> lock(mu);
+    cv.wait(lock, [&]
+            { return entered == n; });
+  }
+
+  void release()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mu);
+      open = true;
+    }
+    cv.notify_all();
+  }
+};
+
+// Goodput under overload is measured by bench/adaptive_overload.cpp. Here the
+// dispatcher is only checked to shed calls over the limit and to feed it samples.
+static void test_dispatcher_sheds_over_limit()
+{
+  MethodOptions opts;
+  opts.adaptive.enabled = true;
+  opts.adaptive.initial_limit = 2;
+  opts.adaptive.min_limit = 2;
+  opts.adaptive.window_samples = 2;
+
+  Gate gate;
+  Router r;
+  r.add("work", [&](const Context &) -> RpcResult
+        {
+          gate.hold();
+          return token(true); },
+        opts);
+  const Dispatcher d(r);
+
+  const token call = obj({"id", 1LL, "method", "work"});
+
+  std::atomic<int> ok{0};
+  std::vector<std::thread> held;
+  for (int i = 0; i < 2; ++i)
+  {
+    held.emplace_back([&]
+                      {
+                        auto res = d.handle_one(call);
+                        if (!res->has_error())
+                          ok.fetch_add(1); });
+  }
+  gate.wait_entered(2);
+
+  // Both slots are taken: the third call is shed without reaching the handler.
+  auto shed = d.handle_one(call);
+  assert(shed->has_error());
+  assert(shed->error().code == "OVERLOADED");
+
+  gate.release();
+  for (auto &t : held)
+    t.join();
+
+  assert(ok.load() == 2);
+
+  const auto limits = d.adaptive_limits();
+  assert(limits.size() == 1);
+  const AdaptiveLimitSnapshot &s = limits.front().second;
+  assert(s.admitted == 2);
+  assert(s.rejected == 1);
+  assert(s.in_flight == 0);
+  assert(s.windows == 1 && "two released calls close one window");
+  assert(s.limit >= 2);
+}
+
+static void test_limit_grows_when_latency_is_flat()
+{
+  AdaptiveLimitOptions o;
+  o.enabled = true;
+  o.initial_limit = 4;
+  o.window_samples = 4;
+
+  AdaptiveLimiter l(o);
+
+  // Saturate the current limit each round, with constant latency.
+  for (int w = 0; w < 10; ++w)
+  {
+    const std::size_t n = l.limit();
+    std::size_t acquired = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      acquired += l.try_acquire() ? 1 : 0;
+    assert(acquired == n);
+    const bool over = l.try_acquire();
+    assert(!over && "limit must be enforced");
+    for (std::size_t i = 0; i < n; ++i)
+      l.release(1ms);
+  }
+
+  const AdaptiveLimitSnapshot s = l.snapshot();
+  assert(s.limit > 4);
+  assert(s.last_decision != LimitDecision::decrease);
+  assert(s.gradient == 1.0);
+  assert(s.in_flight == 0);
+}
+
+static void test_limit_shrinks_when_latency_rises()
+{
+  AdaptiveLimitOptions o;
+  o.enabled = true;
+  o.initial_limit = 32;
+  o.window_samples = 4;
+
+  AdaptiveLimiter l(o);
+
+  for (int i = 0; i < 4; ++i)
+  {
+    const bool acquired = l.try_acquire();
+    assert(acquired);
+    l.release(1ms);
+  }
+
+  for (int w = 0; w < 10; ++w)
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      const bool acquired = l.try_acquire();
+      assert(acquired);
+      l.release(10ms);
+    }
+  }
+
+  const AdaptiveLimitSnapshot s = l.snapshot();
+  assert(s.limit < 32);
+  assert(s.last_decision == LimitDecision::decrease);
+  assert(s.min_latency_ns == static_cast<std::uint64_t>(std::chrono::nanoseconds(1ms).count()));
+}
+
+/// Calls `d.handle(payload)`, which must throw.
+static void expect_throw(const Dispatcher &d, const token &payload)
+{
+  bool thrown = false;
+  try
+  {
+    (void)d.handle(payload);
+  }
+  catch (const std::runtime_error &)
+  {
+    thrown = true;
+  }
+  assert(thrown);
+}
+
+static void test_throwing_handler_releases_its_slot()
+{
+  MethodOptions o;
+  o.adaptive.enabled = true;
+  o.adaptive.initial_limit = 2;
+  o.adaptive.min_limit = 2;
+
+  Router r;
+  r.add("boom", [](const Context &ctx) -> RpcResult
+        {
+          if (ctx.params.as_object_ptr()->get_bool_or("fail", false))
+            throw std::runtime_error("boom");
+          return token(true); },
+        o);
+  Dispatcher d(r);
+
+  for (int i = 0; i < 10; ++i)
+    expect_throw(d, obj({"id", i, "method", "boom", "params", obj({"fail", true})}));
+
+  const auto limits = d.adaptive_limits();
+  assert(limits.size() == 1);
+  assert(limits[0].second.in_flight == 0);
+  assert(limits[0].second.admitted == 10);
+
+  auto ok = d.handle(obj({"id", 1, "method", "boom", "params", obj({"fail", false})}));
+  assert(ok->as_object_ptr()->get_ptr("result") != nullptr);
+}
+
+static void test_throwing_batch_handler_releases_its_slot()
+{
+  MethodOptions o;
+  o.adaptive.enabled = true;
+  o.adaptive.initial_limit = 2;
+  o.adaptive.min_limit = 2;
+
+  bool fail = true;
+  Router r;
+  r.add_batch("many", [&](std::span<const Context>, std::span<RpcResult> results)
+              {
+                if (fail)
+                  throw std::runtime_error("boom");
+                for (RpcResult &res : results)
+                  res = token(true); },
+              o);
+  Dispatcher d(r);
+
+  auto payload = []
+  {
+    array_t items;
+    items.elems.push_back(obj({"id", 1, "method", "many"}));
+    items.elems.push_back(obj({"id", 2, "method", "many"}));
+    return token(std::move(items));
+  };
+
+  for (int i = 0; i < 10; ++i)
+    expect_throw(d, payload());
+
+  const auto limits = d.adaptive_limits();
+  assert(limits.size() == 1);
+  assert(limits[0].second.in_flight == 0);
+
+  fail = false;
+  auto ok = d.handle(payload());
+  assert(ok->as_array_ptr()->elems.size() == 2);
+  assert(ok->as_array_ptr()->elems[0].as_object_ptr()->get_ptr("result") != nullptr);
+}
+
+int main()
+{
+  test_limit_grows_when_latency_is_flat();
+  test_limit_shrinks_when_latency_rises();
+  test_dispatcher_sheds_over_limit();
+  test_throwing_handler_releases_its_slot();
+  test_throwing_batch_handler_releases_its_slot();
+
+  std::cout << "[webrpc] adaptive_limit_simulation OK\n";
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include <cassert>
+#include <iostream>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static std::string error_code_of(const std::optional<RpcResponse> &r)
+{
+  assert(r.has_value());
+  return r->has_error() ? std::string(r->error().code) : std::string{};
+}
+
+static token call(const char *method, long long id)
+{
+  return obj({
+      "id",
+      id,
+      "method",
+      method,
+  });
+}
+
+static void test_method_in_flight_limit()
+{
+  Router r;
+  const Dispatcher *self = nullptr;
+  std::string nested_code;
+
+  MethodOptions opts;
+  opts.limits.max_in_flight = 1;
+
+  // The handler re-enters the dispatcher while its own slot is still held.
+  r.add("slow", [&](const Context &ctx) -> RpcResult
+        {
+          if (ctx.id.as_i64_or(0) == 1)
+            nested_code = error_code_of(self->handle_one(call("slow", 2)));
+          return token(true); }, opts);
+
+  Dispatcher d(r);
+  self = &d;
+
+  auto out = d.handle_one(call("slow", 1));
+  assert(error_code_of(out).empty());
+  assert(nested_code == "OVERLOADED");
+
+  // Slot is released once the outer call returns.
+  out = d.handle_one(call("slow", 3));
+  assert(error_code_of(out).empty());
+
+  const AdmissionStats s = r.find("slow")->admission->stats();
+  assert(s.admitted == 2);
+  assert(s.rejected_in_flight == 1);
+  assert(s.in_flight == 0);
+}
+
+static void test_method_rate_limit()
+{
+  Router r;
+  int calls = 0;
+
+  MethodOptions opts;
+  opts.limits.rate_per_sec = 0.001; // effectively no refill during the test
+  opts.limits.burst = 2;
+
+  r.add("tick", [&](const Context &) -> RpcResult
+        {
+          ++calls;
+          return token(nullptr); }, opts);
+
+  Dispatcher d(r);
+
+  const auto first = d.handle_one(call("tick", 1));
+  const auto second = d.handle_one(call("tick", 2));
+  const auto third = d.handle_one(call("tick", 3));
+  assert(error_code_of(first).empty());
+  assert(error_code_of(second).empty());
+  assert(error_code_of(third) == "OVERLOADED");
+  assert(calls == 2 && "rejected call must not reach the handler");
+
+  assert(r.find("tick")->admission->stats().rejected_rate == 1);
+}
+
+static void test_global_limit()
+{
+  Router r;
+  const Dispatcher *self = nullptr;
+  std::string nested_code;
+
+  r.add("outer", [&](const Context &) -> RpcResult
+        {
+          nested_code = error_code_of(self->handle_one(call("inner", 2)));
+          return token(true); });
+
+  r.add("inner", [](const Context &) -> RpcResult
+        { return token(true); });
+
+  DispatcherOptions opts;
+  opts.global_limits.max_in_flight = 1;
+
+  Dispatcher d(r, opts);
+  self = &d;
+
+  const auto out = d.handle_one(call("outer", 1));
+  assert(error_code_of(out).empty());
+  assert(nested_code == "OVERLOADED");
+  assert(d.global_admission().rejected_in_flight == 1);
+  assert(d.global_admission().in_flight == 0);
+}
+
+static void test_unlimited_method_has_no_gate()
+{
+  Router r;
+  r.add("free", [](const Context &) -> RpcResult
+        { return token(1LL); });
+
+  assert(r.find("free")->admission == nullptr);
+
+  Dispatcher d(r);
+  const auto out = d.handle_one(call("free", 1));
+  assert(error_code_of(out).empty());
+}
+
+int main()
+{
+  test_method_in_flight_limit();
+  test_method_rate_limit();
+  test_global_limit();
+  test_unlimited_method_has_no_gate();
+
+  std::cout << "[webrpc] admission_control OK\n";
+  return 0;
+}
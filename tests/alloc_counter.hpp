@@ -0,0 +1,114 @@
+/**
+ *
+ *  @file alloc_counter.hpp
+ *  @author Gaspard Kirira
+ *
+ *  Copyright 2026, Gaspard Kirira.
+ *  All rights reserved.
+ *  https://github.com/vixcpp/webrpc
+ *
+ *  Use of this source code is governed by a MIT license
+ *  that can be found in the LICENSE file.
+ *
+ *  Vix.cpp
+ *
+ *  Test utility: counts global heap allocations per scope.
+ *
+ *  Replaces the global operator new/delete (plain and aligned, which the default
+ *  pmr resource uses), so include it from exactly one translation unit of a test
+ *  executable. Counters are per thread: allocations made by other threads (pools,
+ *  timers) do not show in the scope of the calling thread.
+ *
+ *    const AllocCount n = count_allocations([&] { d.handle(payload); });
+ *    assert(n.calls <= 3);
+ */
+
+#ifndef VIX_WEBRPC_TESTS_ALLOC_COUNTER_HPP
+#define VIX_WEBRPC_TESTS_ALLOC_COUNTER_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace alloc_counter
+{
+  inline thread_local std::size_t calls = 0;
+  inline thread_local std::size_t bytes = 0;
+
+  inline void *allocate(std::size_t n, std::size_t align)
+  {
+    ++calls;
+    bytes += n;
+
+    void *p = align > alignof(std::max_align_t)
+                  ? std::aligned_alloc(align, (n + align - 1) / align * align)
+                  : std::malloc(n ? n : 1);
+    if (!p)
+      throw std::bad_alloc();
+    return p;
+  }
+}
+
+void *operator new(std::size_t n) { return alloc_counter::allocate(n, 0); }
+void *operator new[](std::size_t n) { return alloc_counter::allocate(n, 0); }
+void *operator new(std::size_t n, std::align_val_t a) { return alloc_counter::allocate(n, static_cast<std::size_t>(a)); }
+void *operator new[](std::size_t n, std::align_val_t a) { return alloc_counter::allocate(n, static_cast<std::size_t>(a)); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+/// Allocations made by the calling thread during a scope.
+struct AllocCount
+{
+  std::size_t calls{0};
+  std::size_t bytes{0};
+};
+
+/// Counts the allocations of the calling thread from construction to `count()`.
+class AllocScope
+{
+public:
+  AllocScope() noexcept : calls_(alloc_counter::calls), bytes_(alloc_counter::bytes) {}
+
+  AllocCount count() const noexcept
+  {
+    return {alloc_counter::calls - calls_, alloc_counter::bytes - bytes_};
+  }
+
+private:
+  std::size_t calls_;
+  std::size_t bytes_;
+};
+
+/// Allocations made by `fn` on the calling thread.
+template <typename Fn>
+AllocCount count_allocations(Fn &&fn)
+{
+  const AllocScope scope;
+  fn();
+  return scope.count();
+}
+
+/**
+ * @brief Check an allocation budget, printing the measured count when it is exceeded.
+ *
+ * @return `true` if `n.calls <= budget`.
+ */
+inline bool within_budget(const char *what, const AllocCount &n, std::size_t budget)
+{
+  if (n.calls <= budget)
+    return true;
+
+  std::fprintf(stderr, "[webrpc] allocation budget exceeded: %s: %zu allocations (%zu bytes), budget %zu\n",
+               what, n.calls, n.bytes, budget);
+  return false;
+}
+
+#endif // VIX_WEBRPC_TESTS_ALLOC_COUNTER_HPP
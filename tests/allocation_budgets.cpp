@@ -0,0 +1,177 @@
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "alloc_counter.hpp"
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+// Allocation budgets of the hot paths. Response trees are built by vix::json and
+// measured, not pinned: the budgets below are what webrpc adds on top of them.
+// A failure prints the measured count; raise a budget only on purpose.
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+/// Error responses keep their error in one heap block (`RpcResponse`).
+static constexpr std::size_t error_box_budget = 1;
+
+/// Batch bookkeeping (slots, execution order), independent of the batch size.
+static constexpr std::size_t batch_bookkeeping_budget = 3;
+
+/// Assert that `fn` stays within `budget` allocations.
+template <typename Fn>
+static void expect_budget(const char *what, std::size_t budget, Fn &&fn)
+{
+  const bool ok = within_budget(what, count_allocations(fn), budget);
+  assert(ok);
+  (void)ok;
+}
+
+static void setup(Router &r)
+{
+  r.add("sum", [](const Context &ctx) -> RpcResult
+        { return token(ctx.params.as_object_ptr()->get_i64_or("a", 0) + 1); });
+}
+
+static token call(long long id) { return obj({"id", id, "method", "sum", "params", obj({"a", id})}); }
+
+static token batch(std::size_t n)
+{
+  array_t items;
+  for (std::size_t i = 0; i < n; ++i)
+    items.elems.push_back(call(static_cast<long long>(i)));
+  return token(std::move(items));
+}
+
+/// Allocations vix::json makes to build the JSON of `res`.
+static std::size_t tree_of(const RpcResponse &res)
+{
+  return count_allocations([&]
+                           { auto t = res.to_json(); })
+      .calls;
+}
+
+/// Allocations made to build the `RpcError` of an unknown method (strings and details).
+static std::size_t unknown_error()
+{
+  return count_allocations([]
+                           { auto e = RpcError::method_not_found("nope"); })
+      .calls;
+}
+
+/// Allocations vix::json makes to gather `n` built responses into an array.
+static std::size_t array_of(std::size_t n)
+{
+  const token item = RpcResponse::ok(token(1), token(1)).to_json();
+  return count_allocations([&]
+                           {
+                             array_t arr;
+                             arr.elems.reserve(n);
+                             for (std::size_t i = 0; i < n; ++i)
+                               arr.elems.push_back(item);
+                             token t(std::move(arr)); })
+      .calls;
+}
+
+static void test_router_dispatch()
+{
+  Router r;
+  setup(r);
+
+  const token raw = call(1);
+  const RpcRequest req = std::get<RpcRequest>(RpcRequest::parse(raw));
+  const RpcRequest unknown = std::get<RpcRequest>(RpcRequest::parse(obj({"id", 1, "method", "nope"})));
+
+  expect_budget("Router::dispatch(request)", 0, [&]
+                { auto x = r.dispatch(req); });
+  expect_budget("Router::dispatch(token)", 0, [&]
+                { auto x = r.dispatch(raw); });
+  expect_budget("Router::dispatch(unknown)", unknown_error(), [&]
+                { auto x = r.dispatch(unknown); });
+}
+
+static void check_handle(const Dispatcher &d)
+{
+  const std::size_t ok_tree = tree_of(RpcResponse::ok(token(1), token(3)));
+  const std::size_t unknown_tree = tree_of(RpcResponse::fail(token(1), RpcError::method_not_found("nope")));
+
+  const token single = call(1);
+  const token notification = obj({"method", "sum", "params", obj({"a", 1})});
+  const token unknown = obj({"id", 1, "method", "nope"});
+
+  // Warm up lazily built state.
+  (void)d.handle(single);
+  (void)d.handle(batch(4));
+
+  expect_budget("handle(call)", ok_tree, [&]
+                { auto x = d.handle(single); });
+  expect_budget("handle(notification)", 0, [&]
+                { auto x = d.handle(notification); });
+  expect_budget("handle(unknown method)", unknown_error() + unknown_tree + error_box_budget, [&]
+                { auto x = d.handle(unknown); });
+
+  for (const std::size_t n : {1u, 4u, 16u, 64u})
+  {
+    const token payload = batch(n);
+    expect_budget("handle(batch)", n * ok_tree + array_of(n) + batch_bookkeeping_budget, [&]
+                  { auto x = d.handle(payload); });
+  }
+}
+
+static void test_dispatcher_handle()
+{
+  Router r;
+  setup(r);
+
+  check_handle(Dispatcher(r));
+
+  DispatcherOptions o;
+  o.request_arena = true;
+  check_handle(Dispatcher(r, o));
+}
+
+static void test_dispatcher_write()
+{
+  Router r;
+  setup(r);
+  Dispatcher d(r);
+
+  const token single = call(1);
+  const token notification = obj({"method", "sum", "params", obj({"a", 1})});
+  const token unknown = obj({"id", 1, "method", "nope"});
+  const token big = batch(64);
+
+  // Grow the scratch to the largest payload first.
+  DispatchScratch scratch;
+  (void)d.write(big, scratch);
+  (void)d.write(unknown, scratch);
+
+  expect_budget("write(call)", 0, [&]
+                { d.write(single, scratch); });
+  expect_budget("write(notification)", 0, [&]
+                { d.write(notification, scratch); });
+  expect_budget("write(unknown method)", 0, [&]
+                { d.write(unknown, scratch); });
+
+  for (const std::size_t n : {1u, 16u, 64u})
+  {
+    const token payload = batch(n);
+    expect_budget("write(batch)", 0, [&]
+                  { d.write(payload, scratch); });
+  }
+}
+
+int main()
+{
+  test_router_dispatch();
+  test_dispatcher_handle();
+  test_dispatcher_write();
+
+  std::cout << "[webrpc] allocation_budgets OK\n";
+  return 0;
+}
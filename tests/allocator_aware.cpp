@@ -0,0 +1,210 @@
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "alloc_counter.hpp"
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Error.hpp>
+#include <vix/webrpc/Request.hpp>
+#include <vix/webrpc/Response.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+struct CountingResource final : std::pmr::memory_resource
+{
+  std::size_t allocations{0};
+  std::size_t live{0};
+
+  void *do_allocate(std::size_t n, std::size_t align) override
+  {
+    ++allocations;
+    ++live;
+    return upstream.allocate(n, align);
+  }
+
+  void do_deallocate(void *p, std::size_t n, std::size_t align) override
+  {
+    --live;
+    upstream.deallocate(p, n, align);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &o) const noexcept override
+  {
+    return this == &o;
+  }
+
+  // Preallocated upstream: the counting resource itself never reaches operator new.
+  alignas(std::max_align_t) std::byte buffer[1 << 16];
+  std::pmr::monotonic_buffer_resource upstream{buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+};
+
+// Longer than any small-string buffer.
+static constexpr const char *long_method = "inventory.reservations.release_expired_holds";
+static constexpr const char *long_message = "the reservation store is unavailable, retry later";
+
+static void test_default_types_are_unchanged()
+{
+  static_assert(std::is_same_v<decltype(RpcError::code), std::string>);
+  static_assert(std::is_same_v<decltype(RpcError::message), std::string>);
+  static_assert(std::is_same_v<decltype(RpcError::details), token>);
+  static_assert(std::is_same_v<decltype(RpcRequest::method), std::string>);
+  static_assert(std::is_same_v<decltype(pmr::RpcRequest::method), std::pmr::string>);
+  static_assert(std::is_same_v<RpcResponse::error_type, RpcError>);
+
+  RpcError e("APP_ERROR", "nope", obj({"n", 1}));
+  assert(e.details.as_object_ptr()->get_i64_or("n", 0) == 1);
+  RpcRequest req(token(1), "a.b", token(nullptr));
+  assert(req.method == "a.b");
+}
+
+static void test_request_parse_stays_in_resource()
+{
+  CountingResource mem;
+  const pmr::RpcRequest::allocator_type alloc(&mem);
+
+  const token payload = obj({"id", 7, "method", long_method, "params", obj({"sku", "A-1"})});
+
+  const AllocCount heap = count_allocations([&]
+                                            {
+                                              auto parsed = pmr::RpcRequest::parse(payload, alloc);
+                                              pmr::RpcRequest &req = std::get<pmr::RpcRequest>(parsed);
+                                              assert(req.method == long_method);
+                                              assert(req.get_allocator().resource() == &mem);
+                                              assert(req.params.is_object());
+
+                                              // Moves keep the resource.
+                                              pmr::RpcRequest moved = std::move(req);
+                                              assert(moved.get_allocator().resource() == &mem); });
+
+  assert(heap.calls == 0);
+  assert(mem.allocations > 0);
+  assert(mem.live == 0);
+}
+
+static void test_response_factories_stay_in_resource()
+{
+  CountingResource mem;
+  const pmr::RpcResponse::allocator_type alloc(&mem);
+  const token id = token(1);
+  const token result = obj({"ok", true});
+
+  const AllocCount heap = count_allocations([&]
+                                            {
+                                              pmr::RpcResponse ok = pmr::RpcResponse::ok(id, result, alloc);
+                                              assert(ok.ok());
+                                              assert(ok.get_allocator().resource() == &mem);
+
+                                              pmr::RpcResponse failed = pmr::RpcResponse::fail(
+                                                  id, pmr::RpcError::internal_error(long_message, alloc));
+                                              assert(!failed.ok());
+                                              assert(failed.error().code == "INTERNAL_ERROR");
+                                              assert(failed.error().message == long_message);
+                                              assert(failed.get_allocator().resource() == &mem);
+
+                                              pmr::RpcError custom{"RESERVATION_STORE_UNAVAILABLE", long_message, alloc};
+                                              pmr::RpcResponse c = pmr::RpcResponse::fail(id, std::move(custom), alloc);
+                                              assert(c.error().code == "RESERVATION_STORE_UNAVAILABLE");
+
+                                              pmr::RpcError shed(pmr::RpcError::overloaded(), alloc);
+                                              assert(shed.code == "OVERLOADED"); });
+
+  assert(heap.calls == 0);
+  assert(mem.allocations >= 3);
+  assert(mem.live == 0);
+}
+
+static void test_errors_with_details_keep_strings_in_resource()
+{
+  CountingResource mem;
+  const pmr::RpcError::allocator_type alloc(&mem);
+
+  // Details are vix::json values (global heap); code and message use the resource.
+  pmr::RpcError e = pmr::RpcError::method_not_found(long_method, alloc);
+  assert(e.get_allocator().resource() == &mem);
+  assert(e.code == "METHOD_NOT_FOUND");
+  assert(e.details.as_object_ptr()->get_string_or("method", "") == long_method);
+
+  const token wire = e.to_json();
+  auto parsed = pmr::RpcError::parse(wire, alloc);
+  assert(parsed.ok());
+  assert(parsed.value().get_allocator().resource() == &mem);
+  assert(parsed.value().code == "METHOD_NOT_FOUND");
+
+  auto resp = pmr::RpcResponse::parse(obj({"id", 3, "error", wire}), alloc);
+  const pmr::RpcResponse &r = std::get<pmr::RpcResponse>(resp);
+  assert(r.has_error());
+  assert(r.get_allocator().resource() == &mem);
+}
+
+static void test_copies_and_containers()
+{
+  CountingResource mem;
+  const pmr::RpcError::allocator_type alloc(&mem);
+
+  pmr::RpcError e{"RESERVATION_STORE_UNAVAILABLE", long_message, alloc};
+
+  // A plain copy does not inherit the resource (std::pmr semantics).
+  pmr::RpcError copy = e;
+  assert(copy.get_allocator().resource() == std::pmr::get_default_resource());
+  assert(copy.code == e.code);
+
+  // Copy into another resource.
+  CountingResource other;
+  pmr::RpcError there(e, pmr::RpcError::allocator_type(&other));
+  assert(there.get_allocator().resource() == &other);
+  assert(other.allocations > 0);
+
+  // pmr containers pass their resource down (uses-allocator construction).
+  const AllocCount heap = count_allocations([&]
+                                            {
+                                              std::pmr::vector<pmr::RpcError> errors(&mem);
+                                              errors.reserve(4);
+                                              errors.emplace_back("RESERVATION_STORE_UNAVAILABLE", long_message);
+                                              errors.push_back(e);
+                                              assert(errors[0].get_allocator().resource() == &mem);
+                                              assert(errors[1].get_allocator().resource() == &mem); });
+  assert(heap.calls == 0);
+}
+
+static void test_dispatcher_parses_into_the_arena()
+{
+  Router r;
+  r.add(long_method, [](const Context &) -> RpcResult
+        { return RpcError::internal_error(long_message); });
+
+  DispatcherOptions o;
+  o.request_arena = true;
+  Dispatcher d(r, o);
+
+  // The method name is parsed into the arena; the error is an `RpcError`.
+  auto out = d.handle(obj({"id", 1, "method", long_method}));
+  assert(out.has_value());
+  const token *err = out->as_object_ptr()->get_ptr("error");
+  assert(err && err->as_object_ptr()->get_string_or("message", "") == long_message);
+
+  auto batch = d.handle(array({obj({"id", 1, "method", long_method}),
+                               obj({"id", 2, "method", 42})}));
+  assert(batch.has_value() && batch->as_array_ptr()->elems.size() == 2);
+}
+
+int main()
+{
+  test_default_types_are_unchanged();
+  test_request_parse_stays_in_resource();
+  test_response_factories_stay_in_resource();
+  test_errors_with_details_keep_strings_in_resource();
+  test_copies_and_containers();
+  test_dispatcher_parses_into_the_arena();
+
+  std::cout << "[webrpc] allocator_aware OK\n";
+  return 0;
+}
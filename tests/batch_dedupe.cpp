@@ -0,0 +1,109 @@
+#include <cassert>
+#include <iostream>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static token call(const char *method, token id, token params)
+{
+  return obj({
+      "id",
+      std::move(id),
+      "method",
+      method,
+      "params",
+      std::move(params),
+  });
+}
+
+static void register_methods(Router &r, int &user_runs, int &audit_runs)
+{
+  MethodOptions idem;
+  idem.idempotent = true;
+
+  r.add("user.get", [&](const Context &ctx) -> RpcResult
+        {
+          ++user_runs;
+          return obj({"id", ctx.params.as_object_ptr()->get_i64_or("id", 0)}); }, idem);
+
+  r.add("audit.log", [&](const Context &) -> RpcResult
+        {
+          ++audit_runs;
+          return token(true); });
+}
+
+static token mixed_batch()
+{
+  return array({
+      call("user.get", 1, obj({"id", 7})),
+      call("user.get", 2, obj({"id", 8})),
+      call("audit.log", 3, obj({"id", 7})),
+      call("user.get", 4, obj({"id", 7})),
+      call("audit.log", 5, obj({"id", 7})),
+      call("user.get", "x", obj({"id", 7})),
+      call("user.get", nullptr, obj({"id", 7})), // notification
+  });
+}
+
+static void test_identical_items_run_once()
+{
+  Router r;
+  int user_runs = 0;
+  int audit_runs = 0;
+  register_methods(r, user_runs, audit_runs);
+
+  DispatcherOptions o;
+  o.dedupe_batches = true;
+  Dispatcher d(r, o);
+
+  auto out = d.handle(mixed_batch());
+  assert(out.has_value());
+
+  const auto arr = out->as_array_ptr();
+  assert(arr && arr->elems.size() == 6);
+
+  // user.get{7} ran once, user.get{8} once; audit.log is not idempotent.
+  assert(user_runs == 2);
+  assert(audit_runs == 2);
+  assert(d.stats().batch_deduplicated == 3);
+
+  // Every response keeps its own id, in the original order.
+  const token expected_ids[] = {1, 2, 3, 4, 5, "x"};
+  for (std::size_t i = 0; i < arr->elems.size(); ++i)
+  {
+    const auto resp = arr->elems[i].as_object_ptr();
+    assert(resp);
+    assert(equal(*resp->get_ptr("id"), expected_ids[i]));
+  }
+
+  const auto fourth = arr->elems[3].as_object_ptr();
+  assert(fourth->get_ptr("result")->as_object_ptr()->get_i64_or("id", 0) == 7);
+}
+
+static void test_disabled_by_default()
+{
+  Router r;
+  int user_runs = 0;
+  int audit_runs = 0;
+  register_methods(r, user_runs, audit_runs);
+
+  Dispatcher d(r);
+  d.handle(mixed_batch());
+
+  assert(user_runs == 5);
+  assert(audit_runs == 2);
+  assert(d.stats().batch_deduplicated == 0);
+}
+
+int main()
+{
+  test_identical_items_run_once();
+  test_disabled_by_default();
+
+  std::cout << "[webrpc] batch_dedupe OK\n";
+  return 0;
+}
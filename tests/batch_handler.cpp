@@ -0,0 +1,218 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static token call(const char *method, token id, token params)
+{
+  return obj({
+      "id",
+      std::move(id),
+      "method",
+      method,
+      "params",
+      std::move(params),
+  });
+}
+
+struct Storage
+{
+  int round_trips{0};
+  std::vector<std::size_t> group_sizes{};
+};
+
+static void register_user_get(Router &r, Storage &db, MethodOptions opts = {})
+{
+  r.add_batch("user.get", [&](std::span<const Context> calls, std::span<RpcResult> results)
+              {
+                ++db.round_trips;
+                db.group_sizes.push_back(calls.size());
+                for (std::size_t i = 0; i < calls.size(); ++i)
+                {
+                  const long long id = calls[i].params.as_object_ptr()->get_i64_or("id", -1);
+                  if (id < 0)
+                    results[i] = RpcError::invalid_params("id is required");
+                  else
+                    results[i] = obj({"id", id, "name", "user-" + std::to_string(id)});
+                } },
+              std::move(opts));
+}
+
+static void test_group_and_scatter()
+{
+  Router r;
+  Storage db;
+  register_user_get(r, db);
+
+  int pings = 0;
+  r.add("ping", [&](const Context &) -> RpcResult
+        {
+          ++pings;
+          return token("pong"); });
+
+  array_t batch;
+  for (long long i = 0; i < 500; ++i)
+  {
+    if (i % 100 == 50)
+      batch.elems.push_back(call("ping", 10000 + i, nullptr));
+    batch.elems.push_back(call("user.get", i, obj({"id", i})));
+  }
+  batch.elems.push_back(call("user.get", "bad", obj({})));
+  batch.elems.push_back(call("user.get", nullptr, obj({"id", 1}))); // notification
+
+  Dispatcher d(r);
+  auto out = d.handle(token(batch));
+  assert(out.has_value());
+
+  assert(db.round_trips == 1);
+  assert(db.group_sizes.size() == 1 && db.group_sizes[0] == 502);
+  assert(pings == 5);
+
+  const auto arr = out->as_array_ptr();
+  assert(arr->elems.size() == 506);
+
+  // Responses follow the item order and carry their own id.
+  std::size_t k = 0;
+  for (long long i = 0; i < 500; ++i)
+  {
+    if (i % 100 == 50)
+    {
+      const auto ping = arr->elems[k++].as_object_ptr();
+      assert(ping->get_i64_or("id", 0) == 10000 + i);
+      assert(ping->get_string_or("result", "") == "pong");
+    }
+
+    const auto resp = arr->elems[k++].as_object_ptr();
+    assert(resp->get_i64_or("id", -1) == i);
+    assert(resp->get_ptr("result")->as_object_ptr()->get_string_or("name", "") ==
+           "user-" + std::to_string(i));
+  }
+
+  const auto bad = arr->elems[k++].as_object_ptr();
+  assert(bad->get_string_or("id", "") == "bad");
+  assert(bad->get_ptr("error")->as_object_ptr()->get_string_or("code", "") == "INVALID_PARAMS");
+}
+
+static void test_single_call_uses_batch_handler()
+{
+  Router r;
+  Storage db;
+  register_user_get(r, db);
+
+  Dispatcher d(r);
+  auto out = d.handle_one(call("user.get", 1, obj({"id", 42})));
+
+  assert(out.has_value() && !out->has_error());
+  assert(out->result().as_object_ptr()->get_i64_or("id", 0) == 42);
+  assert(db.round_trips == 1);
+  assert(db.group_sizes[0] == 1);
+}
+
+static void test_group_admitted_once()
+{
+  Router r;
+  Storage db;
+
+  MethodOptions opts;
+  opts.limits.max_in_flight = 1;
+  register_user_get(r, db, opts);
+
+  Dispatcher d(r);
+  d.handle(array({
+      call("user.get", 1, obj({"id", 1})),
+      call("user.get", 2, obj({"id", 2})),
+      call("user.get", 3, obj({"id", 3})),
+  }));
+
+  const AdmissionStats s = r.find("user.get")->admission->stats();
+  assert(s.admitted == 1);
+  assert(db.round_trips == 1);
+}
+
+static void test_dedupe_before_grouping()
+{
+  Router r;
+  Storage db;
+
+  MethodOptions opts;
+  opts.idempotent = true;
+  register_user_get(r, db, opts);
+
+  DispatcherOptions o;
+  o.dedupe_batches = true;
+  Dispatcher d(r, o);
+
+  auto out = d.handle(array({
+      call("user.get", 1, obj({"id", 7})),
+      call("user.get", 2, obj({"id", 8})),
+      call("user.get", 3, obj({"id", 7})),
+  }));
+
+  assert(db.group_sizes.size() == 1 && db.group_sizes[0] == 2);
+  assert(d.stats().batch_deduplicated == 1);
+
+  const auto third = out->as_array_ptr()->elems[2].as_object_ptr();
+  assert(third->get_i64_or("id", 0) == 3);
+  assert(third->get_ptr("result")->as_object_ptr()->get_i64_or("id", 0) == 7);
+}
+
+static void test_group_by_method_order()
+{
+  Router r;
+  std::vector<std::string> trace;
+
+  for (const char *name : {"a", "b", "c"})
+  {
+    r.add(name, [&trace, name](const Context &ctx) -> RpcResult
+          {
+            trace.push_back(std::string(name) + std::to_string(ctx.id.as_i64_or(0)));
+            return token(name); });
+  }
+
+  const token batch = array({
+      call("a", 1, nullptr),
+      call("b", 2, nullptr),
+      call("a", 3, nullptr),
+      call("c", 4, nullptr),
+      call("b", 5, nullptr),
+      call("missing", 6, nullptr),
+      call("a", 7, nullptr),
+  });
+
+  DispatcherOptions o;
+  o.group_batches_by_method = true;
+  Dispatcher d(r, o);
+
+  auto out = d.handle(batch);
+
+  // Groups by first appearance, items in order inside a group.
+  const std::vector<std::string> expected{"a1", "a3", "a7", "b2", "b5", "c4"};
+  assert(trace == expected);
+
+  // Responses still follow the item order.
+  const auto arr = out->as_array_ptr();
+  assert(arr->elems.size() == 7);
+  for (std::size_t i = 0; i < arr->elems.size(); ++i)
+    assert(arr->elems[i].as_object_ptr()->get_i64_or("id", 0) == static_cast<long long>(i + 1));
+  assert(arr->elems[3].as_object_ptr()->get_string_or("result", "") == "c");
+  assert(arr->elems[5].as_object_ptr()->get_ptr("error") != nullptr);
+}
+
+int main()
+{
+  test_group_and_scatter();
+  test_single_call_uses_batch_handler();
+  test_group_admitted_once();
+  test_dedupe_before_grouping();
+  test_group_by_method_order();
+
+  std::cout << "[webrpc] batch_handler OK\n";
+  return 0;
+}
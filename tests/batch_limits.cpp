@@ -0,0 +1,232 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Limits.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/webrpc/Scheduler.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+using namespace std::chrono_literals;
+
+static token call(const char *method, long long id, token params = obj({}))
+{
+  return obj({
+      "id",
+      id,
+      "method",
+      method,
+      "params",
+      std::move(params),
+  });
+}
+
+static std::string error_code(const token &response)
+{
+  const auto op = response.as_object_ptr();
+  assert(op);
+  const token *err = op->get_ptr("error");
+  if (!err)
+    return {};
+  return err->as_object_ptr()->get_string_or("code", "");
+}
+
+static token nested(std::size_t depth)
+{
+  token t(1);
+  for (std::size_t i = 0; i < depth; ++i)
+    t = array({t});
+  return t;
+}
+
+static void test_check_params()
+{
+  DispatcherLimits l;
+  assert(check_params(nested(50), l) == ParamsCheck::ok);
+
+  l.max_params_depth = 3;
+  assert(check_params(token(1), l) == ParamsCheck::ok);
+  assert(check_params(nested(3), l) == ParamsCheck::ok);
+  assert(check_params(nested(4), l) == ParamsCheck::too_deep);
+  assert(check_params(obj({"a", obj({"b", obj({"c", obj({})})})}), l) == ParamsCheck::too_deep);
+
+  DispatcherLimits b;
+  b.max_params_bytes = 16;
+  assert(check_params(obj({"k", "v"}), b) == ParamsCheck::ok);
+  assert(check_params(obj({"k", std::string(64, 'x')}), b) == ParamsCheck::too_large);
+  assert(check_params(array({1, 2, 3, 4, 5, 6, 7, 8, 9}), b) == ParamsCheck::too_large);
+}
+
+static void test_batch_too_large_is_rejected_before_running()
+{
+  std::atomic<int> runs{0};
+  Router r;
+  r.add("count", [&](const Context &) -> RpcResult
+        {
+          ++runs;
+          return token(true); });
+
+  DispatcherOptions o;
+  o.limits.max_batch_items = 2;
+  Dispatcher d(r, o);
+
+  auto ok = d.handle(array({call("count", 1), call("count", 2)}));
+  assert(ok.has_value() && ok->as_array_ptr()->elems.size() == 2);
+  assert(runs == 2);
+
+  auto out = d.handle(array({call("count", 1), call("count", 2), call("count", 3)}));
+  assert(out.has_value());
+  assert(error_code(*out) == "BATCH_TOO_LARGE");
+  assert(out->as_object_ptr()->get_ptr("id")->is_null());
+  assert(runs == 2);
+  assert(d.stats().batch_too_large == 1);
+
+  SchedulerOptions so;
+  so.workers = 1;
+  Scheduler s(so);
+
+  std::promise<std::optional<token>> posted;
+  d.post(s, array({call("count", 1), call("count", 2), call("count", 3)}),
+         [&](std::optional<token> res)
+         { posted.set_value(std::move(res)); });
+  auto p = posted.get_future().get();
+  assert(p.has_value() && error_code(*p) == "BATCH_TOO_LARGE");
+  assert(runs == 2);
+  assert(d.stats().batch_too_large == 2);
+}
+
+static void test_params_limits_per_item()
+{
+  std::atomic<int> runs{0};
+  Router r;
+  r.add("echo", [&](const Context &ctx) -> RpcResult
+        {
+          ++runs;
+          return ctx.params; });
+
+  DispatcherOptions o;
+  o.limits.max_params_depth = 4;
+  o.limits.max_params_bytes = 256;
+  Dispatcher d(r, o);
+
+  auto deep = d.handle(call("echo", 1, obj({"x", nested(8)})));
+  assert(deep.has_value() && error_code(*deep) == "PARAMS_TOO_DEEP");
+
+  auto large = d.handle(call("echo", 2, obj({"blob", std::string(1024, 'z')})));
+  assert(large.has_value() && error_code(*large) == "PARAMS_TOO_LARGE");
+  assert(runs == 0);
+
+  // One bad item does not fail the rest of the batch.
+  auto batch = d.handle(array({
+      call("echo", 1, obj({"x", nested(8)})),
+      call("echo", 2, obj({"n", 1})),
+  }));
+  assert(batch.has_value());
+  const auto &items = batch->as_array_ptr()->elems;
+  assert(items.size() == 2);
+  assert(error_code(items[0]) == "PARAMS_TOO_DEEP");
+  assert(error_code(items[1]).empty());
+  assert(runs == 1);
+
+  const DispatcherStats st = d.stats();
+  assert(st.params_too_deep == 2);
+  assert(st.params_too_large == 1);
+}
+
+static void burn(std::chrono::microseconds cpu)
+{
+  const auto start = detail::thread_cpu_time();
+  volatile unsigned long long x = 0;
+  while (detail::thread_cpu_time() - start < cpu)
+    x = x + 1;
+}
+
+static void test_cpu_budget_cuts_the_batch()
+{
+  std::atomic<int> runs{0};
+  Router r;
+  r.add("spin", [&](const Context &) -> RpcResult
+        {
+          ++runs;
+          burn(2ms);
+          return token(true); });
+
+  DispatcherOptions o;
+  o.limits.batch_cpu_budget = 3ms;
+  Dispatcher d(r, o);
+
+  auto out = d.handle(array({call("spin", 1), call("spin", 2), call("spin", 3), call("spin", 4)}));
+  assert(out.has_value());
+  const auto &items = out->as_array_ptr()->elems;
+  assert(items.size() == 4);
+
+  // Two items spend the 3 ms budget; the rest are answered without running.
+  assert(runs == 2);
+  assert(error_code(items[0]).empty());
+  assert(error_code(items[1]).empty());
+  assert(error_code(items[2]) == "BUDGET_EXCEEDED");
+  assert(error_code(items[3]) == "BUDGET_EXCEEDED");
+  assert(items[3].as_object_ptr()->get_i64_or("id", 0) == 4);
+  assert(d.stats().budget_exceeded == 2);
+
+  // The budget is per batch: the next one starts fresh.
+  auto again = d.handle(array({call("spin", 5)}));
+  assert(error_code(again->as_array_ptr()->elems[0]).empty());
+}
+
+static void test_cpu_budget_on_post()
+{
+  std::atomic<int> runs{0};
+  Router r;
+  r.add("spin", [&](const Context &) -> RpcResult
+        {
+          ++runs;
+          burn(2ms);
+          return token(true); });
+
+  DispatcherOptions o;
+  o.limits.batch_cpu_budget = 3ms;
+  Dispatcher d(r, o);
+
+  SchedulerOptions so;
+  so.workers = 1;
+  Scheduler s(so);
+
+  std::promise<std::optional<token>> done;
+  d.post(s, array({call("spin", 1), call("spin", 2), call("spin", 3), call("spin", 4)}),
+         [&](std::optional<token> res)
+         { done.set_value(std::move(res)); });
+
+  auto out = done.get_future().get();
+  assert(out.has_value());
+  const auto &items = out->as_array_ptr()->elems;
+  assert(items.size() == 4);
+
+  int exceeded = 0;
+  for (const auto &item : items)
+    exceeded += error_code(item) == "BUDGET_EXCEEDED" ? 1 : 0;
+
+  // A single worker runs items one after the other, as the sync path does.
+  assert(runs == 2);
+  assert(exceeded == 2);
+  assert(d.stats().budget_exceeded == 2);
+}
+
+int main()
+{
+  test_check_params();
+  test_batch_too_large_is_rejected_before_running();
+  test_params_limits_per_item();
+  test_cpu_budget_cuts_the_batch();
+  test_cpu_budget_on_post();
+
+  std::cout << "[webrpc] batch_limits OK\n";
+  return 0;
+}
@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <cassert>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "alloc_counter.hpp"
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Reference.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/webrpc/Scheduler.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static token call(const char *method, token id, token params)
+{
+  return obj({
+      "id",
+      std::move(id),
+      "method",
+      method,
+      "params",
+      std::move(params),
+  });
+}
+
+static token ref(token id, const char *path = nullptr)
+{
+  if (!path)
+    return obj({"$ref", std::move(id)});
+  return obj({"$ref", std::move(id), "path", path});
+}
+
+static DispatcherOptions pipelined()
+{
+  DispatcherOptions o;
+  o.batch_references = true;
+  return o;
+}
+
+static void register_methods(Router &r, std::vector<std::string> &trace, std::mutex &mu)
+{
+  r.add("session.resolve", [&](const Context &ctx) -> RpcResult
+        {
+          std::lock_guard<std::mutex> lock(mu);
+          trace.push_back("session");
+          return obj({"user_id", 42, "token", ctx.params.as_object_ptr()->get_string_or("token", "")}); });
+
+  r.add("user.get", [&](const Context &ctx) -> RpcResult
+        {
+          std::lock_guard<std::mutex> lock(mu);
+          trace.push_back("user");
+          const long long id = ctx.params.as_object_ptr()->get_i64_or("id", -1);
+          if (id < 0)
+            return RpcError::invalid_params("id");
+          return obj({"id", id, "name", "ada", "tags", array({"admin", "ops"})}); });
+
+  r.add("orders.list", [&](const Context &ctx) -> RpcResult
+        {
+          std::lock_guard<std::mutex> lock(mu);
+          trace.push_back("orders");
+          const auto op = ctx.params.as_object_ptr();
+          return array({op->get_i64_or("user", 0), op->get_string_or("tag", "")}); });
+
+  r.add("echo", [](const Context &ctx) -> RpcResult
+        { return ctx.params; });
+
+  r.add("fail", [](const Context &) -> RpcResult
+        { return RpcError{"NOT_FOUND", "missing"}; });
+}
+
+static const kvs &response(const token &out, std::size_t i)
+{
+  return *out.as_array_ptr()->elems[i].as_object_ptr();
+}
+
+static std::string error_reason(const kvs &resp)
+{
+  const token *err = resp.get_ptr("error");
+  assert(err);
+  const token *details = err->as_object_ptr()->get_ptr("details");
+  return details ? details->as_object_ptr()->get_string_or("reason", "") : "";
+}
+
+static void test_chain_in_one_round_trip()
+{
+  Router r;
+  std::vector<std::string> trace;
+  std::mutex mu;
+  register_methods(r, trace, mu);
+  Dispatcher d(r, pipelined());
+
+  // Listed out of dependency order on purpose.
+  auto out = d.handle(array({
+      call("orders.list", 3, obj({"user", ref(2, "/id"), "tag", ref("2", "/tags/1")})),
+      call("user.get", 2, obj({"id", ref("1", "/user_id")})),
+      call("session.resolve", "1", obj({"token", "t0"})),
+  }));
+  assert(out.has_value());
+  assert(out->as_array_ptr()->elems.size() == 3);
+
+  assert((trace == std::vector<std::string>{"session", "user", "orders"}));
+
+  const auto orders = response(*out, 0).get_ptr("result")->as_array_ptr();
+  assert(orders && orders->elems.size() == 2);
+  assert(orders->elems[0].as_i64_or(0) == 42);
+  assert(orders->elems[1].as_string_or("") == "ops");
+
+  assert(response(*out, 1).get_ptr("result")->as_object_ptr()->get_i64_or("id", 0) == 42);
+  assert(response(*out, 2).get_ptr("id")->as_string_or("") == "1");
+}
+
+static void test_whole_result_and_nested_refs()
+{
+  Router r;
+  std::vector<std::string> trace;
+  std::mutex mu;
+  register_methods(r, trace, mu);
+  Dispatcher d(r, pipelined());
+
+  auto out = d.handle(array({
+      call("session.resolve", 1, obj({"token", "t1"})),
+      call("echo", 2, obj({"session", ref(1), "list", array({ref(1, "/token"), 7})})),
+  }));
+
+  const auto echoed = response(*out, 1).get_ptr("result")->as_object_ptr();
+  assert(echoed->get_ptr("session")->as_object_ptr()->get_i64_or("user_id", 0) == 42);
+  const auto list = echoed->get_ptr("list")->as_array_ptr();
+  assert(list->elems[0].as_string_or("") == "t1");
+  assert(list->elems[1].as_i64_or(0) == 7);
+}
+
+static void test_invalid_graphs_are_rejected()
+{
+  Router r;
+  std::vector<std::string> trace;
+  std::mutex mu;
+  register_methods(r, trace, mu);
+  Dispatcher d(r, pipelined());
+
+  auto out = d.handle(array({
+      call("user.get", "a", obj({"id", ref("b", "/id")})),     // cycle a <-> b
+      call("user.get", "b", obj({"id", ref("a", "/id")})),
+      call("user.get", "c", obj({"id", ref("c", "/id")})),     // self reference
+      call("user.get", "d", obj({"id", ref("a", "/id")})),     // waits on a cycle
+      call("user.get", "e", obj({"id", ref("zz")})),           // unknown id
+      call("fail", "f", obj({})),
+      call("user.get", "g", obj({"id", ref("f", "/id")})),     // failed input
+      call("user.get", "h", obj({"id", 5})),
+      call("user.get", "i", obj({"id", ref("h", "/nope")})),   // missing path
+      call("user.get", "j", obj({"id", ref("h", "/id")})),
+  }));
+  assert(out.has_value());
+
+  assert(error_reason(response(*out, 0)) == "cyclic reference");
+  assert(error_reason(response(*out, 1)) == "cyclic reference");
+  assert(error_reason(response(*out, 2)) == "cyclic reference");
+  assert(error_reason(response(*out, 3)) == "cyclic reference");
+  assert(error_reason(response(*out, 4)) == "unresolved reference: zz");
+  assert(error_reason(response(*out, 6)) == "referenced call failed");
+  assert(error_reason(response(*out, 8)) == "reference path not found: /nope");
+  assert(response(*out, 9).get_ptr("result")->as_object_ptr()->get_i64_or("id", 0) == 5);
+
+  // Only h and j ran user.get.
+  assert(std::count(trace.begin(), trace.end(), "user") == 2);
+}
+
+static void test_disabled_by_default()
+{
+  Router r;
+  std::vector<std::string> trace;
+  std::mutex mu;
+  register_methods(r, trace, mu);
+  Dispatcher d(r);
+
+  auto out = d.handle(array({
+      call("session.resolve", 1, obj({})),
+      call("echo", 2, obj({"x", ref(1)})),
+  }));
+
+  // Passed through as plain data.
+  const auto echoed = response(*out, 1).get_ptr("result")->as_object_ptr();
+  assert(as_reference(*echoed->get_ptr("x")).has_value());
+}
+
+static void test_json_pointer()
+{
+  const token doc = obj({
+      "a/b",
+      1,
+      "m~n",
+      2,
+      "list",
+      array({10, 20, obj({"k", "v"})}),
+      "",
+      3,
+  });
+
+  assert(resolve_pointer(doc, "")->as_object_ptr());
+  assert(resolve_pointer(doc, "/a~1b")->as_i64_or(0) == 1);
+  assert(resolve_pointer(doc, "/m~0n")->as_i64_or(0) == 2);
+  assert(resolve_pointer(doc, "/list/1")->as_i64_or(0) == 20);
+  assert(resolve_pointer(doc, "/list/2/k")->as_string_or("") == "v");
+  assert(resolve_pointer(doc, "/")->as_i64_or(0) == 3);
+
+  assert(!resolve_pointer(doc, "list"));
+  assert(!resolve_pointer(doc, "/list/01"));
+  assert(!resolve_pointer(doc, "/list/3"));
+  assert(!resolve_pointer(doc, "/list/-"));
+  assert(!resolve_pointer(doc, "/a~2b"));
+  assert(!resolve_pointer(doc, "/missing"));
+  assert(!resolve_pointer(doc, "/a~1b/x"));
+
+  // Exactly {"$ref"} or {"$ref", "path"}: anything else is plain data.
+  assert(as_reference(obj({"$ref", "1"})));
+  assert(as_reference(obj({"$ref", 1, "path", "/x"})));
+  assert(!as_reference(obj({"$ref", "1", "other", 2})));
+  assert(!as_reference(obj({"$ref", 1.5})));
+  assert(!as_reference(obj({"$ref", "1", "path", 3})));
+}
+
+static void test_post_runs_graph_on_scheduler()
+{
+  Router r;
+  std::vector<std::string> trace;
+  std::mutex mu;
+  register_methods(r, trace, mu);
+  Dispatcher d(r, pipelined());
+
+  SchedulerOptions so;
+  so.workers = 2;
+  Scheduler s(so);
+
+  std::promise<std::optional<token>> done;
+  d.post(s, array({
+                call("orders.list", 3, obj({"user", ref(2, "/id"), "tag", "x"})),
+                call("session.resolve", 1, obj({"token", "t"})),
+                call("user.get", 2, obj({"id", ref(1, "/user_id")})),
+                call("user.get", 4, obj({"id", 9})),                   // independent
+                call("echo", nullptr, obj({"v", ref(4, "/id")})),      // notification
+            }),
+         [&](std::optional<token> out)
+         { done.set_value(std::move(out)); });
+
+  const auto out = done.get_future().get();
+  assert(out.has_value());
+  assert(out->as_array_ptr()->elems.size() == 4);
+
+  const auto orders = response(*out, 0).get_ptr("result")->as_array_ptr();
+  assert(orders->elems[0].as_i64_or(0) == 42);
+
+  std::lock_guard<std::mutex> lock(mu);
+  const auto pos = [&](const char *name)
+  { return std::find(trace.begin(), trace.end(), name) - trace.begin(); };
+  assert(pos("session") < pos("orders"));
+}
+
+static void test_graph_bookkeeping_uses_the_arena()
+{
+  Router r;
+  r.add("echo", [](const Context &ctx) -> RpcResult
+        { return ctx.params; });
+
+  // A chain: each item references the one before it (long ids: no small-string storage).
+  constexpr long long n = 64;
+  auto chain = [&]
+  {
+    const std::string prefix(40, 'k');
+    array_t items;
+    items.elems.push_back(call("echo", prefix + "0", obj({"v", 0})));
+    for (long long i = 1; i < n; ++i)
+      items.elems.push_back(call("echo", prefix + std::to_string(i),
+                                 obj({"v", ref(prefix + std::to_string(i - 1), "/v")})));
+    return token(std::move(items));
+  };
+
+  DispatcherOptions heap_opts = pipelined();
+  DispatcherOptions arena_opts = pipelined();
+  arena_opts.request_arena = true;
+  Dispatcher heap(r, heap_opts);
+  Dispatcher arena(r, arena_opts);
+
+  const token payload = chain();
+  std::optional<token> a, b;
+  const AllocCount on_heap = count_allocations([&]
+                                               { a = heap.handle(payload); });
+  const AllocCount in_arena = count_allocations([&]
+                                                { b = arena.handle(payload); });
+
+  assert(a.has_value() && b.has_value());
+  assert(response(*b, n - 1).get_ptr("result")->as_object_ptr()->get_i64_or("v", -1) == 0);
+
+  // Per item: the reference list, the id index node and key, the dependents list.
+  assert(in_arena.calls + 3 * n <= on_heap.calls);
+}
+
+int main()
+{
+  test_chain_in_one_round_trip();
+  test_whole_result_and_nested_refs();
+  test_invalid_graphs_are_rejected();
+  test_disabled_by_default();
+  test_json_pointer();
+  test_post_runs_graph_on_scheduler();
+  test_graph_bookkeeping_uses_the_arena();
+
+  std::cout << "[webrpc] batch_references OK\n";
+  return 0;
+}
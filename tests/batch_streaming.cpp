@@ -0,0 +1,223 @@
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/webrpc/Scheduler.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+using namespace std::chrono_literals;
+
+static token call(const char *method, token id, token params = obj({}))
+{
+  return obj({
+      "id",
+      std::move(id),
+      "method",
+      method,
+      "params",
+      std::move(params),
+  });
+}
+
+struct Collected
+{
+  std::mutex mu;
+  std::vector<RpcResponse> responses;
+  std::optional<std::size_t> end;
+
+  BatchSink sink()
+  {
+    return BatchSink{
+        [this](RpcResponse r)
+        {
+          std::lock_guard<std::mutex> lock(mu);
+          assert(!end.has_value() && "response after the end marker");
+          responses.push_back(std::move(r));
+        },
+        [this](std::size_t n)
+        {
+          std::lock_guard<std::mutex> lock(mu);
+          assert(!end.has_value());
+          end = n;
+        },
+    };
+  }
+
+  std::vector<std::string> ids()
+  {
+    std::vector<std::string> out;
+    for (const auto &r : responses)
+    {
+      if (const std::string *s = r.id.as_string())
+        out.push_back(*s);
+      else
+        out.push_back(r.id.is_null() ? "null" : std::to_string(r.id.as_i64_or(0)));
+    }
+    return out;
+  }
+};
+
+static void test_sync_stream_delivers_in_completion_order()
+{
+  Router r;
+  MethodOptions idem;
+  idem.idempotent = true;
+
+  r.add("echo", [](const Context &ctx) -> RpcResult
+        { return ctx.params; }, idem);
+
+  r.add_batch("multi", [](std::span<const Context> calls, std::span<RpcResult> results)
+              {
+                for (std::size_t i = 0; i < calls.size(); ++i)
+                  results[i] = token(static_cast<long long>(i)); });
+
+  DispatcherOptions o;
+  o.dedupe_batches = true;
+  Dispatcher d(r, o);
+
+  Collected c;
+  d.stream(array({
+               call("echo", "a", obj({"v", 1})),
+               call("multi", "b"),
+               token(42),                              // malformed
+               call("echo", nullptr, obj({"v", 2})),   // notification
+               call("multi", "c"),
+               call("echo", "d", obj({"v", 1})),       // alias of "a"
+           }),
+           c.sink());
+
+  // Malformed first, then by completion: a (with its alias d), the multi group.
+  assert(c.end == 5);
+  assert((c.ids() == std::vector<std::string>{"null", "a", "d", "b", "c"}));
+  assert(c.responses[0].has_error());
+  assert(c.responses[2].result().as_object_ptr()->get_i64_or("v", 0) == 1);
+  assert(c.responses[4].result().as_i64_or(-1) == 1);
+}
+
+static void test_single_call_and_empty_batch()
+{
+  Router r;
+  r.add("ping", [](const Context &) -> RpcResult
+        { return token("pong"); });
+  Dispatcher d(r);
+
+  Collected one;
+  d.stream(call("ping", 7), one.sink());
+  assert(one.end == 1);
+  assert(one.responses[0].result().as_string_or("") == "pong");
+
+  Collected note;
+  d.stream(call("ping", nullptr), note.sink());
+  assert(note.end == 0);
+  assert(note.responses.empty());
+
+  Collected empty;
+  d.stream(array({}), empty.sink());
+  assert(empty.end == 1);
+  assert(empty.responses[0].has_error());
+}
+
+static void test_fast_items_do_not_wait_for_slow_ones()
+{
+  Router r;
+
+  std::promise<void> fast_seen;
+  std::shared_future<void> fast_seen_f = fast_seen.get_future().share();
+
+  r.add("slow", [&](const Context &) -> RpcResult
+        {
+          // Only finishes once the client already got the fast result.
+          const bool streamed = fast_seen_f.wait_for(5s) == std::future_status::ready;
+          return token(streamed); });
+
+  r.add("fast", [](const Context &) -> RpcResult
+        { return token("done"); });
+
+  Dispatcher d(r);
+
+  SchedulerOptions so;
+  so.workers = 2;
+  Scheduler s(so);
+
+  std::mutex mu;
+  std::vector<std::string> order;
+  std::promise<std::size_t> ended;
+  std::optional<bool> slow_result;
+
+  d.post_stream(s, array({call("slow", "s"), call("fast", "f")}),
+                BatchSink{
+                    [&](RpcResponse resp)
+                    {
+                      std::lock_guard<std::mutex> lock(mu);
+                      order.push_back(resp.id.as_string_or(""));
+                      if (order.back() == "f")
+                        fast_seen.set_value();
+                      else
+                        slow_result = resp.result().as_bool_or(false);
+                    },
+                    [&](std::size_t n)
+                    { ended.set_value(n); },
+                });
+
+  const std::size_t n = ended.get_future().get();
+  assert(n == 2);
+  assert((order == std::vector<std::string>{"f", "s"}));
+  assert(slow_result == true);
+}
+
+static void test_post_stream_pipelined_batch()
+{
+  Router r;
+  r.add("inc", [](const Context &ctx) -> RpcResult
+        { return token(ctx.params.as_object_ptr()->get_i64_or("n", 0) + 1); });
+
+  DispatcherOptions o;
+  o.batch_references = true;
+  Dispatcher d(r, o);
+
+  SchedulerOptions so;
+  so.workers = 2;
+  Scheduler s(so);
+
+  Collected c;
+  std::promise<void> ended;
+  BatchSink sink = c.sink();
+  auto on_end = sink.on_end;
+  sink.on_end = [&, on_end](std::size_t n)
+  {
+    on_end(n);
+    ended.set_value();
+  };
+
+  d.post_stream(s, array({
+                       call("inc", 1, obj({"n", 1})),
+                       call("inc", 2, obj({"n", obj({"$ref", 1})})),
+                       call("inc", 3, obj({"n", obj({"$ref", 2})})),
+                   }),
+                sink);
+
+  ended.get_future().wait();
+  assert(c.end == 3);
+  assert((c.ids() == std::vector<std::string>{"1", "2", "3"}));
+  assert(c.responses[2].result().as_i64_or(0) == 4);
+}
+
+int main()
+{
+  test_sync_stream_delivers_in_completion_order();
+  test_single_call_and_empty_batch();
+  test_fast_items_do_not_wait_for_slow_ones();
+  test_post_stream_pipelined_batch();
+
+  std::cout << "[webrpc] batch_streaming OK\n";
+  return 0;
+}
@@ -0,0 +1,188 @@
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "alloc_counter.hpp"
+
+#include <vix/webrpc/BufferPool.hpp>
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static void fill(PooledBuffer &buf, std::size_t n) { buf.str().append(n, 'x'); }
+
+static void test_buffers_are_reused()
+{
+  BufferPool pool;
+
+  const char *data = nullptr;
+  {
+    PooledBuffer buf = pool.acquire();
+    fill(buf, 1000);
+    data = buf.data();
+  }
+  assert(pool.stats().retained_buffers == 1);
+  assert(pool.stats().retained_bytes >= 1000);
+
+  const AllocCount c = count_allocations([&]
+                                         {
+                                           PooledBuffer buf = pool.acquire();
+                                           assert(buf.empty());
+                                           assert(buf.str().capacity() >= 1000);
+                                           fill(buf, 800);
+                                           assert(buf.data() == data); });
+  assert(c.calls == 0);
+
+  const BufferPoolStats s = pool.stats();
+  assert(s.acquires == 2);
+  assert(s.hits == 1);
+  assert(s.hit_rate() == 0.5);
+  assert(s.dropped == 0);
+}
+
+static void test_retention_limits()
+{
+  BufferPoolOptions o;
+  o.max_buffer_bytes = 4096;
+  o.max_retained_bytes = 8192;
+  o.trim_interval = 0;
+  BufferPool pool(o);
+
+  // Oversized: freed on return.
+  {
+    PooledBuffer buf = pool.acquire();
+    fill(buf, 10000);
+  }
+  assert(pool.stats().retained_buffers == 0);
+  assert(pool.stats().dropped == 1);
+
+  // Total cap: the buffers that do not fit are freed.
+  {
+    PooledBuffer a = pool.acquire(), b = pool.acquire(), c = pool.acquire();
+    fill(a, 3000);
+    fill(b, 3000);
+    fill(c, 3000);
+  }
+  assert(pool.stats().retained_buffers == 2);
+  assert(pool.stats().retained_bytes <= o.max_retained_bytes);
+  assert(pool.stats().dropped == 2);
+
+  // Small strings hold no heap memory: nothing to keep.
+  {
+    PooledBuffer buf = pool.acquire();
+    fill(buf, 4);
+  }
+  assert(pool.stats().dropped == 2);
+
+  // Tighter policy: idle buffers over it are freed at once.
+  o.max_retained_bytes = 4096;
+  pool.set_options(o);
+  assert(pool.stats().retained_buffers == 1);
+  assert(pool.stats().retained_bytes <= 4096);
+
+  // A released string is not given back.
+  std::string kept;
+  {
+    PooledBuffer buf = pool.acquire();
+    fill(buf, 2000);
+    kept = buf.release();
+  }
+  assert(kept.size() == 2000);
+  assert(pool.stats().retained_buffers == 0);
+
+  pool.clear();
+  assert(pool.stats().retained_bytes == 0);
+}
+
+static void test_burst_is_trimmed()
+{
+  BufferPoolOptions o;
+  o.max_buffer_bytes = 1 << 20;
+  o.max_retained_bytes = 4 << 20;
+  o.trim_interval = 8;
+  BufferPool pool(o);
+
+  // Burst: several large responses in flight at once.
+  {
+    PooledBuffer big[4];
+    for (PooledBuffer &b : big)
+    {
+      b = pool.acquire();
+      fill(b, 256 * 1024);
+    }
+  }
+  assert(pool.stats().retained_bytes >= 4 * 256 * 1024);
+
+  // Back to small responses: within two windows the burst buffers are gone.
+  for (int i = 0; i < 16; ++i)
+  {
+    PooledBuffer buf = pool.acquire();
+    fill(buf, 200);
+  }
+  const BufferPoolStats s = pool.stats();
+  assert(s.retained_bytes < 4096);
+  assert(s.trimmed == 4);
+
+  // The next small buffer stays warm.
+  {
+    PooledBuffer buf = pool.acquire();
+    fill(buf, 200);
+  }
+  const AllocCount c = count_allocations([&]
+                                         {
+                                           PooledBuffer buf = pool.acquire();
+                                           fill(buf, 200); });
+  assert(c.calls == 0);
+}
+
+static void test_dispatcher_serialize()
+{
+  Router r;
+  r.add("sum", [](const Context &ctx) -> RpcResult
+        { return token(ctx.params.as_object_ptr()->get_i64_or("a", 0) + 1); });
+  Dispatcher d(r);
+
+  const token call = obj({"id", 1, "method", "sum", "params", obj({"a", 2})});
+
+  std::string expected;
+  const bool wrote = d.write(call, expected);
+  assert(wrote);
+
+  {
+    auto out = d.serialize(call);
+    assert(out.has_value());
+    assert(out->view() == expected);
+  }
+  const auto none = d.serialize(obj({"method", "sum", "params", obj({"a", 2})}));
+  assert(!none.has_value());
+
+  // Warm: the response is written into the buffer of the previous call.
+  const BufferPoolStats before = BufferPool::this_thread().stats();
+  const AllocCount c = count_allocations([&]
+                                         {
+                                           auto out = d.serialize(call);
+                                           assert(out->view() == expected); });
+  assert(c.calls == 0);
+  assert(BufferPool::this_thread().stats().hits == before.hits + 1);
+
+  BufferPool own;
+  auto out = d.serialize(call, own, "http");
+  assert(out->view() == expected);
+  assert(own.stats().acquires == 1);
+}
+
+int main()
+{
+  test_buffers_are_reused();
+  test_retention_limits();
+  test_burst_is_trimmed();
+  test_dispatcher_serialize();
+
+  std::cout << "[webrpc] buffer_pool OK\n";
+  return 0;
+}
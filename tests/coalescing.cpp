@@ -0,0 +1,194 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static token call(const char *method, long long id, token params)
+{
+  return obj({
+      "id",
+      id,
+      "method",
+      method,
+      "params",
+      std::move(params),
+  });
+}
+
+// Blocks until `n` followers joined the current flight (or a timeout elapses).
+static void wait_for_followers(const Dispatcher &d, std::uint64_t n)
+{
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (d.coalescing().coalesced < n && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+static void test_identical_calls_share_one_execution()
+{
+  constexpr int callers = 8;
+
+  Router r;
+  std::atomic<int> runs{0};
+  const Dispatcher *self = nullptr;
+
+  MethodOptions opts;
+  opts.idempotent = true;
+
+  r.add("config.get", [&](const Context &ctx) -> RpcResult
+        {
+          runs.fetch_add(1);
+          wait_for_followers(*self, callers - 1);
+          return token(ctx.params.as_object_ptr()->get_string_or("key", "") + "=on"); }, opts);
+
+  Dispatcher d(r);
+  self = &d;
+
+  std::vector<std::optional<RpcResponse>> out(callers);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < callers; ++i)
+  {
+    threads.emplace_back([&, i]
+                         {
+                           // Same params, key order alternating between callers.
+                           token params = (i % 2 == 0)
+                                              ? obj({"key", "flags", "env", "prod"})
+                                              : obj({"env", "prod", "key", "flags"});
+                           out[i] = d.handle_one(call("config.get", 100 + i, params)); });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  assert(runs.load() == 1);
+  assert(d.coalescing().executed == 1);
+  assert(d.coalescing().coalesced == callers - 1);
+  assert(d.coalescing().in_flight == 0);
+
+  for (int i = 0; i < callers; ++i)
+  {
+    assert(out[i].has_value());
+    assert(!out[i]->has_error());
+    assert(out[i]->id.as_i64_or(0) == 100 + i);
+    assert(*out[i]->result().as_string() == "flags=on");
+  }
+}
+
+static void test_different_params_run_separately()
+{
+  Router r;
+  std::atomic<int> runs{0};
+
+  MethodOptions opts;
+  opts.idempotent = true;
+
+  r.add("config.get", [&](const Context &ctx) -> RpcResult
+        {
+          runs.fetch_add(1);
+          return ctx.params; }, opts);
+
+  Dispatcher d(r);
+
+  d.handle_one(call("config.get", 1, obj({"key", "a"})));
+  d.handle_one(call("config.get", 2, obj({"key", "b"})));
+  d.handle_one(call("config.get", 3, obj({"key", 1})));
+
+  // Sequential calls never overlap, so each one leads its own flight.
+  d.handle_one(call("config.get", 4, obj({"key", "a"})));
+
+  assert(runs.load() == 4);
+  assert(d.coalescing().executed == 4);
+  assert(d.coalescing().coalesced == 0);
+}
+
+static void test_non_idempotent_methods_are_not_merged()
+{
+  constexpr int callers = 4;
+
+  Router r;
+  std::atomic<int> runs{0};
+  std::atomic<int> entered{0};
+
+  r.add("counter.inc", [&](const Context &) -> RpcResult
+        {
+          runs.fetch_add(1);
+          entered.fetch_add(1);
+          // Every caller must be inside the handler at the same time.
+          const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+          while (entered.load() < callers && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          return token(true); });
+
+  Dispatcher d(r);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < callers; ++i)
+    threads.emplace_back([&, i]
+                         { d.handle_one(call("counter.inc", i, obj({"by", 1}))); });
+  for (auto &t : threads)
+    t.join();
+
+  assert(runs.load() == callers);
+  assert(entered.load() == callers);
+  assert(d.coalescing().executed == 0);
+}
+
+static void test_followers_skip_admission()
+{
+  constexpr int callers = 4;
+
+  Router r;
+  std::atomic<int> runs{0};
+  const Dispatcher *self = nullptr;
+
+  MethodOptions opts;
+  opts.idempotent = true;
+  opts.limits.max_in_flight = 1;
+
+  r.add("config.get", [&](const Context &) -> RpcResult
+        {
+          runs.fetch_add(1);
+          wait_for_followers(*self, callers - 1);
+          return token(42); }, opts);
+
+  Dispatcher d(r);
+  self = &d;
+
+  std::vector<std::optional<RpcResponse>> out(callers);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < callers; ++i)
+    threads.emplace_back([&, i]
+                         { out[i] = d.handle_one(call("config.get", i, obj({"key", "x"}))); });
+  for (auto &t : threads)
+    t.join();
+
+  assert(runs.load() == 1);
+  for (const auto &resp : out)
+  {
+    assert(resp.has_value());
+    assert(!resp->has_error());
+    assert(resp->result().as_i64_or(0) == 42);
+  }
+
+  const AdmissionStats s = r.find("config.get")->admission->stats();
+  assert(s.admitted == 1);
+  assert(s.rejected_in_flight == 0);
+}
+
+int main()
+{
+  test_identical_calls_share_one_execution();
+  test_different_params_run_separately();
+  test_non_idempotent_methods_are_not_merged();
+  test_followers_skip_admission();
+
+  std::cout << "[webrpc] coalescing OK\n";
+  return 0;
+}
@@ -0,0 +1,135 @@
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <variant>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Request.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static token write_call(long long id, std::string blob)
+{
+  return obj({"id", id, "method", "doc.put", "params", token(std::move(blob))});
+}
+
+static void test_parse_moves_params_out()
+{
+  token payload = write_call(1, std::string(100 * 1024, 'x'));
+  const char *bytes = payload.as_object_ptr()->get_ptr("params")->as_string()->data();
+
+  auto parsed = RpcRequest::parse(std::move(payload));
+  const RpcRequest &req = std::get<RpcRequest>(parsed);
+  assert(req.method == "doc.put");
+  assert(req.id.as_i64_or(0) == 1);
+  assert(req.params.as_string()->data() == bytes);
+}
+
+static void test_parse_copies_a_shared_payload()
+{
+  token payload = write_call(1, std::string(1024, 'x'));
+  const token other_owner = payload;
+
+  auto parsed = RpcRequest::parse(std::move(payload));
+  assert(std::get<RpcRequest>(parsed).params.as_string()->size() == 1024);
+
+  // The other owner still sees the whole payload.
+  assert(other_owner.as_object_ptr()->get_ptr("params")->as_string()->size() == 1024);
+  assert(other_owner.as_object_ptr()->get_i64_or("id", 0) == 1);
+}
+
+static void test_parse_rules_are_unchanged()
+{
+  assert(std::holds_alternative<RpcError>(RpcRequest::parse(token(42))));
+  assert(std::holds_alternative<RpcError>(RpcRequest::parse(obj({"id", 1}))));
+  assert(std::holds_alternative<RpcError>(RpcRequest::parse(obj({"id", 1.5, "method", "m"}))));
+
+  DispatcherLimits limits;
+  limits.max_params_bytes = 16;
+  auto big = RpcRequest::parse(write_call(1, std::string(64, 'x')), limits);
+  assert(std::get<RpcError>(big).kind() == ErrorCode::params_too_large);
+}
+
+static void test_handler_takes_params()
+{
+  Router r;
+  token stored{nullptr};
+  r.add("doc.put", [&](const Context &ctx) -> RpcResult
+        {
+          stored = ctx.take_params();
+          assert(ctx.params.is_null());
+          return token(true); });
+
+  r.add("doc.obj", [&](const Context &ctx) -> RpcResult
+        {
+          stored = ctx.take_params();
+          return token(true); });
+
+  Dispatcher d(r);
+
+  token payload = write_call(1, std::string(100 * 1024, 'y'));
+  const char *bytes = payload.as_object_ptr()->get_ptr("params")->as_string()->data();
+  auto out = d.handle(std::move(payload));
+  assert(out.has_value());
+  assert(stored.as_string()->data() == bytes);
+
+  // Object params: the handler ends up as the only owner.
+  token obj_payload = obj({"id", 2, "method", "doc.obj", "params", obj({"title", "t"})});
+  const kvs *params = obj_payload.as_object_ptr()->get_ptr("params")->as_object_ptr().get();
+  (void)d.handle(std::move(obj_payload));
+  assert(stored.as_object_ptr().get() == params);
+  assert(stored.as_object_ptr().use_count() == 2);
+}
+
+static void test_shared_params_are_copied()
+{
+  Router r;
+  token stored{nullptr};
+  r.add("doc.put", [&](const Context &ctx) -> RpcResult
+        {
+          stored = ctx.take_params();
+          assert(!ctx.params.is_null());
+          return token(true); });
+
+  MethodOptions cached;
+  cached.cache_ttl = std::chrono::seconds(10);
+  r.add("doc.get", [&](const Context &ctx) -> RpcResult
+        {
+          stored = ctx.take_params();
+          assert(!ctx.params.is_null());
+          return token(1); },
+        cached);
+
+  DispatcherOptions o;
+  o.cache.max_bytes = 1 << 20;
+  Dispatcher d(r, o);
+
+  // Kept payload: the handler gets a copy.
+  const token payload = write_call(1, "abc");
+  (void)d.handle(payload);
+  assert(*stored.as_string() == "abc");
+  assert(*payload.as_object_ptr()->get_ptr("params")->as_string() == "abc");
+
+  // Cached method: the cache reads the params after the handler.
+  (void)d.handle(obj({"id", 1, "method", "doc.get", "params", obj({"k", 1})}));
+  auto again = d.handle(obj({"id", 2, "method", "doc.get", "params", obj({"k", 1})}));
+  assert(again->as_object_ptr()->get_i64_or("result", 0) == 1);
+  assert(d.cache()->stats().hits == 1);
+}
+
+int main()
+{
+  test_parse_moves_params_out();
+  test_parse_copies_a_shared_payload();
+  test_parse_rules_are_unchanged();
+  test_handler_takes_params();
+  test_shared_params_are_copied();
+
+  std::cout << "[webrpc] consuming_dispatch OK\n";
+  return 0;
+}
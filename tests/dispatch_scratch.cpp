@@ -0,0 +1,125 @@
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "alloc_counter.hpp"
+
+#include <vix/webrpc/Arena.hpp>
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static void setup(Router &r)
+{
+  r.add("inventory.reservations.count", [](const Context &ctx) -> RpcResult
+        { return token(ctx.params.as_object_ptr()->get_i64_or("n", 0) * 2); });
+}
+
+static void test_scratch_arena_keeps_its_blocks()
+{
+  ScratchArena arena;
+  assert(arena.capacity() == 0);
+
+  std::pmr::vector<char> a(&arena);
+  a.resize(ScratchArena::initial_bytes * 3);
+  assert(arena.capacity() > ScratchArena::initial_bytes * 3);
+
+  // Split blocks are merged: the next pass fits in one block.
+  arena.rewind();
+  const std::size_t merged = arena.capacity();
+  assert(arena.allocated() == 0);
+
+  const AllocCount heap = count_allocations([&]
+                                            {
+                                              std::pmr::vector<char> b(&arena);
+                                              b.reserve(ScratchArena::initial_bytes * 3);
+                                              arena.rewind(); });
+  assert(heap.calls == 0);
+  assert(arena.capacity() == merged);
+
+  arena.release();
+  assert(arena.capacity() == 0);
+}
+
+static void test_steady_state_allocates_nothing()
+{
+  Router r;
+  setup(r);
+  Dispatcher d(r);
+
+  const token single = obj({"id", 1, "method", "inventory.reservations.count", "params", obj({"n", 21})});
+  const token notification = obj({"method", "inventory.reservations.count", "params", obj({"n", 1})});
+  const token unknown = obj({"id", 2, "method", "inventory.reservations.unknown"});
+
+  array_t items;
+  for (long long i = 0; i < 16; ++i)
+    items.elems.push_back(obj({"id", i, "method", "inventory.reservations.count", "params", obj({"n", i})}));
+  const token batch = token(items);
+
+  DispatchScratch scratch;
+
+  // Warm up: the scratch grows to fit the traffic.
+  for (int k = 0; k < 3; ++k)
+  {
+    for (const token *p : {&single, &notification, &unknown, &batch})
+      (void)d.write(*p, scratch);
+  }
+
+  for (const token *p : {&single, &notification, &unknown, &batch})
+  {
+    bool wrote = false;
+    const AllocCount heap = count_allocations([&]
+                                              { wrote = d.write(*p, scratch); });
+    assert(heap.calls == 0);
+    assert(wrote == (p != &notification));
+  }
+
+  (void)d.write(single, scratch);
+  assert(scratch.output() == R"({"id":1,"result":42})");
+
+  (void)d.write(batch, scratch);
+  std::string via_token;
+  detail::append_json(via_token, *d.handle(batch));
+  assert(scratch.output() == via_token);
+}
+
+static void test_thread_scratch()
+{
+  Router r;
+  setup(r);
+  Dispatcher d(r);
+
+  const token single = obj({"id", 1, "method", "inventory.reservations.count", "params", obj({"n", 2})});
+
+  DispatchScratch *mine = &DispatchScratch::this_thread();
+  assert(mine == &DispatchScratch::this_thread());
+
+  DispatchScratch *theirs = nullptr;
+  std::string their_output;
+  std::thread t([&]
+                {
+                  theirs = &DispatchScratch::this_thread();
+                  (void)d.write(single, *theirs);
+                  their_output = std::string(theirs->output()); });
+  t.join();
+
+  assert(theirs != mine);
+  assert(their_output == R"({"id":1,"result":4})");
+}
+
+int main()
+{
+  test_scratch_arena_keeps_its_blocks();
+  test_steady_state_allocates_nothing();
+  test_thread_scratch();
+
+  std::cout << "[webrpc] dispatch_scratch OK\n";
+  return 0;
+}
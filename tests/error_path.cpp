@@ -0,0 +1,213 @@
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <variant>
+
+#include "alloc_counter.hpp"
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Error.hpp>
+#include <vix/webrpc/Response.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static void test_code_table()
+{
+  static_assert(error_code_of("METHOD_NOT_FOUND") == ErrorCode::method_not_found);
+  static_assert(error_code_of("SOMETHING_ELSE") == ErrorCode::custom);
+  static_assert(error_info(ErrorCode::overloaded).code == "OVERLOADED");
+
+  assert(RpcError::of(ErrorCode::batch_too_large).code == "BATCH_TOO_LARGE");
+  assert(RpcError::internal_error("boom").kind() == ErrorCode::internal_error);
+  assert(RpcError("APP_ERROR", "x").kind() == ErrorCode::custom);
+}
+
+static void test_views_do_not_allocate()
+{
+  std::string out;
+  out.reserve(512);
+
+  const AllocCount heap = count_allocations([&]
+                                            {
+                                              const ErrorView a = ErrorView::parse_error("request must be an object");
+                                              const ErrorView b = ErrorView::invalid_params("a literal reason that is longer than any inline buffer");
+                                              const ErrorView c = ErrorView::method_not_found("user.get");
+                                              const ErrorView d = ErrorView::limit(ErrorCode::params_too_large, 4096);
+                                              assert(a.has_details() && b.has_details() && c.has_details() && d.has_details());
+                                              assert(!ErrorView::of(ErrorCode::overloaded).has_details());
+
+                                              c.write_json(out);
+                                              out.push_back(' ');
+                                              d.write_json(out);
+
+                                              // Short built-in code and message: copying stays inline.
+                                              RpcError e = RpcError::overloaded();
+                                              assert(!e.has_details()); });
+  assert(heap.calls == 0);
+  assert(out == R"({"code":"METHOD_NOT_FOUND","message":"RPC method not found","details":{"method":"user.get"}} )"
+                R"({"code":"PARAMS_TOO_LARGE","message":"RPC params too large","details":{"limit":4096}})");
+}
+
+static void test_factories_match_views()
+{
+  const RpcError e = RpcError::method_not_found("user.get");
+  std::string from_error;
+  std::string from_view;
+  e.write_json(from_error);
+  ErrorView::method_not_found("user.get").write_json(from_view);
+  assert(from_error == from_view);
+  assert(e.kind() == ErrorCode::method_not_found);
+
+  const RpcError i = RpcError::internal_error("boom");
+  assert(i.code == "INTERNAL_ERROR" && i.message == "boom" && !i.has_details());
+}
+
+static void test_dynamic_text_is_copied()
+{
+  std::string reason = "unresolved reference: $a";
+  RpcError e = RpcError::invalid_params(reason);
+  reason.assign("overwritten");
+
+  assert(e.message == "Invalid RPC parameters");
+  assert(e.details.as_object_ptr()->get_string_or("reason", "") == "unresolved reference: $a");
+
+  char buf[16] = "user.delete";
+  RpcError m = RpcError::method_not_found(std::string_view(buf));
+  buf[0] = 'X';
+  assert(m.details.as_object_ptr()->get_string_or("method", "") == "user.delete");
+
+  // A buffer is copied like any other runtime text.
+  char why[32] = "field too long";
+  RpcError p = RpcError::invalid_params(why);
+  RpcError q = RpcError::internal_error(why);
+  why[0] = 'X';
+  assert(p.details.as_object_ptr()->get_string_or("reason", "") == "field too long");
+  assert(q.message == "field too long");
+}
+
+static void test_details_materialize_when_serialized()
+{
+  const RpcError e = RpcError::batch_too_large(64);
+  const token j = e.to_json();
+  const kvs &o = *j.as_object_ptr();
+  assert(o.get_string_or("code", "") == "BATCH_TOO_LARGE");
+  assert(o.get_string_or("message", "") == "RPC batch too large");
+  assert(o.get_ptr("details")->as_object_ptr()->get_i64_or("limit", 0) == 64);
+
+  std::string text;
+  e.write_json(text);
+  assert(text == R"({"code":"BATCH_TOO_LARGE","message":"RPC batch too large","details":{"limit":64}})");
+
+  text.clear();
+  RpcError("APP_ERROR", "say \"hi\"", obj({"n", 1})).write_json(text);
+  assert(text == R"({"code":"APP_ERROR","message":"say \"hi\"","details":{"n":1}})");
+}
+
+static void test_parse_recognizes_builtin_codes()
+{
+  auto known = RpcError::parse(RpcError::method_not_found("a.b").to_json());
+  assert(known.ok());
+  assert(known.value().kind() == ErrorCode::method_not_found);
+  assert(known.value().message == "RPC method not found");
+
+  auto custom = RpcError::parse(obj({"code", "APP_ERROR", "message", "nope"}));
+  assert(custom.ok());
+  assert(custom.value().kind() == ErrorCode::custom);
+  assert(custom.value().code == "APP_ERROR");
+}
+
+static void test_response_write_json_matches_to_json()
+{
+  std::string text;
+  RpcResponse::fail(token(7), RpcError::method_not_found("x")).write_json(text);
+  assert(text == R"({"id":7,"error":{"code":"METHOD_NOT_FOUND","message":"RPC method not found","details":{"method":"x"}}})");
+
+  text.clear();
+  RpcResponse::ok(token("a"), obj({"v", array({1, true, nullptr})})).write_json(text);
+  assert(text == R"({"id":"a","result":{"v":[1,true,null]}})");
+}
+
+static void test_rejected_requests_do_not_allocate()
+{
+  Router r;
+  r.add("ping", [](const Context &) -> RpcResult
+        { return token("pong"); });
+  Dispatcher d(r);
+
+  const token malformed = token(42);
+  const token missing = obj({"id", 1, "params", nullptr});
+  const token unknown = obj({"id", 1, "method", "nope"});
+
+  std::string out;
+  out.reserve(512);
+
+  // Warm up (function-local statics of the dispatcher).
+  (void)d.write(malformed, out);
+  (void)d.write(unknown, out);
+
+  for (const token *p : {&malformed, &missing, &unknown})
+  {
+    out.clear();
+    bool wrote = false;
+    const AllocCount heap = count_allocations([&]
+                                              { wrote = d.write(*p, out); });
+    assert(wrote);
+    assert(heap.calls == 0);
+  }
+
+  out.clear();
+  (void)d.write(malformed, out);
+  assert(out == R"({"id":null,"error":{"code":"PARSE_ERROR","message":"Failed to parse RPC payload","details":{"reason":"request must be an object"}}})");
+
+  out.clear();
+  (void)d.write(unknown, out);
+  assert(out == R"({"id":1,"error":{"code":"METHOD_NOT_FOUND","message":"RPC method not found","details":{"method":"nope"}}})");
+}
+
+static void test_write_batches()
+{
+  Router r;
+  r.add("ping", [](const Context &) -> RpcResult
+        { return token("pong"); });
+  Dispatcher d(r);
+
+  std::string out = "prefix:";
+  bool wrote = d.write(array({obj({"id", 1, "method", "ping"}), 5, obj({"method", "ping"})}), out);
+  assert(wrote);
+  assert(out == R"(prefix:[{"id":1,"result":"pong"},{"id":null,"error":{"code":"PARSE_ERROR","message":"Failed to parse RPC payload","details":{"reason":"batch item must be an object"}}}])");
+
+  // Only notifications: nothing written, buffer untouched.
+  out = "prefix:";
+  wrote = d.write(array({obj({"method", "ping"})}), out);
+  assert(!wrote);
+  assert(out == "prefix:");
+
+  // Same JSON as handle().
+  const token payload = array({obj({"id", 2, "method", "ping"}), obj({"id", 3, "method", "nope"})});
+  std::string via_token;
+  detail::append_json(via_token, *d.handle(payload));
+  out.clear();
+  wrote = d.write(payload, out);
+  assert(wrote);
+  assert(out == via_token);
+}
+
+int main()
+{
+  test_code_table();
+  test_views_do_not_allocate();
+  test_factories_match_views();
+  test_dynamic_text_is_copied();
+  test_details_materialize_when_serialized();
+  test_parse_recognizes_builtin_codes();
+  test_response_write_json_matches_to_json();
+  test_rejected_requests_do_not_allocate();
+  test_write_batches();
+
+  std::cout << "[webrpc] error_path OK\n";
+  return 0;
+}
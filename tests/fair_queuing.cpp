@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <latch>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/webrpc/Scheduler.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+using namespace std::chrono_literals;
+
+// Occupies the single worker until opened, so tasks pile up in the queues.
+struct Gate
+{
+  std::promise<void> held;
+  std::promise<void> opened;
+  std::shared_future<void> wait = opened.get_future().share();
+
+  /// Task body: tell the test the worker is taken, then block until opened.
+  void hold()
+  {
+    held.set_value();
+    wait.wait();
+  }
+};
+
+static SchedulerOptions single_worker()
+{
+  SchedulerOptions o;
+  o.workers = 1;
+  o.aging = 0ms;
+  return o;
+}
+
+static void test_round_robin_between_clients()
+{
+  std::vector<std::string> order;
+  Gate gate;
+
+  {
+    std::future<void> held = gate.held.get_future();
+    Scheduler s(single_worker());
+    s.submit(Priority::normal, "gate", [&]
+             { gate.hold(); });
+    held.wait();
+
+    for (int i = 0; i < 6; ++i)
+      s.submit(Priority::normal, "A", [&]
+               { order.push_back("A"); });
+    for (int i = 0; i < 2; ++i)
+      s.submit(Priority::normal, "B", [&]
+               { order.push_back("B"); });
+    s.submit(Priority::normal, "C", [&]
+             { order.push_back("C"); });
+
+    assert(s.queue_depth("A") == 6);
+    assert(s.queue_depth("B") == 2);
+    assert(s.stats(Priority::normal).clients == 3);
+
+    gate.opened.set_value();
+  }
+
+  const std::vector<std::string> expected{"A", "B", "C", "A", "B", "A", "A", "A", "A"};
+  assert(order == expected);
+}
+
+static void test_deficit_accounts_for_cost()
+{
+  std::vector<std::string> order;
+  Gate gate;
+
+  SchedulerOptions o = single_worker();
+  o.fair_quantum = 2;
+
+  {
+    std::future<void> held = gate.held.get_future();
+    Scheduler s(o);
+    s.submit(Priority::normal, "gate", [&]
+             { gate.hold(); });
+    held.wait();
+
+    // "heavy" tasks cost 2, "light" tasks cost 1: light gets two tasks per turn.
+    for (int i = 0; i < 2; ++i)
+      s.submit(Priority::normal, "heavy", [&]
+               { order.push_back("H"); }, 2);
+    for (int i = 0; i < 4; ++i)
+      s.submit(Priority::normal, "light", [&]
+               { order.push_back("L"); }, 1);
+
+    gate.opened.set_value();
+  }
+
+  const std::vector<std::string> expected{"H", "L", "L", "H", "L", "L"};
+  assert(order == expected);
+}
+
+static void test_zero_quantum_is_clamped()
+{
+  SchedulerOptions o = single_worker();
+  o.fair_quantum = 0;
+
+  std::latch ran(2);
+  Scheduler s(o);
+  assert(s.options().fair_quantum == 1);
+
+  const SubmitStatus first = s.submit(Priority::normal, "A", [&]
+                                      { ran.count_down(); });
+  const SubmitStatus second = s.submit(Priority::normal, "B", [&]
+                                       { ran.count_down(); }, 3);
+  assert(first == SubmitStatus::accepted);
+  assert(second == SubmitStatus::accepted);
+
+  ran.wait();
+  assert(s.stats(Priority::normal).started == 2);
+}
+
+static void test_per_client_bound()
+{
+  Gate gate;
+  SchedulerOptions o = single_worker();
+  o.max_queued_per_client = 2;
+
+  std::latch drained(3);
+  auto work = [&]
+  { drained.count_down(); };
+
+  std::future<void> held = gate.held.get_future();
+  Scheduler s(o);
+  s.submit(Priority::normal, "gate", [&]
+           { gate.hold(); });
+  held.wait();
+
+  const SubmitStatus first = s.submit(Priority::normal, "A", work);
+  const SubmitStatus second = s.submit(Priority::bulk, "A", work);
+  assert(first == SubmitStatus::accepted);
+  assert(second == SubmitStatus::accepted);
+
+  bool ran = false;
+  Scheduler::Task extra = [&]
+  { ran = true; };
+  const SubmitStatus refused = s.submit(Priority::normal, "A", std::move(extra));
+  assert(refused == SubmitStatus::client_full);
+  assert(extra && "refused task must be left to the caller");
+
+  const SubmitStatus other = s.submit(Priority::normal, "B", work);
+  assert(other == SubmitStatus::accepted);
+  assert(s.queue_depth("A") == 2);
+  assert(s.stats(Priority::normal).rejected == 1);
+
+  const auto depths = s.client_depths();
+  assert(std::find(depths.begin(), depths.end(), std::pair<std::string, std::size_t>{"A", 2}) != depths.end());
+
+  gate.opened.set_value();
+  drained.wait();
+
+  assert(!ran);
+}
+
+static void test_dispatcher_tenant_fairness()
+{
+  Router r;
+  std::mutex mu;
+  std::vector<std::string> executed;
+  Gate gate;
+
+  r.add("block", [&](const Context &) -> RpcResult
+        {
+          gate.hold();
+          return token(true); });
+
+  r.add("work", [&](const Context &ctx) -> RpcResult
+        {
+          std::lock_guard<std::mutex> lock(mu);
+          executed.emplace_back(ctx.meta_value("tenant"));
+          return token(true); });
+
+  DispatcherOptions opts;
+  opts.client_meta_key = "tenant";
+  Dispatcher d(r, opts);
+
+  Scheduler s(single_worker());
+
+  const MetaView big{{"tenant", "big"}};
+  const MetaView small{{"tenant", "small"}};
+
+  std::future<void> held = gate.held.get_future();
+  std::promise<void> blocked;
+  d.post(s, obj({"id", 0LL, "method", "block"}), [&](std::optional<token>)
+         { blocked.set_value(); });
+  held.wait();
+
+  array_t items;
+  for (long long i = 0; i < 50; ++i)
+    items.elems.push_back(obj({"id", i, "method", "work"}));
+
+  std::promise<void> big_done;
+  std::promise<void> small_done;
+
+  d.post(s, token(items), [&](std::optional<token>)
+         { big_done.set_value(); }, "test", &big);
+  d.post(s, obj({"id", 1LL, "method", "work"}), [&](std::optional<token>)
+         { small_done.set_value(); }, "test", &small);
+
+  assert(s.queue_depth("big") == 50);
+  assert(s.queue_depth("small") == 1);
+
+  gate.opened.set_value();
+  blocked.get_future().wait();
+  big_done.get_future().wait();
+  small_done.get_future().wait();
+
+  const auto pos = std::find(executed.begin(), executed.end(), "small") - executed.begin();
+  assert(pos <= 1 && "small tenant must not wait behind the whole batch");
+}
+
+static void test_dispatcher_rejects_over_client_bound()
+{
+  Router r;
+  Gate gate;
+
+  r.add("block", [&](const Context &) -> RpcResult
+        {
+          gate.hold();
+          return token(true); });
+  r.add("work", [](const Context &) -> RpcResult
+        { return token(true); });
+
+  DispatcherOptions opts;
+  opts.client_meta_key = "tenant";
+  Dispatcher d(r, opts);
+
+  SchedulerOptions so = single_worker();
+  so.max_queued_per_client = 3;
+  Scheduler s(so);
+
+  const MetaView meta{{"tenant", "t1"}};
+
+  std::future<void> held = gate.held.get_future();
+  d.post(s, obj({"id", 0LL, "method", "block"}), [](std::optional<token>) {});
+  held.wait();
+
+  array_t items;
+  for (long long i = 1; i <= 5; ++i)
+    items.elems.push_back(obj({"id", i, "method", "work"}));
+
+  std::promise<std::optional<token>> p;
+  d.post(s, token(items), [&](std::optional<token> out)
+         { p.set_value(std::move(out)); }, "test", &meta);
+
+  gate.opened.set_value();
+  const auto out = p.get_future().get();
+  assert(out.has_value());
+
+  const auto arr = out->as_array_ptr();
+  assert(arr && arr->elems.size() == 5);
+
+  int overloaded = 0;
+  for (const auto &e : arr->elems)
+  {
+    if (const token *err = e.as_object_ptr()->get_ptr("error"))
+    {
+      assert(err->as_object_ptr()->get_string_or("code", "") == "OVERLOADED");
+      ++overloaded;
+    }
+  }
+  assert(overloaded == 2);
+}
+
+int main()
+{
+  test_round_robin_between_clients();
+  test_deficit_accounts_for_cost();
+  test_zero_quantum_is_clamped();
+  test_per_client_bound();
+  test_dispatcher_tenant_fairness();
+  test_dispatcher_rejects_over_client_bound();
+
+  std::cout << "[webrpc] fair_queuing OK\n";
+  return 0;
+}
@@ -0,0 +1,233 @@
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/MemoryBudget.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static std::string error_code(const token &out)
+{
+  const auto err = out.as_object_ptr()->get_ptr("error");
+  return err ? err->as_object_ptr()->get_string_or("code", "") : std::string{};
+}
+
+static void setup(Router &r)
+{
+  // Temporaries through the request memory: `n` longs.
+  r.add("fill", [](const Context &ctx) -> RpcResult
+        {
+          const auto n = static_cast<std::size_t>(ctx.params.as_object_ptr()->get_i64_or("n", 0));
+          std::pmr::vector<long long> v(ctx.memory());
+          for (std::size_t i = 0; i < n; ++i)
+            v.push_back(static_cast<long long>(i));
+          return token(static_cast<long long>(v.size())); });
+
+  // A result of `n` bytes.
+  r.add("blob", [](const Context &ctx) -> RpcResult
+        {
+          const auto n = static_cast<std::size_t>(ctx.params.as_object_ptr()->get_i64_or("n", 0));
+          return token(std::string(n, 'x')); });
+
+  // An error built while the request memory is budgeted.
+  r.add("fail", [](const Context &) -> RpcResult
+        { return RpcError::invalid_params(std::string(64, 'e')); });
+}
+
+static token call(const char *method, long long n, long long id = 1)
+{
+  return obj({"id", id, "method", method, "params", obj({"n", n})});
+}
+
+static void test_budget_resource()
+{
+  MemoryBudget budget(1000);
+  void *p = budget.allocate(600);
+  assert(budget.used() == 600);
+  assert(budget.remaining() == 400);
+
+  bool thrown = false;
+  try
+  {
+    (void)budget.allocate(500);
+  }
+  catch (const std::bad_alloc &)
+  {
+    thrown = true;
+  }
+  assert(thrown);
+  assert(budget.exhausted());
+  assert(budget.used() == 600);
+  budget.deallocate(p, 600);
+
+  MemoryBudget counting(0);
+  const bool charged = counting.charge(1 << 30);
+  assert(charged);
+  assert(!counting.exhausted());
+}
+
+static void test_allocations_over_budget()
+{
+  Router r;
+  setup(r);
+
+  DispatcherOptions o;
+  o.limits.max_request_memory = 64 * 1024;
+  Dispatcher d(r, o);
+
+  auto small = d.handle(call("fill", 100));
+  assert(small->as_object_ptr()->get_i64_or("result", 0) == 100);
+
+  auto big = d.handle(call("fill", 1 << 20));
+  assert(error_code(*big) == "RESOURCE_EXHAUSTED");
+  const auto details = big->as_object_ptr()->get_ptr("error")->as_object_ptr()->get_ptr("details");
+  assert(details->as_object_ptr()->get_i64_or("limit", 0) == 64 * 1024);
+  assert(d.stats().resource_exhausted == 1);
+
+  // The worker keeps serving.
+  auto again = d.handle(call("fill", 100));
+  assert(again->as_object_ptr()->get_i64_or("result", 0) == 100);
+}
+
+static void test_result_over_budget()
+{
+  Router r;
+  setup(r);
+
+  DispatcherOptions o;
+  o.limits.max_request_memory = 4096;
+  o.request_arena = true;
+  Dispatcher d(r, o);
+
+  auto ok = d.handle(call("blob", 1000));
+  assert(ok->as_object_ptr()->get_string_or("result", "").size() == 1000);
+
+  auto big = d.handle(call("blob", 1 << 20));
+  assert(error_code(*big) == "RESOURCE_EXHAUSTED");
+
+  // Handler used its whole budget: any result is refused.
+  r.add("exact", [](const Context &ctx) -> RpcResult
+        {
+          std::pmr::vector<long long> v(ctx.memory());
+          v.reserve(4096 / sizeof(long long));
+          return token(std::string(1 << 20, 'x')); });
+  Dispatcher exact(r, o);
+  auto spent = exact.handle(obj({"id", 1, "method", "exact"}));
+  assert(error_code(*spent) == "RESOURCE_EXHAUSTED");
+
+  // Same through write().
+  std::string out;
+  const bool wrote = d.write(call("blob", 1 << 20), out);
+  assert(wrote);
+  assert(out.find("RESOURCE_EXHAUSTED") != std::string::npos);
+}
+
+static void test_method_budget_and_batches()
+{
+  Router r;
+  setup(r);
+
+  MethodOptions roomy;
+  roomy.memory_budget = 16 << 20;
+  r.add("fill.big", [](const Context &ctx) -> RpcResult
+        {
+          std::pmr::vector<long long> v(ctx.memory());
+          v.resize(1 << 16);
+          return token(static_cast<long long>(v.size())); },
+        roomy);
+
+  DispatcherOptions o;
+  o.limits.max_request_memory = 4096;
+  Dispatcher d(r, o);
+
+  auto ok = d.handle(obj({"id", 1, "method", "fill.big"}));
+  assert(ok->as_object_ptr()->get_i64_or("result", 0) == (1 << 16));
+
+  // One item over budget does not affect the others.
+  array_t items;
+  items.elems.push_back(call("fill", 10, 1));
+  items.elems.push_back(call("fill", 1 << 20, 2));
+  items.elems.push_back(call("blob", 10, 3));
+  auto out = d.handle(token(std::move(items)));
+  const auto arr = out->as_array_ptr();
+  assert(arr->elems.size() == 3);
+  assert(arr->elems[0].as_object_ptr()->get_i64_or("result", 0) == 10);
+  assert(error_code(arr->elems[1]) == "RESOURCE_EXHAUSTED");
+  assert(arr->elems[2].as_object_ptr()->get_string_or("result", "") == std::string(10, 'x'));
+}
+
+static void test_errors_outlive_the_budget()
+{
+  Router r;
+  setup(r);
+
+  DispatcherOptions o;
+  o.limits.max_request_memory = 4096;
+  Dispatcher d(r, o);
+
+  auto out = d.handle(obj({"id", 1, "method", "fail"}));
+  assert(error_code(*out) == "INVALID_PARAMS");
+  const auto details = out->as_object_ptr()->get_ptr("error")->as_object_ptr()->get_ptr("details");
+  assert(details->as_object_ptr()->get_string_or("reason", "") == std::string(64, 'e'));
+
+  std::string text;
+  const bool wrote = d.write(obj({"id", 1, "method", "fail"}), text);
+  assert(wrote);
+  assert(text.find(std::string(64, 'e')) != std::string::npos);
+}
+
+static void test_high_water_marks()
+{
+  Router r;
+  setup(r);
+
+  DispatcherOptions o;
+  o.track_memory = true;
+  Dispatcher d(r, o);
+
+  (void)d.handle(call("fill", 1000));
+  (void)d.handle(call("fill", 10));
+  (void)d.handle(call("blob", 5000));
+
+  std::size_t fill = 0, blob = 0;
+  for (const auto &[name, s] : d.memory_usage())
+  {
+    if (name == "fill")
+    {
+      assert(s.calls == 2);
+      assert(s.exhausted == 0);
+      fill = s.high_water;
+    }
+    if (name == "blob")
+      blob = s.high_water;
+  }
+  assert(fill >= 1000 * sizeof(long long));
+  assert(blob >= 5000);
+
+  // Untracked dispatcher: nothing measured.
+  Router r2;
+  setup(r2);
+  Dispatcher plain(r2);
+  (void)plain.handle(call("fill", 10));
+  assert(plain.memory_usage().empty());
+}
+
+int main()
+{
+  test_budget_resource();
+  test_allocations_over_budget();
+  test_result_over_budget();
+  test_method_budget_and_batches();
+  test_errors_outlive_the_budget();
+  test_high_water_marks();
+
+  std::cout << "[webrpc] memory_budget OK\n";
+  return 0;
+}
@@ -0,0 +1,230 @@
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "alloc_counter.hpp"
+
+#include <vix/webrpc/Context.hpp>
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Meta.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static void test_lookup()
+{
+  // Views into a transport buffer.
+  const std::string headers = "tenant: acme\r\ntrace-id: 4bf92f3577b34da6\r\nx-request-source: mobile-app\r\n";
+  const std::string_view buf = headers;
+
+  const AllocScope heap;
+
+  MetaView meta;
+  meta.add(buf.substr(0, 6), buf.substr(8, 4));
+  meta.add(buf.substr(14, 8), buf.substr(24, 16));
+  meta.add("x-request-source", "mobile-app");
+  meta.add("tenant", "shadowed");
+
+  assert(meta.size() == 4);
+  assert(!meta.spilled());
+  assert(meta.get("tenant") == "acme");
+  assert(meta.get(MetaKey::tenant) == "acme");
+  assert(meta.get(MetaKey::trace_id) == "4bf92f3577b34da6");
+  assert(meta.get("x-request-source") == "mobile-app");
+  assert(!meta.contains(MetaKey::authorization));
+  assert(!meta.contains("x-missing"));
+  assert(meta.get("x-missing").empty());
+
+  const Context ctx("m", token(nullptr), token(nullptr), "http", &meta);
+  assert(ctx.meta_value("tenant") == "acme");
+  assert(ctx.meta_value(MetaKey::trace_id) == "4bf92f3577b34da6");
+  assert(ctx.has_meta(MetaKey::tenant));
+  assert(!ctx.has_meta("authorization"));
+
+  const Context bare("m", token(nullptr), token(nullptr));
+  assert(bare.meta_value(MetaKey::tenant).empty());
+  assert(!bare.has_meta("tenant"));
+
+  assert(heap.count().calls == 0);
+}
+
+static void test_capacity_and_clear()
+{
+  static const char *keys[] = {"k0", "k1", "k2", "k3", "k4", "k5", "k6", "k7",
+                               "k8", "k9", "k10", "k11", "k12", "k13", "k14", "k15"};
+
+  const AllocScope heap;
+
+  MetaView meta;
+  for (const char *k : keys)
+    meta.add(k, "v");
+  assert(meta.size() == MetaView::capacity);
+  assert(!meta.spilled());
+  assert(heap.count().calls == 0);
+
+  std::size_t n = 0;
+  for (const auto &[k, v] : meta)
+  {
+    assert(v == "v");
+    ++n;
+  }
+  assert(n == MetaView::capacity);
+
+  meta.clear();
+  assert(meta.empty());
+  meta.add("deadline", "100");
+  assert(meta.get(MetaKey::deadline) == "100");
+}
+
+static void test_more_than_capacity()
+{
+  // A transport with many headers: nothing past the inline capacity is dropped.
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  for (int i = 0; i < 40; ++i)
+  {
+    keys.push_back("x-header-" + std::to_string(i));
+    values.push_back("value-" + std::to_string(i));
+  }
+
+  MetaView meta;
+  meta.add("tenant", "acme");
+  for (std::size_t i = 0; i < keys.size(); ++i)
+  {
+    meta.add(keys[i], values[i]);
+    if (i == 20)
+    {
+      meta.add("trace-id", "4bf92f3577b34da6");
+      meta.add("tenant", "shadowed");
+    }
+  }
+
+  assert(meta.spilled());
+  assert(meta.size() == keys.size() + 3);
+  assert(meta.get(MetaKey::tenant) == "acme");
+  assert(meta.get("tenant") == "acme");
+  assert(meta.get(MetaKey::trace_id) == "4bf92f3577b34da6");
+  assert(meta.get("trace-id") == "4bf92f3577b34da6");
+  for (std::size_t i = 0; i < keys.size(); ++i)
+    assert(meta.get(keys[i]) == values[i]);
+
+  std::size_t n = 0;
+  for (const auto &entry : meta)
+  {
+    (void)entry;
+    ++n;
+  }
+  assert(n == meta.size());
+
+  // Copies own their storage.
+  const MetaView copy = meta;
+  assert(copy.get(keys.back()) == values.back());
+  assert(copy.get(MetaKey::trace_id) == "4bf92f3577b34da6");
+
+  // The dispatcher sees every entry.
+  Router r;
+  std::string seen;
+  r.add("last", [&](const Context &ctx) -> RpcResult
+        {
+          seen = std::string(ctx.meta_value("x-header-39")) + "/" +
+                 std::string(ctx.meta_value(MetaKey::trace_id));
+          return token(true); });
+
+  Dispatcher d(r);
+  auto out = d.handle(obj({"id", 1, "method", "last"}), "http", &meta);
+  assert(out.has_value());
+  assert(seen == "value-39/4bf92f3577b34da6");
+
+  meta.clear();
+  assert(meta.empty() && !meta.spilled());
+  assert(!meta.contains(MetaKey::trace_id));
+}
+
+static void test_from_map_and_initializer()
+{
+  const std::map<std::string, std::string> headers{{"authorization", "Bearer t"}, {"tenant", "t1"}};
+  const MetaView meta = MetaView::of(headers);
+  assert(meta.get(MetaKey::authorization) == "Bearer t");
+  assert(meta.get(MetaKey::tenant) == "t1");
+
+  const MetaView listed{{"tenant", "t2"}, {"priority", "bulk"}};
+  assert(listed.get(MetaKey::tenant) == "t2");
+  assert(listed.get("priority") == "bulk");
+}
+
+static void test_meta_map()
+{
+  // The owning map keeps working, directly and through the router/dispatcher.
+  const Context::MetaMap legacy{{"tenant", "t2"}, {"priority", "bulk"}};
+
+  const Context ctx("m", token(nullptr), token(nullptr), "http", &legacy);
+  assert(ctx.meta == &legacy);
+  assert(ctx.meta_view == nullptr);
+  assert(ctx.meta_value("tenant") == "t2");
+  assert(ctx.meta_value(MetaKey::tenant) == "t2");
+  assert(ctx.has_meta("priority"));
+  assert(ctx.has_meta(MetaKey::tenant));
+  assert(!ctx.has_meta(MetaKey::trace_id));
+  assert(ctx.meta_value("x-missing").empty());
+
+  const Context none("m", token(nullptr), token(nullptr), "http", nullptr);
+  assert(!none.has_meta("tenant"));
+
+  Router r;
+  std::string tenant;
+  r.add("whoami", [&](const Context &c) -> RpcResult
+        {
+          tenant = std::string(c.meta_value(MetaKey::tenant));
+          return token(true); });
+
+  auto res = r.dispatch(obj({"id", 1, "method", "whoami"}), "http", &legacy);
+  assert(std::holds_alternative<token>(res));
+  assert(tenant == "t2");
+
+  tenant.clear();
+  Dispatcher d(r);
+  auto out = d.handle(obj({"id", 2, "method", "whoami"}), "http", &legacy);
+  assert(out.has_value());
+  assert(tenant == "t2");
+
+  tenant.clear();
+  auto one = d.handle_one(obj({"id", 3, "method", "whoami"}), "http", &legacy);
+  assert(one.has_value());
+  assert(tenant == "t2");
+}
+
+static void test_dispatcher_reads_meta()
+{
+  Router r;
+  std::string tenant;
+  r.add("whoami", [&](const Context &ctx) -> RpcResult
+        {
+          tenant = std::string(ctx.meta_value(MetaKey::tenant));
+          return token(true); });
+
+  Dispatcher d(r);
+  const MetaView meta{{"tenant", "acme"}};
+  auto out = d.handle(obj({"id", 1, "method", "whoami"}), "http", &meta);
+  assert(out.has_value());
+  assert(tenant == "acme");
+}
+
+int main()
+{
+  test_lookup();
+  test_capacity_and_clear();
+  test_more_than_capacity();
+  test_from_map_and_initializer();
+  test_meta_map();
+  test_dispatcher_reads_meta();
+
+  std::cout << "[webrpc] meta_view OK\n";
+  return 0;
+}
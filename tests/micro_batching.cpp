@@ -0,0 +1,145 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static token call(long long id, long long key)
+{
+  return obj({
+      "id",
+      id,
+      "method",
+      "item.lookup",
+      "params",
+      obj({"key", key}),
+  });
+}
+
+struct Backend
+{
+  std::atomic<int> invocations{0};
+  std::atomic<int> items{0};
+};
+
+static void register_lookup(Router &r, Backend &b, MicroBatchOptions mb)
+{
+  MethodOptions opts;
+  opts.micro_batch = mb;
+
+  r.add_batch("item.lookup", [&](std::span<const Context> calls, std::span<RpcResult> results)
+              {
+                b.invocations.fetch_add(1);
+                b.items.fetch_add(static_cast<int>(calls.size()));
+
+                // One storage round trip, whatever the number of keys.
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+                for (std::size_t i = 0; i < calls.size(); ++i)
+                  results[i] = token(calls[i].params.as_object_ptr()->get_i64_or("key", 0) * 10); },
+              opts);
+}
+
+static void test_concurrent_calls_are_gathered()
+{
+  constexpr int threads_count = 16;
+  constexpr int calls_per_thread = 20;
+
+  Router r;
+  Backend b;
+  register_lookup(r, b, MicroBatchOptions{.enabled = true, .max_batch = 64});
+
+  Dispatcher d(r);
+
+  std::atomic<int> wrong{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < threads_count; ++t)
+  {
+    threads.emplace_back([&, t]
+                         {
+                           for (int i = 0; i < calls_per_thread; ++i)
+                           {
+                             const long long id = t * 1000 + i;
+                             auto out = d.handle_one(call(id, id));
+                             if (!out || out->has_error() || out->id.as_i64_or(-1) != id ||
+                                 out->result().as_i64_or(0) != id * 10)
+                               wrong.fetch_add(1);
+                           } });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  constexpr int total = threads_count * calls_per_thread;
+  assert(wrong.load() == 0);
+  assert(b.items.load() == total);
+
+  // Callers queue behind the running batch and are served together.
+  assert(b.invocations.load() < total / 2);
+
+  const auto stats = d.micro_batches();
+  assert(stats.size() == 1);
+  assert(stats[0].second.calls == total);
+  assert(stats[0].second.batches == static_cast<std::uint64_t>(b.invocations.load()));
+  assert(stats[0].second.largest_batch > 1);
+  assert(stats[0].second.largest_batch <= 64);
+}
+
+static void test_idle_calls_run_immediately()
+{
+  Router r;
+  Backend b;
+  register_lookup(r, b, MicroBatchOptions{.enabled = true, .max_delay = std::chrono::microseconds(200)});
+
+  Dispatcher d(r);
+
+  for (long long i = 0; i < 10; ++i)
+  {
+    auto out = d.handle_one(call(i, i));
+    assert(out && out->result().as_i64_or(0) == i * 10);
+  }
+
+  // Sequential calls never wait for company: one batch each, no window.
+  assert(b.invocations.load() == 10);
+  const MicroBatchStats s = d.micro_batches()[0].second;
+  assert(s.largest_batch == 1);
+  assert(s.window_us == 0);
+}
+
+static void test_max_batch_is_respected()
+{
+  constexpr int callers = 12;
+
+  Router r;
+  Backend b;
+  register_lookup(r, b, MicroBatchOptions{.enabled = true, .max_batch = 4});
+
+  Dispatcher d(r);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < callers; ++t)
+    threads.emplace_back([&, t]
+                         { d.handle_one(call(t, t)); });
+  for (auto &t : threads)
+    t.join();
+
+  assert(b.items.load() == callers);
+  assert(d.micro_batches()[0].second.largest_batch <= 4);
+}
+
+int main()
+{
+  test_concurrent_calls_are_gathered();
+  test_idle_calls_run_immediately();
+  test_max_batch_is_respected();
+
+  std::cout << "[webrpc] micro_batching OK\n";
+  return 0;
+}
@@ -0,0 +1,181 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+
+#include <vix/webrpc/Hash.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static void test_reordered_objects_hash_the_same()
+{
+  const token a = obj({"user", "ada", "limit", 10, "active", true});
+  const token b = obj({"active", true, "user", "ada", "limit", 10});
+
+  assert(params_hash(a) == params_hash(b));
+  assert(equal(a, b));
+  assert(equal(b, a));
+}
+
+static void test_nested_reorder()
+{
+  const token a = obj({
+      "filter",
+      obj({"tag", "x", "since", 1700000000}),
+      "page",
+      obj({"size", 50, "cursor", nullptr}),
+      "ids",
+      array({1, 2, 3}),
+  });
+  const token b = obj({
+      "ids",
+      array({1, 2, 3}),
+      "page",
+      obj({"cursor", nullptr, "size", 50}),
+      "filter",
+      obj({"since", 1700000000, "tag", "x"}),
+  });
+
+  assert(params_hash(a) == params_hash(b));
+  assert(equal(a, b));
+}
+
+static void test_arrays_keep_order()
+{
+  const token a = array({1, 2, 3});
+  const token b = array({3, 2, 1});
+
+  assert(params_hash(a) != params_hash(b));
+  assert(!equal(a, b));
+}
+
+static void test_types_are_distinct()
+{
+  const token values[] = {
+      token(nullptr),
+      token(true),
+      token(false),
+      token(1),
+      token(1.0),
+      token("1"),
+      token(""),
+      array({1}),
+      array({}),
+      obj({}),
+      obj({"1", 1}),
+  };
+
+  std::set<std::uint64_t> hashes;
+  for (const token &v : values)
+    hashes.insert(params_hash(v));
+  assert(hashes.size() == std::size(values));
+
+  for (std::size_t i = 0; i < std::size(values); ++i)
+  {
+    for (std::size_t j = 0; j < std::size(values); ++j)
+      assert(equal(values[i], values[j]) == (i == j));
+  }
+}
+
+static void test_strings_across_block_sizes()
+{
+  // Lengths around the 8- and 32-byte steps of the string hash.
+  std::set<std::uint64_t> hashes;
+  for (std::size_t n = 0; n <= 80; ++n)
+  {
+    const std::string s(n, 'a');
+    const std::uint64_t h = params_hash(token(s));
+    assert(h == params_hash(token(std::string(n, 'a'))));
+    hashes.insert(h);
+  }
+  assert(hashes.size() == 81);
+
+  // A single differing byte anywhere changes the hash.
+  const std::string base(40, 'q');
+  for (std::size_t i = 0; i < base.size(); ++i)
+  {
+    std::string other = base;
+    other[i] = 'r';
+    assert(params_hash(token(other)) != params_hash(token(base)));
+    assert(!equal(token(other), token(base)));
+  }
+}
+
+static void test_numbers()
+{
+  assert(params_hash(token(0.0)) == params_hash(token(-0.0)));
+  assert(equal(token(0.0), token(-0.0)));
+
+  assert(params_hash(token(42)) != params_hash(token(43)));
+  assert(params_hash(token(-1)) != params_hash(token(1)));
+}
+
+static void test_unequal_objects()
+{
+  const token base = obj({"a", 1, "b", 2});
+
+  assert(!equal(base, obj({"a", 1})));              // size
+  assert(!equal(base, obj({"a", 1, "c", 2})));      // key
+  assert(!equal(base, obj({"b", 2, "a", "1"})));    // value type
+  assert(!equal(base, obj({"a", 1, "b", 3})));      // value
+
+  // Swapping values between keys must not collide with the original.
+  assert(params_hash(obj({"a", 1, "b", 2})) != params_hash(obj({"a", 2, "b", 1})));
+}
+
+static void test_portable_multiply()
+{
+  std::uint64_t hi = 0;
+
+  // (2^64 - 1)^2 = 2^128 - 2^65 + 1
+  assert(detail::mul128_portable(~0ULL, ~0ULL, hi) == 1);
+  assert(hi == 0xfffffffffffffffeULL);
+
+  assert(detail::mul128_portable(1ULL << 32, 1ULL << 32, hi) == 0);
+  assert(hi == 1);
+
+  assert(detail::mul128_portable(0xffffffffULL, 0xffffffffULL, hi) == 0xfffffffe00000001ULL);
+  assert(hi == 0);
+
+#if defined(__SIZEOF_INT128__)
+  __extension__ using u128 = unsigned __int128;
+  std::uint64_t x = 0x9e3779b97f4a7c15ULL;
+  for (int i = 0; i < 10000; ++i)
+  {
+    const std::uint64_t a = detail::mix(x += 0x9e3779b97f4a7c15ULL);
+    const std::uint64_t b = detail::mix(x += 0x9e3779b97f4a7c15ULL) >> (i % 64);
+    const u128 r = static_cast<u128>(a) * b;
+
+    assert(detail::mul128_portable(a, b, hi) == static_cast<std::uint64_t>(r));
+    assert(hi == static_cast<std::uint64_t>(r >> 64));
+    assert(detail::mum(a, b) == (static_cast<std::uint64_t>(r) ^ hi));
+  }
+#endif
+}
+
+static void test_call_hash_includes_method()
+{
+  const token p = obj({"id", 7});
+  assert(call_hash("user.get", p) == call_hash("user.get", obj({"id", 7})));
+  assert(call_hash("user.get", p) != call_hash("user.del", p));
+}
+
+int main()
+{
+  test_reordered_objects_hash_the_same();
+  test_nested_reorder();
+  test_arrays_keep_order();
+  test_types_are_distinct();
+  test_strings_across_block_sizes();
+  test_numbers();
+  test_unequal_objects();
+  test_portable_multiply();
+  test_call_hash_includes_method();
+
+  std::cout << "[webrpc] params_hash OK\n";
+  return 0;
+}
@@ -0,0 +1,279 @@
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/webrpc/Scheduler.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+using namespace std::chrono_literals;
+
+// Occupies the single worker until opened, so tasks pile up in the queues.
+struct Gate
+{
+  std::promise<void> held;
+  std::promise<void> opened;
+  std::shared_future<void> wait = opened.get_future().share();
+
+  /// Task body: tell the test the worker is taken, then block until opened.
+  void hold()
+  {
+    held.set_value();
+    wait.wait();
+  }
+};
+
+static void test_strict_order()
+{
+  SchedulerOptions o;
+  o.workers = 1;
+  o.policy = SchedulingPolicy::strict;
+  o.aging = 0ms;
+
+  std::vector<std::string> order;
+  Gate gate;
+
+  {
+    std::future<void> held = gate.held.get_future();
+    Scheduler s(o);
+    s.submit(Priority::normal, [&]
+             { gate.hold(); });
+    held.wait();
+
+    s.submit(Priority::bulk, [&]
+             { order.push_back("bulk"); });
+    s.submit(Priority::normal, [&]
+             { order.push_back("normal"); });
+    s.submit(Priority::interactive, [&]
+             { order.push_back("interactive"); });
+
+    gate.opened.set_value();
+  } // drains and joins
+
+  assert((order == std::vector<std::string>{"interactive", "normal", "bulk"}));
+}
+
+static void test_aging_prevents_starvation()
+{
+  SchedulerOptions o;
+  o.workers = 1;
+  o.policy = SchedulingPolicy::strict;
+  o.aging = 20ms;
+
+  std::vector<std::string> order;
+  Gate gate;
+
+  std::future<void> held = gate.held.get_future();
+  std::promise<void> done;
+
+  Scheduler s(o);
+  s.submit(Priority::normal, [&]
+           { gate.hold(); });
+  held.wait();
+
+  // The worker is held: only the bulk task's age matters, and sleeping is a lower bound.
+  s.submit(Priority::bulk, [&]
+           { order.push_back("bulk"); });
+  std::this_thread::sleep_for(o.aging + 1ms);
+  s.submit(Priority::interactive, [&]
+           {
+             order.push_back("interactive");
+             done.set_value(); });
+
+  gate.opened.set_value();
+  done.get_future().wait();
+
+  assert((order == std::vector<std::string>{"bulk", "interactive"}));
+  assert(s.stats(Priority::bulk).aged == 1);
+}
+
+static void test_post_batch_keeps_order()
+{
+  Router r;
+
+  MethodOptions ui;
+  ui.priority = Priority::interactive;
+  r.add("ui.click", [](const Context &ctx) -> RpcResult
+        { return ctx.params; }, ui);
+
+  MethodOptions bulk;
+  bulk.priority = Priority::bulk;
+  r.add("export.run", [](const Context &ctx) -> RpcResult
+        { return ctx.params; }, bulk);
+
+  Dispatcher d(r);
+
+  SchedulerOptions o;
+  o.workers = 2;
+  Scheduler s(o);
+
+  token batch = array({
+      obj({"id", 1LL, "method", "export.run", "params", 10LL}),
+      obj({"method", "ui.click", "params", 0LL}), // notification
+      obj({"id", 2LL, "method", "ui.click", "params", 20LL}),
+      obj({"id", 3LL, "method", "missing"}),
+  });
+
+  std::promise<std::optional<token>> p;
+  d.post(s, batch, [&](std::optional<token> out)
+         { p.set_value(std::move(out)); });
+
+  const auto out = p.get_future().get();
+  assert(out.has_value());
+
+  const auto arr = out->as_array_ptr();
+  assert(arr && arr->elems.size() == 3);
+
+  assert(arr->elems[0].as_object_ptr()->get_i64_or("id", 0) == 1);
+  assert(arr->elems[0].as_object_ptr()->get_i64_or("result", 0) == 10);
+  assert(arr->elems[1].as_object_ptr()->get_i64_or("id", 0) == 2);
+  assert(arr->elems[2].as_object_ptr()->get_i64_or("id", 0) == 3);
+  assert(arr->elems[2].as_object_ptr()->get_ptr("error") != nullptr);
+
+  assert(s.stats(Priority::interactive).submitted == 2);
+  assert(s.stats(Priority::bulk).submitted == 1);
+  assert(s.stats(Priority::normal).submitted == 1);
+}
+
+static void test_throwing_tasks_keep_workers_alive()
+{
+  SchedulerOptions o;
+  o.workers = 1;
+  Scheduler s(o);
+
+  std::promise<void> after;
+  const SubmitStatus thrower = s.submit(Priority::normal, []
+                                        { throw std::runtime_error("boom"); });
+  const SubmitStatus next = s.submit(Priority::normal, [&]
+                                     { after.set_value(); });
+  assert(thrower == SubmitStatus::accepted);
+  assert(next == SubmitStatus::accepted);
+
+  after.get_future().wait();
+  assert(s.stats(Priority::normal).failed == 1);
+
+  Router r;
+  r.add("boom", [](const Context &) -> RpcResult
+        { throw std::runtime_error("boom"); });
+  r.add("ok", [](const Context &) -> RpcResult
+        { return token(true); });
+  Dispatcher d(r);
+
+  std::promise<std::optional<token>> single;
+  d.post(s, obj({"id", 1LL, "method", "boom"}), [&](std::optional<token> out)
+         { single.set_value(std::move(out)); });
+
+  const auto one = single.get_future().get();
+  assert(one.has_value());
+  assert(one->as_object_ptr()->get_i64_or("id", 0) == 1);
+  const token *err = one->as_object_ptr()->get_ptr("error");
+  assert(err && err->as_object_ptr()->get_string_or("code", "") == "INTERNAL_ERROR");
+
+  std::promise<std::optional<token>> batch;
+  d.post(s, array({obj({"id", 1LL, "method", "boom"}), obj({"id", 2LL, "method", "ok"})}),
+         [&](std::optional<token> out)
+         { batch.set_value(std::move(out)); });
+
+  const auto many = batch.get_future().get();
+  assert(many.has_value());
+  const auto arr = many->as_array_ptr();
+  assert(arr && arr->elems.size() == 2);
+  assert(arr->elems[0].as_object_ptr()->get_ptr("error") != nullptr);
+  assert(arr->elems[1].as_object_ptr()->get_ptr("result") != nullptr);
+}
+
+static void test_meta_priority_override()
+{
+  Router r;
+  r.add("job", [](const Context &) -> RpcResult
+        { return token(true); });
+
+  DispatcherOptions opts;
+  opts.priority_meta_key = "priority";
+  Dispatcher d(r, opts);
+
+  const MetaView meta{{"priority", "bulk"}};
+  const token call = obj({"id", 1LL, "method", "job"});
+
+  assert(d.priority_of(call, nullptr) == Priority::normal);
+  assert(d.priority_of(call, &meta) == Priority::bulk);
+}
+
+// A bulk backlog older than `aging` must not hold back an interactive call: aged
+// picks are capped, so the interactive call runs right after the first aged one.
+// Queueing delay under real bulk saturation is measured by bench/priority_delay.cpp.
+static void test_interactive_not_behind_aged_backlog()
+{
+  std::vector<std::string> order;
+
+  Router r;
+
+  MethodOptions ui;
+  ui.priority = Priority::interactive;
+  r.add("ui.get", [&](const Context &) -> RpcResult
+        {
+          order.push_back("ui");
+          return token(true); }, ui);
+
+  MethodOptions bulk;
+  bulk.priority = Priority::bulk;
+  r.add("export.chunk", [&](const Context &) -> RpcResult
+        {
+          order.push_back("bulk");
+          return token(true); }, bulk);
+
+  Dispatcher d(r);
+
+  SchedulerOptions o;
+  o.workers = 1;
+  o.policy = SchedulingPolicy::strict;
+  o.aging = 20ms;
+  o.aging_interval = 4;
+
+  const token bulk_call = obj({"id", 1LL, "method", "export.chunk"});
+  const token ui_call = obj({"id", 2LL, "method", "ui.get"});
+  auto ignore = [](std::optional<token>) {};
+
+  Gate gate;
+  {
+    std::future<void> held = gate.held.get_future();
+    Scheduler s(o);
+    s.submit(Priority::normal, [&]
+             { gate.hold(); });
+    held.wait();
+
+    for (int i = 0; i < 8; ++i)
+      d.post(s, bulk_call, ignore);
+
+    // The worker is held: sleeping only makes the bulk backlog older than `aging`.
+    std::this_thread::sleep_for(o.aging + 1ms);
+    d.post(s, ui_call, ignore);
+
+    gate.opened.set_value();
+  } // drains and joins
+
+  const std::vector<std::string> expected{"bulk", "ui", "bulk", "bulk", "bulk",
+                                          "bulk", "bulk", "bulk", "bulk"};
+  assert(order == expected);
+}
+
+int main()
+{
+  test_strict_order();
+  test_aging_prevents_starvation();
+  test_post_batch_keeps_order();
+  test_throwing_tasks_keep_workers_alive();
+  test_meta_priority_override();
+  test_interactive_not_behind_aged_backlog();
+
+  std::cout << "[webrpc] priority_scheduler OK\n";
+  return 0;
+}
@@ -0,0 +1,157 @@
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <memory_resource>
+#include <set>
+#include <vector>
+
+#include <vix/webrpc/Arena.hpp>
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+/// Upstream resource that counts what it hands out and gets back.
+struct CountingResource final : std::pmr::memory_resource
+{
+  std::size_t allocations{0};
+  std::size_t deallocations{0};
+  std::size_t bytes{0};
+
+  void *do_allocate(std::size_t n, std::size_t align) override
+  {
+    ++allocations;
+    bytes += n;
+    return std::pmr::new_delete_resource()->allocate(n, align);
+  }
+
+  void do_deallocate(void *p, std::size_t n, std::size_t align) override
+  {
+    ++deallocations;
+    std::pmr::new_delete_resource()->deallocate(p, n, align);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &o) const noexcept override
+  {
+    return this == &o;
+  }
+};
+
+static token call(const char *method, long long id, long long n = 4)
+{
+  return obj({"id", id, "method", method, "params", obj({"n", n})});
+}
+
+static void test_arena_basics()
+{
+  CountingResource up;
+  {
+    RequestArena arena(&up);
+    std::pmr::vector<int> small(&arena);
+    small.resize(64);
+    assert(up.allocations == 0);
+    assert(arena.allocated() >= 64 * sizeof(int));
+
+    std::pmr::vector<char> big(&arena);
+    big.resize(RequestArena::inline_bytes * 4);
+    assert(up.allocations > 0);
+
+    arena.release();
+    assert(arena.allocated() == 0);
+    assert(up.deallocations == up.allocations);
+  }
+  assert(up.deallocations == up.allocations);
+}
+
+static void test_context_memory_defaults_to_heap()
+{
+  Router r;
+  std::pmr::memory_resource *seen = nullptr;
+  bool had_arena = true;
+  r.add("probe", [&](const Context &ctx) -> RpcResult
+        {
+          had_arena = ctx.arena != nullptr;
+          seen = ctx.memory();
+          return token(true); });
+
+  Dispatcher d(r);
+  auto out = d.handle(call("probe", 1));
+  assert(out.has_value());
+  assert(!had_arena);
+  assert(seen == std::pmr::get_default_resource());
+}
+
+static void test_handler_temporaries_use_the_arena()
+{
+  CountingResource up;
+  Router r;
+  r.add("sum", [](const Context &ctx) -> RpcResult
+        {
+          assert(ctx.arena != nullptr);
+          const long long n = ctx.params.as_object_ptr()->get_i64_or("n", 0);
+
+          std::pmr::vector<long long> tmp(ctx.memory());
+          for (long long i = 0; i < n; ++i)
+            tmp.push_back(i);
+
+          long long s = 0;
+          for (long long v : tmp)
+            s += v;
+          return token(s); });
+
+  DispatcherOptions o;
+  o.request_arena = true;
+  o.arena_upstream = &up;
+  Dispatcher d(r, o);
+
+  // Small temporaries fit in the inline buffer: upstream is never asked.
+  auto small = d.handle(call("sum", 1, 16));
+  assert(small->as_object_ptr()->get_i64_or("result", -1) == 120);
+  assert(up.allocations == 0);
+
+  // Larger ones spill upstream and are all given back with the response.
+  auto big = d.handle(call("sum", 2, 10000));
+  assert(big->as_object_ptr()->get_i64_or("result", -1) == 49995000);
+  assert(up.allocations > 0);
+  assert(up.deallocations == up.allocations);
+}
+
+static void test_sync_batch_shares_one_arena()
+{
+  Router r;
+  std::set<std::pmr::memory_resource *> arenas;
+  r.add("probe", [&](const Context &ctx) -> RpcResult
+        {
+          arenas.insert(ctx.arena);
+          return token(true); });
+
+  r.add_batch("vec", [&](std::span<const Context> calls, std::span<RpcResult> results)
+              {
+                for (std::size_t i = 0; i < calls.size(); ++i)
+                {
+                  arenas.insert(calls[i].arena);
+                  results[i] = token(true);
+                } });
+
+  DispatcherOptions o;
+  o.request_arena = true;
+  Dispatcher d(r, o);
+
+  auto out = d.handle(array({call("probe", 1), call("vec", 2), call("probe", 3), call("vec", 4)}));
+  assert(out.has_value() && out->as_array_ptr()->elems.size() == 4);
+  assert(arenas.size() == 1);
+  assert(*arenas.begin() != nullptr);
+}
+
+int main()
+{
+  test_arena_basics();
+  test_context_memory_defaults_to_heap();
+  test_handler_temporaries_use_the_arena();
+  test_sync_batch_shares_one_arena();
+
+  std::cout << "[webrpc] request_arena OK\n";
+  return 0;
+}
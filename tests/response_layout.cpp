@@ -0,0 +1,92 @@
+#include <cassert>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <vix/webrpc/Error.hpp>
+#include <vix/webrpc/Response.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static std::string text_of(const RpcResponse &r)
+{
+  std::string out;
+  r.write_json(out);
+  return out;
+}
+
+static void test_size_target()
+{
+  static_assert(sizeof(RpcResponse) <= 2 * sizeof(token) + 2 * sizeof(void *));
+  static_assert(sizeof(RpcResponse) < sizeof(RpcError));
+  static_assert(sizeof(pmr::RpcResponse) < sizeof(pmr::RpcError));
+}
+
+static void test_ok_and_fail_unchanged()
+{
+  const RpcResponse ok = RpcResponse::ok(token(1), obj({"v", 2}));
+  assert(ok.ok() && !ok.has_error());
+  assert(ok.result().as_object_ptr()->get_i64_or("v", 0) == 2);
+  assert(!ok.error().valid());
+  assert(text_of(ok) == R"({"id":1,"result":{"v":2}})");
+
+  const RpcResponse failed = RpcResponse::fail(token("a"), RpcError::method_not_found("x"));
+  assert(!failed.ok() && failed.has_error());
+  assert(failed.result().is_null());
+  assert(failed.error().code == "METHOD_NOT_FOUND");
+
+  const token j = failed.to_json();
+  assert(j.as_object_ptr()->get_ptr("result") == nullptr);
+  assert(j.as_object_ptr()->get_ptr("error")->as_object_ptr()->get_string_or("code", "") == "METHOD_NOT_FOUND");
+}
+
+static void test_copy_and_move()
+{
+  RpcResponse a = RpcResponse::fail(token(1), RpcError{"APP_ERROR", "a message longer than an inline buffer"});
+  RpcResponse b = a;
+  assert(b.has_error() && b.error().message == a.error().message);
+  assert(&b.error() != &a.error());
+
+  const RpcError *box = &a.error();
+  RpcResponse c = std::move(a);
+  assert(&c.error() == box);
+
+  // A moved-from response stays readable.
+  assert(!a.error().valid());
+
+  c = RpcResponse::ok(token(2), token(true));
+  assert(c.ok() && c.result().as_bool_or(false));
+
+  std::vector<RpcResponse> many(1000, b);
+  assert(many.back().error().code == "APP_ERROR");
+}
+
+static void test_error_lives_in_the_resource()
+{
+  std::pmr::monotonic_buffer_resource pool;
+  const pmr::RpcResponse::allocator_type alloc(&pool);
+
+  pmr::RpcResponse r = pmr::RpcResponse::fail(token(1), pmr::RpcError::internal_error("x"), alloc);
+  assert(r.get_allocator().resource() == &pool);
+  assert(r.error().get_allocator().resource() == &pool);
+
+  // Copy out of the resource (the response outlives it).
+  pmr::RpcResponse out(r, pmr::RpcResponse::allocator_type{});
+  assert(out.error().get_allocator().resource() == std::pmr::get_default_resource());
+  assert(out.error().message == "x");
+}
+
+int main()
+{
+  test_size_target();
+  test_ok_and_fail_unchanged();
+  test_copy_and_move();
+  test_error_lives_in_the_resource();
+
+  std::cout << "[webrpc] response_layout OK\n";
+  return 0;
+}
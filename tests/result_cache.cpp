@@ -0,0 +1,295 @@
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <vix/webrpc/Dispatcher.hpp>
+#include <vix/webrpc/ResultCache.hpp>
+#include <vix/webrpc/Router.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static token call(const char *method, long long id, token params)
+{
+  return obj({
+      "id",
+      id,
+      "method",
+      method,
+      "params",
+      std::move(params),
+  });
+}
+
+static DispatcherOptions with_cache(std::size_t bytes, std::size_t shards = 4)
+{
+  DispatcherOptions o;
+  o.cache.max_bytes = bytes;
+  o.cache.shards = shards;
+  return o;
+}
+
+static void test_hit_skips_handler()
+{
+  Router r;
+  int runs = 0;
+
+  MethodOptions opts;
+  opts.cache_ttl = std::chrono::minutes(1);
+
+  r.add("user.get", [&](const Context &ctx) -> RpcResult
+        {
+          ++runs;
+          return obj({"id", ctx.params.as_object_ptr()->get_i64_or("id", 0), "name", "ada"}); }, opts);
+
+  Dispatcher d(r, with_cache(1 << 20));
+  assert(d.cache() != nullptr);
+
+  auto a = d.handle_one(call("user.get", 1, obj({"id", 7, "fields", "all"})));
+  auto b = d.handle_one(call("user.get", 2, obj({"fields", "all", "id", 7})));
+
+  assert(runs == 1);
+  assert(a.has_value() && b.has_value());
+  assert(b->id.as_i64_or(0) == 2);
+  assert(b->result().as_object_ptr()->get_string_or("name", "") == "ada");
+
+  // The cache keeps its own copy: the filling call's result is not the stored one.
+  assert(equal(a->result(), b->result()));
+  assert(a->result().as_object_ptr() != b->result().as_object_ptr());
+
+  // Hits return the stored tree, not a rebuilt one.
+  auto c = d.handle_one(call("user.get", 5, obj({"id", 7, "fields", "all"})));
+  assert(c->result().as_object_ptr() == b->result().as_object_ptr());
+
+  // write() appends the stored bytes of a hit.
+  std::string out;
+  const bool wrote = d.write(call("user.get", 4, obj({"id", 7, "fields", "all"})), out);
+  assert(wrote);
+  assert(runs == 1);
+  assert(out == R"({"id":4,"result":{"id":7,"name":"ada"}})");
+
+  d.handle_one(call("user.get", 3, obj({"id", 8, "fields", "all"})));
+  assert(runs == 2);
+
+  const ResultCacheStats s = d.cache()->stats();
+  assert(s.hits == 3);
+  assert(s.misses == 2);
+  assert(s.inserts == 2);
+  assert(s.entries == 2);
+  assert(s.bytes > 0);
+}
+
+static void test_hit_round_trips_values()
+{
+  ResultCache cache(ResultCacheOptions{.max_bytes = 1 << 16, .shards = 1});
+
+  const token params = obj({"q", "all"});
+  const token result = obj({
+      "text",
+      "line\n\"quoted\" \\ tab\t \x01 caf\xc3\xa9",
+      "list",
+      array({1LL, -2LL, 2.5, token(nullptr), true, false}),
+      "nested",
+      obj({"empty", token(array_t{}), "none", obj({})}),
+  });
+
+  cache.put(call_hash("q", params), "q", params, result, std::chrono::minutes(1));
+
+  const auto hit = cache.get(call_hash("q", params), "q", params);
+  assert(hit.has_value());
+  assert(equal(*hit, result));
+
+  std::string text;
+  const bool appended = cache.append(call_hash("q", params), "q", params, text);
+  assert(appended);
+
+  std::string expected;
+  detail::append_json(expected, result);
+  assert(text == expected);
+}
+
+// Integral, signed-zero and huge doubles must stay doubles on a hit.
+static void test_hit_keeps_number_types()
+{
+  Router r;
+  int runs = 0;
+
+  MethodOptions opts;
+  opts.cache_ttl = std::chrono::minutes(1);
+
+  r.add("stats.get", [&](const Context &) -> RpcResult
+        {
+          ++runs;
+          return array({2.0, -0.0, 1e15}); }, opts);
+
+  Dispatcher d(r, with_cache(1 << 20));
+
+  const auto miss = d.handle_one(call("stats.get", 1, obj({})));
+  const auto hit = d.handle_one(call("stats.get", 2, obj({})));
+  assert(runs == 1);
+  assert(miss.has_value() && hit.has_value());
+  assert(equal(miss->result(), hit->result()));
+
+  const auto elems = hit->result().as_array_ptr();
+  assert(elems && elems->elems.size() == 3);
+  assert(elems->elems[0].is_f64() && elems->elems[1].is_f64() && elems->elems[2].is_f64());
+  assert(elems->elems[0].as_f64_or(0.0) == 2.0);
+  assert(std::signbit(elems->elems[1].as_f64_or(0.0)));
+  assert(elems->elems[2].as_f64_or(0.0) == 1e15);
+
+  // The write path answers a hit with the same text as a miss.
+  std::string miss_text;
+  std::string hit_text;
+  Dispatcher fresh(r, with_cache(1 << 20));
+  const bool wrote_miss = fresh.write(call("stats.get", 3, obj({})), miss_text);
+  const bool wrote_hit = fresh.write(call("stats.get", 3, obj({})), hit_text);
+  assert(wrote_miss && wrote_hit);
+  assert(runs == 2);
+  assert(miss_text == hit_text);
+}
+
+static void test_errors_and_uncached_methods_bypass_cache()
+{
+  Router r;
+  int plain_runs = 0;
+  int failing_runs = 0;
+
+  MethodOptions cached;
+  cached.cache_ttl = std::chrono::minutes(1);
+
+  r.add("plain", [&](const Context &) -> RpcResult
+        {
+          ++plain_runs;
+          return token(true); });
+
+  r.add("failing", [&](const Context &) -> RpcResult
+        {
+          ++failing_runs;
+          return RpcError{"NOT_FOUND", "missing"}; }, cached);
+
+  Dispatcher d(r, with_cache(1 << 20));
+
+  for (int i = 0; i < 3; ++i)
+  {
+    d.handle_one(call("plain", i, obj({"k", 1})));
+    d.handle_one(call("failing", i, obj({"k", 1})));
+  }
+
+  assert(plain_runs == 3);
+  assert(failing_runs == 3);
+  assert(d.cache()->stats().inserts == 0);
+
+  // No cache configured: nothing is allocated.
+  Dispatcher off(r);
+  assert(off.cache() == nullptr);
+}
+
+static void test_ttl_expiry()
+{
+  Router r;
+  int runs = 0;
+
+  MethodOptions opts;
+  opts.cache_ttl = std::chrono::milliseconds(20);
+
+  r.add("clock.tick", [&](const Context &) -> RpcResult
+        { return token(++runs); }, opts);
+
+  Dispatcher d(r, with_cache(1 << 20));
+
+  d.handle_one(call("clock.tick", 1, obj({})));
+  d.handle_one(call("clock.tick", 2, obj({})));
+  assert(runs == 1);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+
+  auto out = d.handle_one(call("clock.tick", 3, obj({})));
+  assert(runs == 2);
+  assert(out->result().as_i64_or(0) == 2);
+  assert(d.cache()->stats().expirations == 1);
+}
+
+static void test_byte_cap_evicts_lru()
+{
+  const std::string blob(512, 'x');
+
+  // Room for a handful of entries in a single shard.
+  ResultCache cache(ResultCacheOptions{.max_bytes = 4096, .shards = 1});
+  const auto ttl = std::chrono::minutes(1);
+
+  for (long long i = 0; i < 32; ++i)
+  {
+    const token params = obj({"n", i});
+    cache.put(call_hash("blob.get", params), "blob.get", params, token(blob), ttl);
+
+    // Keep entry 0 hot: it must survive while colder entries are evicted.
+    const token hot = obj({"n", 0});
+    const bool hot_hit = cache.get(call_hash("blob.get", hot), "blob.get", hot).has_value();
+    assert(hot_hit);
+  }
+
+  const ResultCacheStats s = cache.stats();
+  assert(s.bytes <= 4096);
+  assert(s.entries < 32);
+  assert(s.evictions == 32 - s.entries);
+
+  const token cold = obj({"n", 1});
+  const bool cold_hit = cache.get(call_hash("blob.get", cold), "blob.get", cold).has_value();
+  assert(!cold_hit);
+
+  // Too large for a shard: never stored.
+  const token big_params = obj({"n", 99});
+  cache.put(call_hash("blob.get", big_params), "blob.get", big_params,
+            token(std::string(8192, 'y')), ttl);
+  const bool big_hit = cache.get(call_hash("blob.get", big_params), "blob.get", big_params).has_value();
+  assert(!big_hit);
+  assert(cache.stats().rejected == 1);
+
+  cache.clear();
+  assert(cache.stats().entries == 0);
+  assert(cache.stats().bytes == 0);
+}
+
+static void test_small_cap_uses_fewer_shards()
+{
+  const auto ttl = std::chrono::minutes(1);
+
+  // 1000 bytes over 16 shards would leave 62 bytes per shard: nothing would fit.
+  ResultCache tiny(ResultCacheOptions{.max_bytes = 1000, .shards = 16});
+  assert(tiny.shards() == 1);
+  assert(tiny.shard_budget() == 1000);
+
+  const token params = obj({"n", 1});
+  tiny.put(call_hash("small.get", params), "small.get", params, token(1), ttl);
+  const bool small_hit = tiny.get(call_hash("small.get", params), "small.get", params).has_value();
+  assert(small_hit);
+  assert(tiny.stats().rejected == 0);
+
+  ResultCache mid(ResultCacheOptions{.max_bytes = 3 * ResultCache::min_shard_bytes, .shards = 16});
+  assert(mid.shards() == 3);
+  assert(mid.shard_budget() == ResultCache::min_shard_bytes);
+
+  ResultCache roomy(ResultCacheOptions{.max_bytes = 1 << 20, .shards = 16});
+  assert(roomy.shards() == 16);
+
+  ResultCache none(ResultCacheOptions{.max_bytes = 1 << 20, .shards = 0});
+  assert(none.shards() == 1);
+}
+
+int main()
+{
+  test_hit_skips_handler();
+  test_hit_round_trips_values();
+  test_hit_keeps_number_types();
+  test_errors_and_uncached_methods_bypass_cache();
+  test_ttl_expiry();
+  test_byte_cap_evicts_lru();
+  test_small_cap_uses_fewer_shards();
+
+  std::cout << "[webrpc] result_cache OK\n";
+  return 0;
+}
@@ -0,0 +1,211 @@
+#include <atomic>
+#include <cassert>
+#include <future>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <vix/webrpc/ShardedRuntime.hpp>
+#include <vix/json/Simple.hpp>
+
+using namespace vix::webrpc;
+using namespace vix::json;
+
+static token call(long long id, long long conn, long long seq)
+{
+  return obj({
+      "id",
+      id,
+      "method",
+      "record",
+      "params",
+      obj({"conn", conn, "seq", seq}),
+  });
+}
+
+static void test_connections_stay_on_one_shard_in_order()
+{
+  struct Seen
+  {
+    std::thread::id thread{};
+    long long last_seq{-1};
+  };
+
+  std::mutex mu;
+  std::map<long long, Seen> seen;
+  std::atomic<int> setups{0};
+  std::atomic<int> completed{0};
+
+  ShardedRuntimeOptions o;
+  o.shards = 4;
+  o.pin = false;
+  o.producers = 2;
+  o.queue_capacity = 64;
+
+  ShardedRuntime rt([&](Router &r)
+                    {
+                      ++setups;
+                      r.add("record", [&](const Context &ctx) -> RpcResult
+                            {
+                              const auto p = ctx.params.as_object_ptr();
+                              const long long conn = p->get_i64_or("conn", 0);
+                              const long long seq = p->get_i64_or("seq", 0);
+
+                              std::lock_guard<std::mutex> lock(mu);
+                              Seen &s = seen[conn];
+                              if (s.last_seq < 0)
+                                s.thread = std::this_thread::get_id();
+                              assert(s.thread == std::this_thread::get_id());
+                              assert(seq == s.last_seq + 1);
+                              s.last_seq = seq;
+                              return token(seq); }); },
+                    o);
+
+  assert(rt.shard_count() == 4);
+  assert(setups == 4);
+
+  constexpr long long per_producer = 2000;
+  auto produce = [&](std::size_t port, long long first_conn)
+  {
+    std::vector<long long> seq(8, 0);
+    for (long long i = 0; i < per_producer; ++i)
+    {
+      const long long c = i % 8;
+      const long long conn = first_conn + c;
+      token payload = call(i, conn, seq[c]++);
+      while (!rt.port(port).submit(static_cast<std::uint64_t>(conn), payload,
+                                   [&](std::optional<token> out)
+                                   {
+                                     assert(out.has_value());
+                                     ++completed;
+                                   }))
+        std::this_thread::yield();
+    }
+  };
+
+  std::thread a(produce, 0, 0);
+  std::thread b(produce, 1, 100);
+  a.join();
+  b.join();
+  rt.stop();
+
+  assert(completed == 2 * per_producer);
+  assert(seen.size() == 16);
+
+  std::uint64_t processed = 0;
+  for (std::size_t i = 0; i < rt.shard_count(); ++i)
+  {
+    processed += rt.stats(i).processed;
+    assert(rt.stats(i).cpu == -1);
+  }
+  assert(processed == 2 * per_producer);
+}
+
+static void test_full_queue_is_reported()
+{
+  std::promise<void> gate;
+  std::shared_future<void> open = gate.get_future().share();
+  std::atomic<int> completed{0};
+
+  ShardedRuntimeOptions o;
+  o.shards = 1;
+  o.pin = false;
+  o.queue_capacity = 2;
+
+  ShardedRuntime rt([&](Router &r)
+                    { r.add("record", [&](const Context &) -> RpcResult
+                            {
+                              open.wait();
+                              return token(true); }); },
+                    o);
+
+  int accepted = 0;
+  while (rt.port(0).submit(1, call(accepted, 1, 0), [&](std::optional<token>)
+                           { ++completed; }))
+  {
+    ++accepted;
+    assert(accepted < 100);
+  }
+
+  // One running (blocked), then the queue holds its capacity.
+  assert(accepted >= 2 && accepted <= 3);
+
+  gate.set_value();
+  rt.stop();
+  assert(completed == accepted);
+}
+
+static void test_shards_are_independent()
+{
+  ShardedRuntimeOptions o;
+  o.shards = 2;
+  o.pin = false;
+  o.dispatcher.cache.max_bytes = 1 << 16;
+
+  ShardedRuntime rt([](Router &r)
+                    {
+                      MethodOptions m;
+                      m.cache_ttl = std::chrono::minutes(1);
+                      r.add("record", [](const Context &) -> RpcResult
+                            { return token(1); }, m); },
+                    o);
+
+  // Each shard has its own dispatcher, router and cache.
+  assert(&rt.dispatcher(0) != &rt.dispatcher(1));
+  assert(rt.dispatcher(0).cache() != rt.dispatcher(1).cache());
+
+  // Find one connection per shard.
+  std::uint64_t conn[2] = {0, 0};
+  for (std::uint64_t c = 1, found = 0; found < 3; ++c)
+  {
+    const std::size_t s = rt.shard_of(c);
+    if (!(found & (1u << s)))
+    {
+      conn[s] = c;
+      found |= 1u << s;
+    }
+  }
+
+  std::atomic<int> completed{0};
+  for (int shard = 0; shard < 2; ++shard)
+  {
+    for (int k = 0; k < 3; ++k)
+      rt.port(0).submit(conn[shard], call(k, 0, 0), [&](std::optional<token>)
+                        { ++completed; });
+  }
+  rt.stop();
+
+  assert(completed == 6);
+  for (std::size_t s = 0; s < 2; ++s)
+  {
+    const ResultCacheStats cs = rt.dispatcher(s).cache()->stats();
+    assert(cs.misses == 1);
+    assert(cs.hits == 2);
+  }
+}
+
+static void test_pinning()
+{
+#if defined(__linux__)
+  ShardedRuntimeOptions o;
+  o.shards = 2;
+  o.cpus = {0};
+
+  ShardedRuntime rt([](Router &) {}, o);
+  assert(rt.stats(0).cpu == 0);
+  assert(rt.stats(1).cpu == 0);
+#endif
+}
+
+int main()
+{
+  test_connections_stay_on_one_shard_in_order();
+  test_full_queue_is_reported();
+  test_shards_are_independent();
+  test_pinning();
+
+  std::cout << "[webrpc] sharded_runtime OK\n";
+  return 0;
+}